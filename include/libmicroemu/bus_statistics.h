@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief Contains the access counters of the memory bus.
+ */
+#pragma once
+
+#include "libmicroemu/types.h"
+#include <array>
+
+namespace libmicroemu {
+
+/**
+ * @brief Selects a participant of the memory bus. The order matches the order of the bus.
+ */
+enum class BusRegion : u8 {
+  kFlash = 0U,          ///< Flash segment
+  kRam1 = 1U,           ///< RAM1 segment
+  kRam2 = 2U,           ///< RAM2 segment
+  kSysPeripherals = 3U, ///< Built-in peripherals of the system control space
+  kPlugins = 4U,        ///< Peripherals attached with Machine::AttachPeripheral
+  kBitBand = 5U,        ///< Bit-band alias regions
+  kSparse = 6U,         ///< Sparse memory backend
+};
+
+/// @brief Number of bus regions
+static constexpr u32 kNoOfBusRegions = 7U;
+
+/// @brief Number of access widths (byte, halfword, word)
+static constexpr u32 kNoOfAccessWidths = 3U;
+
+/**
+ * @brief Counters of one kind of access to a bus region.
+ */
+struct BusAccessCounters {
+  /// Number of accesses per width, indexed by 0 (byte), 1 (halfword) and 2 (word)
+  std::array<u64, kNoOfAccessWidths> accesses{};
+
+  /// Number of transferred bytes. Includes block copies, which are not counted as accesses.
+  u64 bytes{0U};
+
+  /**
+   * @brief Gets the number of accesses of all widths.
+   * @return Number of accesses
+   */
+  u64 GetAccesses() const noexcept { return accesses[0U] + accesses[1U] + accesses[2U]; }
+};
+
+/**
+ * @brief Counters of all accesses to a bus region.
+ */
+struct BusRegionStatistics {
+  BusAccessCounters fetches; ///< Instruction fetches
+  BusAccessCounters reads;   ///< Data reads
+  BusAccessCounters writes;  ///< Data writes
+};
+
+/**
+ * @brief Counters of all accesses which were resolved by the memory bus.
+ *
+ * An access is counted for the region which served it. Accesses to a bit-band alias are
+ * counted for the alias region and for the region of the backing word.
+ */
+struct BusStatistics {
+  std::array<BusRegionStatistics, kNoOfBusRegions> regions{};
+
+  /**
+   * @brief Gets the counters of a region.
+   * @param region The bus region
+   * @return The counters of the region
+   */
+  const BusRegionStatistics &Get(BusRegion region) const noexcept {
+    return regions[static_cast<u32>(region)];
+  }
+};
+
+} // namespace libmicroemu
@@ -2,6 +2,7 @@
 
 #include "libmicroemu/exception_states.h"
 #include "libmicroemu/exception_type.h"
+#include "libmicroemu/exclusive_monitor_states.h"
 #include "libmicroemu/register_id.h"
 #include "libmicroemu/special_register_id.h"
 #include "libmicroemu/types.h"
@@ -23,7 +24,8 @@ class CpuStates {
 public:
   /** @brief Constructs a CpuStates object.
    */
-  CpuStates() : registers_{}, special_registers_{}, exception_states_{} {
+  CpuStates()
+      : registers_{}, special_registers_{}, exception_states_{}, exclusive_monitor_states_{} {
     registers_.fill(0U);
     special_registers_.fill(0U);
   };
@@ -37,7 +39,7 @@ public:
    * @brief Copy constructor for CpuStates.
    * @param r_src the object to be copied
    */
-  CpuStates(CpuStates &r_src) noexcept = default;
+  CpuStates(const CpuStates &r_src) noexcept = default;
 
   /**
    * @brief Move constructor for CpuStates.
@@ -45,6 +47,19 @@ public:
    */
   CpuStates(CpuStates &&r_src) noexcept = default;
 
+  /**
+   * @brief Copy assignment operator for CpuStates.
+   * Used to restore the processor state from a snapshot.
+   * @param r_src the object to be copied
+   */
+  CpuStates &operator=(const CpuStates &r_src) noexcept = default;
+
+  /**
+   * @brief Move assignment operator for  CpuStates.
+   * @param r_src the object to be moved
+   */
+  CpuStates &operator=(CpuStates &&r_src) noexcept = default;
+
   /** @brief Get a reference on the raw register array.
    *
    * This function returns a reference to the raw register array.
@@ -93,22 +108,29 @@ public:
    */
   inline const auto &GetExceptionStates() const noexcept { return exception_states_; }
 
-private:
-  /**
-   * @brief Copy assignment operator for CpuStates.
-   * @param r_src the object to be copied
+  /** @brief Get a reference on the local exclusive monitor states.
+   *
+   * This function returns a reference to the local exclusive monitor states.
+   *
+   * @return The local exclusive monitor states.
    */
-  CpuStates &operator=(const CpuStates &r_src) noexcept = delete;
+  inline auto &GetExclusiveMonitorStates() noexcept { return exclusive_monitor_states_; }
 
-  /**
-   * @brief Move assignment operator for  CpuStates.
-   * @param r_src the object to be moved
+  /** @brief Get a const reference on the local exclusive monitor states.
+   *
+   * This function returns a const reference to the local exclusive monitor states.
+   *
+   * @return The local exclusive monitor states.
    */
-  CpuStates &operator=(CpuStates &&r_src) noexcept = delete;
+  inline const auto &GetExclusiveMonitorStates() const noexcept {
+    return exclusive_monitor_states_;
+  }
 
+private:
   std::array<u32, CountRegisters()> registers_;
   std::array<u32, CountPersistentSpecialRegisters()> special_registers_;
   ExceptionStates exception_states_;
+  ExclusiveMonitorStates exclusive_monitor_states_;
 };
 
 } // namespace libmicroemu
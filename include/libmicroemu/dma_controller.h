@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Contains a generic multi-channel DMA controller peripheral.
+ */
+#pragma once
+
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <array>
+
+namespace libmicroemu {
+
+/** @brief DMA controller with the register layout of the STM32F1 DMA.
+ *
+ * Register map (word accesses only):
+ *   - 0x00 ISR:  Interrupt flags, 4 bits per channel (GIF, TCIF, HTIF, TEIF) at bit 4 * channel.
+ *   - 0x04 IFCR: Writing 1 clears an interrupt flag. Clearing GIF clears all flags of the channel.
+ *   - 0x08 + 0x14 * channel: CCR, CNDTR, CPAR and CMAR of the channel.
+ *
+ * A channel starts when CCR.EN is set and CNDTR is not zero. The peripheral is assumed to be
+ * ready at all times, so memory-to-memory and peripheral transfers behave alike. Instead of moving
+ * one element per request, a transfer of n elements is performed in two halves: the first n / 2
+ * elements when (n / 2) * time_per_element has passed, the rest when n * time_per_element has
+ * passed. Transfers which increment both addresses with equal element sizes are copied as blocks,
+ * so flash and RAM are copied with memcpy. All other transfers are performed element by element,
+ * e.g. to feed a data register of a peripheral. After the first half HTIF is set and CNDTR holds
+ * the remaining elements, after the second half TCIF is set. The interrupt of the channel is set
+ * pending if HTIE or TCIE enables it. The destination memory is updated at these two times, not
+ * while a half is running.
+ */
+class DmaController : public IPeripheral {
+public:
+  static constexpr u32 kMaxChannels = 8U;
+
+  static constexpr me_offset_t kIsrOffset = 0x00U;
+  static constexpr me_offset_t kIfcrOffset = 0x04U;
+  static constexpr me_offset_t kChannelOffset = 0x08U;
+  static constexpr me_size_t kChannelStride = 0x14U;
+  static constexpr me_size_t kSize = kChannelOffset + kMaxChannels * kChannelStride;
+
+  // Registers of a channel relative to its start
+  static constexpr me_offset_t kCcrOffset = 0x00U;
+  static constexpr me_offset_t kCndtrOffset = 0x04U;
+  static constexpr me_offset_t kCparOffset = 0x08U;
+  static constexpr me_offset_t kCmarOffset = 0x0CU;
+
+  // Interrupt flags of channel 0, shifted by 4 * channel for the other channels
+  static constexpr u32 kGifMsk = 1U << 0U;
+  static constexpr u32 kTcifMsk = 1U << 1U;
+  static constexpr u32 kHtifMsk = 1U << 2U;
+  static constexpr u32 kTeifMsk = 1U << 3U;
+
+  // Bits of CCR
+  static constexpr u32 kCcrEnMsk = 1U << 0U;
+  static constexpr u32 kCcrTcieMsk = 1U << 1U;
+  static constexpr u32 kCcrHtieMsk = 1U << 2U;
+  static constexpr u32 kCcrTeieMsk = 1U << 3U;
+  static constexpr u32 kCcrDirMsk = 1U << 4U; // 1: read from memory
+  static constexpr u32 kCcrCircMsk = 1U << 5U;
+  static constexpr u32 kCcrPincMsk = 1U << 6U;
+  static constexpr u32 kCcrMincMsk = 1U << 7U;
+  static constexpr u32 kCcrPsizePos = 8U;  // 0: byte, 1: halfword, 2: word
+  static constexpr u32 kCcrMsizePos = 10U; // 0: byte, 1: halfword, 2: word
+  static constexpr u32 kCcrMem2MemMsk = 1U << 14U;
+
+  /**
+   * @brief Constructor
+   * @param no_of_channels Number of channels, at most kMaxChannels
+   * @param first_irq Number of the external interrupt of channel 0. Channel n uses first_irq + n.
+   * @param time_per_element Virtual time in instructions needed to transfer one element
+   */
+  DmaController(u32 no_of_channels, u32 first_irq, u64 time_per_element = 1U) noexcept;
+
+  void Reset(IPeripheralContext &ctx) noexcept override;
+
+  StatusCode Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                  u32 &value) noexcept override;
+
+  StatusCode Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                   u32 value) noexcept override;
+
+  StatusCode Tick(IPeripheralContext &ctx) noexcept override;
+
+private:
+  struct Channel {
+    u32 ccr{0U};
+    u32 cndtr{0U};
+    u32 cpar{0U};
+    u32 cmar{0U};
+    bool is_active{false};
+    bool is_half_pending{false}; // the next event transfers the first half
+    u32 length{0U};              // CNDTR at the start, reloaded in circular mode
+    u64 start{0U};
+    u64 due{kNoWakeUp};
+  };
+
+  static constexpr me_size_t kChunkSize = 1024U;
+
+  void Start(IPeripheralContext &ctx, u32 ch) noexcept;
+  void Advance(IPeripheralContext &ctx, u32 ch) noexcept;
+  u64 CalcDue(const Channel &channel, u32 no_of_elements) const noexcept;
+  StatusCode Transfer(IPeripheralContext &ctx, const Channel &channel, u32 first,
+                      u32 no_of_elements) noexcept;
+  void ScheduleNext(IPeripheralContext &ctx) noexcept;
+
+  u32 no_of_channels_;
+  u32 first_irq_;
+  u64 time_per_element_;
+  u32 isr_{0U};
+  std::array<Channel, kMaxChannels> channels_{};
+  std::array<u8, kChunkSize> chunk_{};
+};
+
+} // namespace libmicroemu
@@ -83,7 +83,7 @@ struct SingleExceptionState {
   inline u8 GetNumber() const noexcept { return number_; }
 
 private:
-  const u8 number_;
+  u8 number_; // not const so that exception states can be assigned, e.g. by snapshots
   i16 priority_;
   ExceptionFlagsSet flags_;
 };
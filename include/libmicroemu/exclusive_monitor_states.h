@@ -0,0 +1,97 @@
+#pragma once
+
+#include "libmicroemu/types.h"
+
+namespace libmicroemu {
+
+/** @brief Represents the state of the local exclusive monitor of a processor.
+ *
+ * A LDREX tags the address and remembers the version of its reservation in the global monitor.
+ * The global monitor counts the stores to reserved memory, so a STREX only stores if no observer
+ * wrote the location in between, also if the old value was written back.
+ *
+ * When the cores of a Soc run on private copies of the RAM, the global monitor cannot see the
+ * stores of the other cores. The Soc then arbitrates the exclusive stores: a STREX of a tagged
+ * monitor waits until the Soc granted it at the next barrier or cleared the monitor.
+ */
+struct ExclusiveMonitorStates {
+  /** @brief Marks an address for exclusive access.
+   *
+   * @param address The tagged address.
+   * @param version The version of the reservation in the global monitor.
+   */
+  inline void SetExclusive(me_adr_t address, u32 version) noexcept {
+    is_exclusive_ = true;
+    address_ = address;
+    version_ = version;
+  }
+
+  /** @brief Checks if the monitor is in the exclusive access state for an address.
+   *
+   * @param address The address to be checked.
+   * @return True if the address is tagged, false otherwise.
+   */
+  inline bool IsExclusive(me_adr_t address) const noexcept {
+    return is_exclusive_ && (address_ == address);
+  }
+
+  /** @brief Checks if the monitor is in the exclusive access state for any address.
+   *
+   * @return True if an address is tagged, false otherwise.
+   */
+  inline bool IsExclusive() const noexcept { return is_exclusive_; }
+
+  /** @brief Gets the tagged address.
+   *
+   * @return The address, only valid in the exclusive access state.
+   */
+  inline me_adr_t GetAddress() const noexcept { return address_; }
+
+  /** @brief Gets the version of the reservation of the tagged address.
+   *
+   * @return The version.
+   */
+  inline u32 GetVersion() const noexcept { return version_; }
+
+  /** @brief Returns the monitor to the open access state.
+   */
+  inline void ClearExclusive() noexcept {
+    is_exclusive_ = false;
+    is_granted_ = false;
+  }
+
+  /** @brief Enables or disables the arbitration of exclusive stores.
+   *
+   * @param is_arbitrated True if a STREX must be granted before it is executed.
+   */
+  inline void SetArbitrated(bool is_arbitrated) noexcept {
+    is_arbitrated_ = is_arbitrated;
+    is_granted_ = false;
+  }
+
+  /** @brief Grants the next STREX of the tagged monitor.
+   */
+  inline void Grant() noexcept { is_granted_ = true; }
+
+  /** @brief Checks if a STREX may be executed now and consumes the grant.
+   *
+   * @return False if the STREX must wait for the arbitration, true otherwise.
+   */
+  inline bool TakeGrant() noexcept {
+    if (!is_arbitrated_ || !is_exclusive_) {
+      return true; // a STREX of an open monitor fails without a store
+    }
+    const bool is_granted = is_granted_;
+    is_granted_ = false;
+    return is_granted;
+  }
+
+private:
+  bool is_exclusive_{false};
+  bool is_arbitrated_{false};
+  bool is_granted_{false};
+  me_adr_t address_{0U};
+  u32 version_{0U};
+};
+
+} // namespace libmicroemu
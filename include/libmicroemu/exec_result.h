@@ -20,8 +20,9 @@ public:
   /**
    * @brief Constructs a new ExecResult object.
    */
-  ExecResult(StatusCode status_code, int program_exit_code) noexcept
-      : status_code(status_code), program_exit_code(program_exit_code) {}
+  ExecResult(StatusCode status_code, int program_exit_code, u64 no_of_instructions = 0U) noexcept
+      : status_code(status_code), program_exit_code(program_exit_code),
+        no_of_instructions(no_of_instructions) {}
 
   /**
    * @brief Move Constructor
@@ -63,6 +64,38 @@ public:
     return status_code == StatusCode::kMaxInstructionsReached;
   };
 
+  /**
+   * @brief Checks if the execution stopped at the requested address.
+   * @return true if the execution stopped at the requested address, false otherwise.
+   */
+  inline bool IsStopAddressReached() const noexcept {
+    return status_code == StatusCode::kStopAddressReached;
+  };
+
+  /**
+   * @brief Checks if the execution stopped because a watchpoint was hit.
+   * @return true if a watchpoint was hit, false otherwise.
+   */
+  inline bool IsWatchpointHit() const noexcept {
+    return status_code == StatusCode::kWatchpointHit;
+  };
+
+  /**
+   * @brief Checks if the execution stopped because a write hit a stack guard region.
+   * @return true if a stack overflow was detected, false otherwise.
+   */
+  inline bool IsStackOverflow() const noexcept {
+    return status_code == StatusCode::kStackOverflow;
+  };
+
+  /**
+   * @brief Checks if the execution stopped because a stop was requested.
+   * @return true if a stop was requested, false otherwise.
+   */
+  inline bool IsStopRequested() const noexcept {
+    return status_code == StatusCode::kStopRequested;
+  };
+
   /**
    * @brief Converts the contained status code to a string.
    * @return The string representation of the status code.
@@ -82,9 +115,16 @@ public:
    */
   u32 GetProgramExitCode() const noexcept { return program_exit_code; }
 
+  /**
+   * @brief Gets the number of instructions executed by the call.
+   * @return The number of executed instructions.
+   */
+  u64 GetNoOfInstructions() const noexcept { return no_of_instructions; }
+
 private:
   const StatusCode status_code;
   const int program_exit_code;
+  const u64 no_of_instructions;
 };
 
 } // namespace libmicroemu
\ No newline at end of file
@@ -0,0 +1,222 @@
+/**
+ * @file
+ * @brief Contains the fault-injection campaign which flips single bits of a program run.
+ */
+#pragma once
+
+#include "libmicroemu/register_id.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <functional>
+
+namespace libmicroemu {
+
+class Machine;
+
+/// @brief Callback function which prepares the machine of a campaign thread
+/// @param machine The machine, its memory segments are already set
+/// @param flash_seg The copy of the flash segment owned by the machine
+/// @return StatusCode indicating success or the error which aborts the campaign
+using FFaultSetupCallback = std::function<StatusCode(Machine &machine, u8 *flash_seg)>;
+
+/// @brief Where a fault flips a bit
+enum class FaultLocation : u8 {
+  kRegister = 0U, ///< A core register, bit 0 to 31
+  kMemory = 1U,   ///< A byte of the flash, RAM1 or RAM2 segment, bit 0 to 7
+};
+
+/// @brief A single-bit fault
+struct Fault {
+  /// Number of instructions executed from reset before the bit is flipped
+  u64 instruction{0U};
+  FaultLocation location{FaultLocation::kRegister};
+  RegisterId reg_id{RegisterId::kR0}; ///< Register of a kRegister fault
+  me_adr_t adr{0x0U};                 ///< Address of a kMemory fault
+  u8 bit{0U};
+};
+
+/// @brief Classification of a faulty run
+enum class FaultOutcome : u8 {
+  kMasked = 0U,           ///< Same exit code and final state as the golden run
+  kDetected = 1U,         ///< Emulator error, other exit code or detection address reached
+  kSilentCorruption = 2U, ///< Same exit code, but the final state differs
+  kHang = 3U,             ///< The timeout was reached
+};
+
+/// @brief Result of a faulty run
+struct FaultResult {
+  FaultOutcome outcome{FaultOutcome::kMasked};
+  StatusCode status_code{StatusCode::kSuccess}; ///< Status code of the execution
+  u32 exit_code{0U};                            ///< Program exit code
+  u64 instructions{0U};                         ///< Instructions executed from reset
+};
+
+/**
+ * @brief Converts a fault outcome to a string
+ * @param outcome the outcome to convert
+ * @return a string representation of the outcome
+ */
+const char *FaultOutcomeToString(FaultOutcome outcome) noexcept;
+
+/** @brief Injects single-bit faults into runs of a program on a pool of host threads.
+ *
+ * RunGolden executes the program once without faults. It records the exit code, the number of
+ * instructions and a hash of the final state. The hash covers the core registers, RAM1, RAM2 and
+ * the console output of the program.
+ *
+ * Run executes one faulty run per fault. Every thread owns a machine with its own copy of the
+ * memory. The faults are taken in the order of their injection time, so a thread only executes
+ * the instructions between two injection points: it restores the snapshot of the last injection
+ * point, executes up to the next one and moves the snapshot there, so a thread holds at most two
+ * snapshots. Then it flips the bit, runs the program to its end or the timeout and restores the
+ * snapshot again. Snapshots only copy the
+ * pages written since they were taken, so a faulty run costs little more than its instructions.
+ */
+class FaultCampaign {
+public:
+  /**
+   * @brief Constructor
+   */
+  FaultCampaign() noexcept = default;
+
+  /**
+   * @brief Copy constructor for FaultCampaign.
+   * @param r_src the object to be copied
+   */
+  FaultCampaign(const FaultCampaign &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for FaultCampaign.
+   * @param r_src the object to be copied
+   */
+  FaultCampaign &operator=(const FaultCampaign &r_src) = delete;
+
+  /**
+   * @brief Move constructor for FaultCampaign.
+   * @param r_src the object to be moved
+   */
+  FaultCampaign(FaultCampaign &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for FaultCampaign.
+   * @param r_src the object to be moved
+   */
+  FaultCampaign &operator=(FaultCampaign &&r_src) = delete;
+
+  /**
+   * @brief Sets the flash segment. Every thread allocates its own copy.
+   * @param seg_size Size of the flash segment
+   * @param seg_vadr Virtual address of the flash segment
+   */
+  void SetFlashSegment(me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+
+  /**
+   * @brief Sets the RAM1 segment. Every thread allocates its own copy.
+   * @param seg_size Size of the RAM1 segment
+   * @param seg_vadr Virtual address of the RAM1 segment
+   */
+  void SetRam1Segment(me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+
+  /**
+   * @brief Sets the RAM2 segment. Every thread allocates its own copy.
+   * @param seg_size Size of the RAM2 segment
+   * @param seg_vadr Virtual address of the RAM2 segment
+   */
+  void SetRam2Segment(me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+
+  /**
+   * @brief Sets the callback which loads the program into the machine of every thread, e.g. by
+   * copying an image to the flash segment and resetting the machine. It may also attach the
+   * peripherals of the program. The callback is called on the campaign threads.
+   * @param callback The setup callback
+   */
+  void SetSetupCallback(FFaultSetupCallback callback) noexcept;
+
+  /**
+   * @brief Sets a setup callback which loads an ELF file into the machine of every thread.
+   * @param elf_file Path to the ELF file
+   * @param set_entry_point Set the entry point from the ELF file
+   */
+  void SetElfFile(const char *elf_file, bool set_entry_point = false);
+
+  /**
+   * @brief Sets the maximum number of instructions of a faulty run, counted from reset.
+   * A faulty run which reaches it is classified as kHang.
+   * @param max_instructions The limit, 0 uses twice the instructions of the golden run
+   */
+  void SetTimeout(u64 max_instructions) noexcept { timeout_ = max_instructions; }
+
+  /**
+   * @brief Sets an address whose execution classifies a faulty run as kDetected, e.g. the error
+   * handler of a safety mechanism.
+   * @param vadr The address or kNoDetectionAdr
+   */
+  void SetDetectionAddress(me_adr_t vadr) noexcept { detection_adr_ = vadr; }
+
+  static constexpr me_adr_t kNoDetectionAdr = 0xFFFFFFFFU;
+
+  /**
+   * @brief Runs the program without faults and records the reference result.
+   * @param max_instructions Maximum number of instructions. -1 means infinite
+   * @return StatusCode indicating success, kUnsuporrted without a setup callback, the error of
+   * the setup callback or the status code of a golden run which did not terminate successfully
+   */
+  StatusCode RunGolden(i64 max_instructions = -1) noexcept;
+
+  /**
+   * @brief Gets the number of instructions of the golden run
+   * @return Number of instructions
+   */
+  u64 GetGoldenInstructions() const noexcept { return golden_instructions_; }
+
+  /**
+   * @brief Gets the program exit code of the golden run
+   * @return Program exit code
+   */
+  u32 GetGoldenExitCode() const noexcept { return golden_exit_code_; }
+
+  /**
+   * @brief Gets the hash of the final state of the golden run
+   * @return Hash of the registers, the RAM and the console output
+   */
+  u64 GetGoldenHash() const noexcept { return golden_hash_; }
+
+  /**
+   * @brief Runs one faulty run per fault.
+   * @param faults The faults to inject
+   * @param no_of_faults Number of faults
+   * @param results Receives the result of every fault, in the order of the faults
+   * @param no_of_threads Number of host threads, 0 uses all host threads
+   * @return StatusCode indicating success, kUnsuporrted without a golden run, kOutOfRange if a
+   * fault is not injected before the golden run ends or has no valid location, kError if no host
+   * memory is available or a run ends before its injection point, or the error of the setup
+   * callback
+   */
+  StatusCode Run(const Fault *faults, u32 no_of_faults, FaultResult *results,
+                 u32 no_of_threads = 0U) noexcept;
+
+private:
+  struct Segment {
+    me_size_t size{0U};
+    me_adr_t vadr{0x0U};
+  };
+
+  class Worker;
+
+  bool IsValid(const Fault &fault) const noexcept;
+  u64 GetTimeout() const noexcept;
+
+  Segment flash_{};
+  Segment ram1_{};
+  Segment ram2_{};
+  FFaultSetupCallback setup_callback_{nullptr};
+  u64 timeout_{0U};
+  me_adr_t detection_adr_{kNoDetectionAdr};
+
+  bool has_golden_run_{false};
+  u64 golden_instructions_{0U};
+  u32 golden_exit_code_{0U};
+  u64 golden_hash_{0U};
+};
+
+} // namespace libmicroemu
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Contains the firmware image which is loaded once and shared by many machines.
+ */
+#pragma once
+
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <memory>
+
+namespace libmicroemu {
+
+/** @brief An ELF file loaded into a flash buffer which is shared by many machines.
+ *
+ * Load reads the ELF file once: the code is written to a flash buffer owned by the image, all
+ * other segments are kept in host memory. Machine::Load(const FirmwareImage &) then references
+ * the flash buffer instead of copying it and only copies the data segments to the RAM of the
+ * machine. The image is not changed after Load, so machines on different host threads may load
+ * and execute it concurrently. Every machine keeps its own RAM and processor state.
+ */
+class FirmwareImage {
+public:
+  /**
+   * @brief Constructor
+   */
+  FirmwareImage() noexcept = default;
+
+  /**
+   * @brief Copy constructor for FirmwareImage.
+   * @param r_src the object to be copied
+   */
+  FirmwareImage(const FirmwareImage &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for FirmwareImage.
+   * @param r_src the object to be copied
+   */
+  FirmwareImage &operator=(const FirmwareImage &r_src) = delete;
+
+  /**
+   * @brief Move constructor for FirmwareImage.
+   * @param r_src the object to be moved
+   */
+  FirmwareImage(FirmwareImage &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for FirmwareImage.
+   * @param r_src the object to be moved
+   */
+  FirmwareImage &operator=(FirmwareImage &&r_src) = delete;
+
+  /**
+   * @brief Loads an ELF file into the image.
+   * Must not be called while a machine references the image.
+   * @param elf_file Path to the ELF file
+   * @param flash_size Size of the flash segment
+   * @param flash_vadr Virtual address of the flash segment
+   * @return StatusCode indicating success or error (e.g., file open failure, no host memory or
+   * ELF parsing errors)
+   */
+  StatusCode Load(const char *elf_file, me_size_t flash_size, me_adr_t flash_vadr) noexcept;
+
+  /**
+   * @brief Checks if an ELF file was loaded
+   * @return true if the image can be loaded into machines
+   */
+  bool IsLoaded() const noexcept { return is_loaded_; }
+
+  /**
+   * @brief Gets the flash segment
+   * @return Pointer to the flash buffer
+   */
+  const u8 *GetFlash() const noexcept { return flash_.get(); }
+
+  /**
+   * @brief Gets the size of the flash segment
+   * @return Size in bytes
+   */
+  me_size_t GetFlashSize() const noexcept { return flash_size_; }
+
+  /**
+   * @brief Gets the virtual address of the flash segment
+   * @return Virtual address
+   */
+  me_adr_t GetFlashVadr() const noexcept { return flash_vadr_; }
+
+  /**
+   * @brief Gets the entry point of the ELF file
+   * @return Entry point
+   */
+  me_adr_t GetEntryPoint() const noexcept { return entry_point_; }
+
+private:
+  friend class Machine; // copies the segments to its memory
+
+  /// A segment of the ELF file which is not part of the flash buffer
+  struct Segment {
+    me_adr_t vadr{0x0U};
+    bool is_code{false};
+    me_size_t size{0U};
+    std::unique_ptr<u8[]> data;
+  };
+
+  std::unique_ptr<u8[]> flash_;
+  me_size_t flash_size_{0U};
+  me_adr_t flash_vadr_{0x0U};
+  me_adr_t entry_point_{0x0U};
+  std::unique_ptr<Segment[]> segments_;
+  u32 no_of_segments_{0U};
+  bool is_loaded_{false};
+};
+
+} // namespace libmicroemu
@@ -19,50 +19,130 @@ enum class LogLevel {
   kCritical ///< Critical log level
 };
 
+/// @brief Callback function which receives the log messages
+/// @param level The log level of the message
+/// @param user_data The pointer registered together with the callback, e.g. the sink of a machine
+/// @param format printf-style format string followed by its arguments
+using FLoggerCallback = void (*)(LogLevel level, void *user_data, const char *format,
+                                 ...) noexcept;
+
 /**
  * @brief Static logger class
+ * The callback is stored per host thread. Each thread which runs a machine logs to the callback
+ * the machine installed for the duration of the call, see StaticLoggerScope.
  */
 class StaticLogger {
 
 public:
   template <typename... Args> static void Info(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kInfo, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kInfo, user_data_, format, std::forward<Args>(args)...);
     }
   }
   template <typename... Args> static void Debug(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kDebug, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kDebug, user_data_, format, std::forward<Args>(args)...);
     }
   }
   template <typename... Args> static void Trace(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kTrace, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kTrace, user_data_, format, std::forward<Args>(args)...);
     }
   }
   template <typename... Args> static void Warn(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kWarn, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kWarn, user_data_, format, std::forward<Args>(args)...);
     }
   }
   template <typename... Args> static void Error(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kError, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kError, user_data_, format, std::forward<Args>(args)...);
     }
   }
   template <typename... Args> static void Critical(const char *format, Args &&...args) noexcept {
     if (callback_) {
-      callback_(LogLevel::kCritical, format, std::forward<Args>(args)...);
+      callback_(LogLevel::kCritical, user_data_, format, std::forward<Args>(args)...);
     }
   }
 
-  static void RegisterLoggerCallback(void (*callback)(libmicroemu::LogLevel level, const char *,
-                                                      ...) noexcept) noexcept {
+  /**
+   * @brief Sets the callback of the calling thread.
+   * @param callback the callback or nullptr to disable logging
+   * @param user_data passed to every call of the callback
+   */
+  static void RegisterLoggerCallback(FLoggerCallback callback, void *user_data = nullptr) noexcept {
     callback_ = callback;
+    user_data_ = user_data;
   };
 
+  /**
+   * @brief Gets the callback of the calling thread.
+   * @return the callback or nullptr if logging is disabled
+   */
+  static FLoggerCallback GetLoggerCallback() noexcept { return callback_; }
+
+  /**
+   * @brief Gets the user data of the callback of the calling thread.
+   * @return the user data
+   */
+  static void *GetLoggerUserData() noexcept { return user_data_; }
+
+private:
+  static thread_local FLoggerCallback callback_;
+  static thread_local void *user_data_;
+};
+
+/**
+ * @brief Installs a logger callback for the calling thread while the scope exists.
+ * The previous callback of the thread is restored when the scope ends.
+ */
+class StaticLoggerScope {
+public:
+  /**
+   * @brief Constructor
+   * @param callback the callback to install
+   * @param user_data passed to every call of the callback
+   */
+  explicit StaticLoggerScope(FLoggerCallback callback, void *user_data = nullptr) noexcept
+      : previous_(StaticLogger::GetLoggerCallback()),
+        previous_user_data_(StaticLogger::GetLoggerUserData()) {
+    StaticLogger::RegisterLoggerCallback(callback, user_data);
+  }
+
+  /**
+   * @brief Destructor. Restores the previous callback.
+   */
+  ~StaticLoggerScope() noexcept {
+    StaticLogger::RegisterLoggerCallback(previous_, previous_user_data_);
+  }
+
+  /**
+   * @brief Copy constructor for StaticLoggerScope.
+   * @param r_src the object to be copied
+   */
+  StaticLoggerScope(const StaticLoggerScope &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for StaticLoggerScope.
+   * @param r_src the object to be copied
+   */
+  StaticLoggerScope &operator=(const StaticLoggerScope &r_src) = delete;
+
+  /**
+   * @brief Move constructor for StaticLoggerScope.
+   * @param r_src the object to be moved
+   */
+  StaticLoggerScope(StaticLoggerScope &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for StaticLoggerScope.
+   * @param r_src the object to be moved
+   */
+  StaticLoggerScope &operator=(StaticLoggerScope &&r_src) = delete;
+
 private:
-  static void (*callback_)(libmicroemu::LogLevel level, const char *, ...) noexcept;
+  FLoggerCallback previous_;
+  void *previous_user_data_;
 };
 
 /**
@@ -5,15 +5,22 @@
  */
 #pragma once
 
+#include "libmicroemu/bus_statistics.h"
 #include "libmicroemu/cpu_states.h"
 #include "libmicroemu/emu_context.h"
 #include "libmicroemu/exec_result.h"
+#include "libmicroemu/firmware_image.h"
 #include "libmicroemu/logger.h"
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/stack_guard.h"
 #include "libmicroemu/status_code.h"
 #include "libmicroemu/types.h"
+#include "libmicroemu/watchpoint.h"
 
 #include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
 
 /**
  * @brief The \ref libmicroemu namespace contains all classes and functions of the libmicroemu which
@@ -28,6 +35,13 @@ namespace libmicroemu {
 namespace internal {
 // forward declarations
 template <typename TCpuStates> class Emulator;
+class SparsePageStore;
+class PageFlagTable;
+class SnapshotStore;
+class PluginRegistry;
+class AccessMonitor;
+class EdgeCoverage;
+class IrqInjector;
 }; // namespace internal
 
 /// @brief Callback function to be called before each instruction is executed
@@ -44,6 +58,11 @@ using FPostExecStepCallback = std::function<void(EmuContext &ctx)>;
 using FStateCallback =
     std::function<void(IRegAccessor &reg_access, ISpecialRegAccessor &spec_reg_access)>;
 
+/// @brief Callback function which receives the console output of the program
+/// @param buf The text written to stdout or stderr through semihosting, not null-terminated
+/// @param len The length of the text in bytes
+using FConsoleCallback = std::function<void(const char *buf, me_size_t len)>;
+
 /**
  * @brief Represents the main emulation machine for handling microcontroller emulation.
  *
@@ -72,14 +91,38 @@ public:
    * @param elf_file Path to the ELF file.
    * @param set_entry_point Whether to set the entry point in the emulator.
    * @return StatusCode indicating success or error (e.g., file open failure,
-   *         buffer too small, or ELF parsing errors).
+   *         buffer too small, or ELF parsing errors). kUnsuporrted if the flash segment is
+   *         borrowed from a FirmwareImage and SetFlashSegment was not called since.
    *
    * @note Ensures segments fit within memory bounds and resets the emulator state.
    */
   StatusCode Load(const char *elf_file, bool set_entry_point = false) noexcept;
 
+  /**
+   * @brief Loads a firmware image and optionally sets the entry point.
+   *
+   * The flash segment of the machine is set to the flash buffer of the image, the flash is not
+   * copied. The machine only reads the borrowed flash, so Load(const char *, bool) fails until
+   * SetFlashSegment sets a flash segment of the machine again. The data segments of the image are copied to RAM like by Load(const char *, bool).
+   * Any number of machines may load the same image, also on different host threads.
+   *
+   * @param image The image, it must outlive its use by the machine.
+   * @param set_entry_point Whether to set the entry point in the emulator.
+   * @return StatusCode indicating success, kUnsuporrted if the image is not loaded or
+   *         kBufferTooSmall if a segment does not fit into RAM.
+   */
+  StatusCode Load(const FirmwareImage &image, bool set_entry_point = false) noexcept;
+
   StatusCode Reset() noexcept;
 
+  /**
+   * @brief Sets the vector table the processor boots from (VTOR)
+   * Takes effect at the next reset, e.g. for the second core of a Soc which has its own table.
+   * @param vadr Address of the vector table, a multiple of 128
+   * @return StatusCode indicating success or kOutOfRange if the address is not aligned
+   */
+  StatusCode SetVectorTable(me_adr_t vadr) noexcept;
+
   /**
    * @brief Executes the loaded program
    * @param max_instructions Maximum number of instructions to execute. -1 means infinite
@@ -90,6 +133,20 @@ public:
   ExecResult Exec(i64 max_instructions = -1, FPreExecStepCallback cb_pre_exec = nullptr,
                   FPostExecStepCallback cb_post_exec = nullptr) noexcept;
 
+  /**
+   * @brief Executes the loaded program until the given address is reached
+   * Execution stops before the instruction at the given address is executed. If the program
+   * counter already equals the address, no instruction is executed.
+   * @param stop_adr Address at which the execution stops, the thumb bit is ignored
+   * @param max_instructions Maximum number of instructions to execute. -1 means infinite
+   * @param cb_pre_exec Callback function to be called before each instruction is executed
+   * @param cb_post_exec Callback function to be called after each instruction is executed
+   * @return Result of the execution. kStopAddressReached if the address was reached
+   */
+  ExecResult ExecUntil(me_adr_t stop_adr, i64 max_instructions = -1,
+                       FPreExecStepCallback cb_pre_exec = nullptr,
+                       FPostExecStepCallback cb_post_exec = nullptr) noexcept;
+
   /**
    * @brief Sets the Flash segment
    * The flash segment is where a microcontroller stores its program code. A flash
@@ -107,8 +164,12 @@ public:
    * @param seg_ptr Pointer to the RAM1 segment
    * @param seg_size Size of the RAM1 segment
    * @param seg_vadr Virtual address of the RAM1 segment
+   * @param is_external true if the segment is owned by the host, e.g. a SharedMemory mapping.
+   * Load and the lazy filling never fill an external segment with 0xFF, so data written by the
+   * host before the load is kept.
    */
-  void SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+  void SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      bool is_external = false) noexcept;
 
   /**
    * @brief Sets the RAM2 segment
@@ -117,8 +178,302 @@ public:
    * @param seg_ptr Pointer to the RAM2 segment
    * @param seg_size Size of the RAM2 segment
    * @param seg_vadr Virtual address of the RAM2 segment
+   * @param is_external true if the segment is owned by the host, e.g. a SharedMemory mapping.
+   * Load and the lazy filling never fill an external segment with 0xFF, so data written by the
+   * host before the load is kept.
+   */
+  void SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      bool is_external = false) noexcept;
+
+  /**
+   * @brief Enables or disables the lazy filling of the RAM segments
+   * Load fills RAM1 and RAM2 with 0xFF. When lazy filling is enabled, a 1 KiB page is filled on
+   * its first access instead, so loading a program for a large RAM configuration only touches
+   * the pages which are used. The content seen by the firmware is the same in both modes.
+   * Accesses to the RAM through the host pointers bypass the filling. Takes effect with the next
+   * Load.
+   * @param enable true to fill the pages on their first access
+   */
+  void SetLazyRamFill(bool enable) noexcept;
+
+  /**
+   * @brief Enables the sparse memory backend
+   * When enabled, every address which is not covered by the flash, RAM or peripheral segments is
+   * backed by lazily committed memory. Host memory is only allocated for pages which are written
+   * by the firmware. Segments of an ELF file which do not fit into the configured segments are
+   * loaded into the sparse memory.
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode EnableSparseMemory() noexcept;
+
+  /**
+   * @brief Disables the sparse memory backend and releases all of its pages
+   */
+  void DisableSparseMemory() noexcept;
+
+  /**
+   * @brief Marks an address range of the sparse memory as unmapped
+   * Accesses to this range fault in the same way as accesses to unmapped memory do when the
+   * sparse memory backend is disabled.
+   * @param vadr Virtual start address of the range
+   * @param size Size of the range in bytes
+   * @return StatusCode indicating success, kUnsuporrted if the sparse memory is not enabled or
+   * kOutOfRange if the size is zero or too many regions were added
+   */
+  StatusCode AddUnmappedRegion(me_adr_t vadr, me_size_t size) noexcept;
+
+  /**
+   * @brief Gets the host memory footprint of the sparse memory
+   * @return Number of bytes committed by the sparse memory backend
+   */
+  u64 GetSparseMemoryFootprint() const noexcept;
+
+  /**
+   * @brief Attaches a peripheral to the machine
+   * Accesses to the given address range are forwarded to the peripheral. Flash, RAM and the
+   * built-in system peripherals take precedence over the range. The peripheral is not owned by
+   * the machine and must outlive it or be detached first. Peripherals are reset whenever the
+   * machine is reset, including the reset done by Load.
+   * @param peripheral The peripheral to attach
+   * @param vadr Virtual start address of the range
+   * @param size Size of the range in bytes
+   * @return StatusCode indicating success, kOutOfRange if the range is empty, overlaps the range
+   * of another peripheral or too many peripherals were attached, or kError if no host memory is
+   * available
+   */
+  StatusCode AttachPeripheral(IPeripheral *peripheral, me_adr_t vadr, me_size_t size) noexcept;
+
+  /**
+   * @brief Detaches all peripherals which were attached at runtime
+   */
+  void DetachPeripherals() noexcept;
+
+  /**
+   * @brief Gets the virtual time of the machine
+   * The virtual time counts the executed instructions since the last reset. It is only advanced
+   * while peripherals are attached.
+   * @return The virtual time
+   */
+  u64 GetVirtualTime() const noexcept;
+
+  /**
+   * @brief Enables the injection of external interrupts from other host threads
+   * Must be called before the machine is executed. It also enables the virtual time, see
+   * GetVirtualTime.
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode EnableIrqInjection() noexcept;
+
+  /**
+   * @brief Sets an external interrupt pending before the next instruction
+   * May be called from any host thread while the machine runs. The call is lock-free, the run
+   * loop delivers the interrupt after the instruction which is executed at that moment.
+   * @param irq Number of the external interrupt
+   * @return StatusCode indicating success, kUnsuporrted if the injection is not enabled or
+   * kOutOfRange if the interrupt number is too high
+   */
+  StatusCode InjectIrq(u32 irq) noexcept;
+
+  /**
+   * @brief Sets an external interrupt pending when the virtual time is reached
+   * May be called from any host thread while the machine runs. An interrupt which is injected
+   * before its time is delivered after the same instruction on every run, which makes recorded
+   * events replayable. A time in the past is delivered before the next instruction. A reset
+   * discards all injected interrupts, restoring a snapshot does not.
+   * @param irq Number of the external interrupt
+   * @param time Virtual time of the delivery
+   * @return StatusCode indicating success, kUnsuporrted if the injection is not enabled,
+   * kOutOfRange if the interrupt number is too high or kBufferTooSmall if too many injected
+   * interrupts wait for their time
+   */
+  StatusCode InjectIrqAt(u32 irq, u64 time) noexcept;
+
+  /**
+   * @brief Gets the access counters of the memory bus
+   * Every access is counted for the bus region which served it, split into instruction fetches,
+   * data reads and data writes and by access width. The counters are cleared by Load.
+   * @return The access counters
+   */
+  const BusStatistics &GetBusStatistics() const noexcept { return bus_stats_; }
+
+  /**
+   * @brief Clears the access counters of the memory bus
+   */
+  void ResetBusStatistics() noexcept { bus_stats_ = BusStatistics{}; }
+
+  /**
+   * @brief Adds a data watchpoint
+   * A watchpoint hits on loads and/or stores which touch the given address range. By default the
+   * execution stops with kWatchpointHit after the instruction which performed the access. If a
+   * watchpoint callback is set, it decides whether the execution stops. Instruction fetches do not
+   * hit watchpoints. Only accesses to memory pages which contain a watchpoint are checked, all
+   * other accesses are not slowed down.
+   * @param vadr Virtual start address of the watched range
+   * @param size Size of the watched range in bytes
+   * @param flags Combination of WatchFlags selecting reads, writes and value matching
+   * @param id Receives the id of the watchpoint
+   * @param match_value Value the accessed value is compared with if WatchFlags::kValueMatch is set
+   * @return StatusCode indicating success, kOutOfRange if the range is invalid, no access type was
+   * selected or too many watchpoints were added, or kError if no host memory is available
+   */
+  StatusCode AddWatchpoint(me_adr_t vadr, me_size_t size, WatchFlagsSet flags, u32 &id,
+                           u32 match_value = 0U) noexcept;
+
+  /**
+   * @brief Removes a data watchpoint
+   * @param id Id of the watchpoint
+   * @return StatusCode indicating success, kOutOfRange if the watchpoint does not exist or kError
+   * if no host memory is available
+   */
+  StatusCode RemoveWatchpoint(u32 id) noexcept;
+
+  /**
+   * @brief Removes all data watchpoints
+   */
+  void ClearWatchpoints() noexcept;
+
+  /**
+   * @brief Sets the callback which is called when a watchpoint is hit
+   * \attention The callback is not allowed to throw exceptions.
+   * @param cb Callback deciding whether the execution stops. nullptr always stops.
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode SetWatchpointCallback(FWatchpointCallback cb) noexcept;
+
+  /**
+   * @brief Gets the access which hit a watchpoint last
+   * @param hit Receives the access
+   * @return true if a watchpoint was hit since the watchpoints were configured
+   */
+  bool GetLastWatchpointHit(WatchpointHit &hit) const noexcept;
+
+  /**
+   * @brief Adds a PMSAv7 memory protection unit with 8 regions to the processor
+   * Without it MPU_TYPE reads as zero and no access is checked. The permissions are compiled into
+   * the page flags of the bus whenever the MPU is reprogrammed, so the check of an access is a
+   * flag test. Accesses denied by the MPU raise a MemManage fault.
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode EnableMpu() noexcept;
+
+  /**
+   * @brief Sets a guard region below a stack
+   * Writes into the guard region are refused, which catches stack overflows before they corrupt
+   * the memory below the stack. Depending on the configured action the execution stops with
+   * kStackOverflow or a precise bus fault is raised in the emulated processor. Only accesses to
+   * the memory pages of the guard regions are checked, all other accesses are not slowed down.
+   * @param id The stack the guard belongs to
+   * @param stack_limit Lowest address of the stack. The guard region ends right below it.
+   * @param size Size of the guard region in bytes
+   * @return StatusCode indicating success, kOutOfRange if the region is invalid or kError if no
+   * host memory is available
+   */
+  StatusCode SetStackGuard(StackGuardId id, me_adr_t stack_limit, me_size_t size) noexcept;
+
+  /**
+   * @brief Removes all stack guard regions
+   */
+  void ClearStackGuards() noexcept;
+
+  /**
+   * @brief Selects what happens when a write hits a stack guard region
+   * @param action The action. The default is StackGuardAction::kStop.
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode SetStackGuardAction(StackGuardAction action) noexcept;
+
+  /**
+   * @brief Sets the bitmap of an AFL-style edge coverage map
+   * Every taken branch and exception entry increments the byte of the edge between the previous
+   * and the current branch target. A branch to the next instruction is not recorded. The check
+   * is compiled into the run loop only while a bitmap is set, so runs without it are not slowed
+   * down. The bitmap can be the shared memory of an external fuzzer.
+   * @param bitmap The bitmap, it must outlive its use by the machine. nullptr disables coverage
+   * @param size Size of the bitmap in bytes, a power of two
+   * @return StatusCode indicating success, kOutOfRange if the size is not a power of two or kError
+   * if no host memory is available
+   */
+  StatusCode SetCoverageMap(u8 *bitmap, me_size_t size) noexcept;
+
+  /**
+   * @brief Forgets the previous branch target of the edge coverage map
+   * Call it before every fuzz input, so the first edge of a run does not depend on the previous
+   * run.
+   */
+  void ResetCoverageLocation() noexcept;
+
+  /**
+   * @brief Takes a snapshot of the machine
+   * A snapshot contains the processor state and the content of all writable memory (RAM1, RAM2
+   * and the sparse memory). The first snapshot copies all memory. Every further snapshot only
+   * stores the pages written since the previous snapshot. The state of attached peripherals and
+   * plugins, the virtual time of the plugin registry and pending injected interrupts are not part
+   * of a snapshot and are not restored.
+   * @param snapshot_id Receives the id of the snapshot
+   * @return StatusCode indicating success or kError if no host memory is available
+   */
+  StatusCode TakeSnapshot(u32 &snapshot_id) noexcept;
+
+  /**
+   * @brief Replaces the newest snapshot with a snapshot of the current state
+   * Used to move a snapshot forward, e.g. along the injection points of a fault campaign, without
+   * growing the number of stored snapshots. The new snapshot stores the pages of the replaced one
+   * and the pages written since. The snapshot of the golden state cannot be replaced.
+   * @param snapshot_id Receives the id of the snapshot, which is the id of the replaced one
+   * @return StatusCode indicating success, kOutOfRange if there is no snapshot, kUnsuporrted if the
+   * newest snapshot holds the golden state or kError if no host memory is available
+   */
+  StatusCode ReplaceNewestSnapshot(u32 &snapshot_id) noexcept;
+
+  /**
+   * @brief Restores a snapshot of the machine
+   * Only the pages written since the snapshot was taken are copied back. All snapshots which
+   * are newer than the restored one are discarded, the restored snapshot itself is kept.
+   * @param snapshot_id Id of the snapshot to restore
+   * @return StatusCode indicating success or kOutOfRange if the snapshot does not exist
+   */
+  StatusCode RestoreSnapshot(u32 snapshot_id) noexcept;
+
+  /**
+   * @brief Discards all snapshots and stops tracking written pages
+   * Snapshots are discarded automatically when the memory configuration changes or an ELF file
+   * is loaded.
+   */
+  void DiscardSnapshots() noexcept;
+
+  /**
+   * @brief Captures the current state of the machine as golden state
+   * Typically called right after Load to capture the state after boot. Capturing a golden state
+   * discards all snapshots. The golden state is kept until it is replaced, an ELF file is loaded,
+   * the memory configuration changes or the snapshots are discarded.
+   * @return StatusCode indicating success or kError if no host memory is available
    */
-  void SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+  StatusCode CaptureGoldenState() noexcept;
+
+  /**
+   * @brief Executes the program up to the given address and captures the golden state there
+   * Useful to skip the reset handler and the C runtime initialization, e.g. by passing the
+   * address of main or of a test harness entry function.
+   * @param stop_adr Address at which the golden state is captured, the thumb bit is ignored
+   * @param max_instructions Maximum number of instructions to execute. -1 means infinite
+   * @return StatusCode indicating success, kMaxInstructionsReached if the address was not hit in
+   * time, kOutOfRange if the program terminated before or the status code of a failed execution
+   */
+  StatusCode CaptureGoldenStateAt(me_adr_t stop_adr, i64 max_instructions = -1) noexcept;
+
+  /**
+   * @brief Resets the machine to the golden state
+   * Only the pages written since the golden state was captured are copied back, so the time
+   * needed is proportional to the memory touched by the previous run.
+   * @return StatusCode indicating success or kUnsuporrted if no golden state was captured
+   */
+  StatusCode ResetToGoldenState() noexcept;
+
+  /**
+   * @brief Checks if a golden state was captured
+   * @return true if a golden state is available
+   */
+  bool HasGoldenState() const noexcept;
 
   /**
    * @brief Evaluates the state of the processor
@@ -129,8 +484,63 @@ public:
    */
   void EvaluateState(FStateCallback cb) noexcept;
 
-  static void RegisterLoggerCallback(void (*callback)(libmicroemu::LogLevel level, const char *,
-                                                      ...) noexcept) noexcept;
+  /**
+   * @brief Copies a block of guest memory to a host buffer
+   * Memory backed by host buffers is copied with memcpy, only peripherals are read byte by byte.
+   * @param vadr Virtual start address of the block
+   * @param dst Destination buffer
+   * @param size Size of the block in bytes
+   * @return StatusCode indicating success or the error of the first byte which could not be read
+   */
+  StatusCode ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) noexcept;
+
+  /**
+   * @brief Copies a host buffer to a block of guest memory
+   * Memory backed by host buffers is copied with memcpy, only peripherals are written byte by byte.
+   * @param vadr Virtual start address of the block
+   * @param src Source buffer
+   * @param size Size of the block in bytes
+   * @return StatusCode indicating success or the error of the first byte which could not be written
+   */
+  StatusCode WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) noexcept;
+
+  /**
+   * @brief Sets the default logger callback of all machines
+   * The default is used by machines without an own callback. Set it before machines are run on
+   * other threads.
+   * @param callback The callback or nullptr to disable logging
+   * @param user_data Passed to every call of the callback
+   */
+  static void RegisterLoggerCallback(FLoggerCallback callback, void *user_data = nullptr) noexcept;
+
+  /**
+   * @brief Sets the logger callback of this machine
+   * The callback is installed on the calling thread while a method of the machine runs, so
+   * machines which run on different host threads log to different sinks. One callback can serve
+   * all machines, the user data tells it the sink of the calling machine.
+   * @param callback The callback or nullptr to use the default callback
+   * @param user_data Passed to every call of the callback
+   */
+  void SetLoggerCallback(FLoggerCallback callback, void *user_data = nullptr) noexcept {
+    logger_callback_ = callback;
+    logger_user_data_ = user_data;
+  }
+
+  /**
+   * @brief Sets the callback which receives the console output of the program
+   * Without a callback the output is printed to stdout of the host.
+   * @param callback The callback or nullptr to print to stdout
+   */
+  void SetConsoleCallback(FConsoleCallback callback) noexcept {
+    console_callback_ = std::move(callback);
+  }
+
+  /**
+   * @brief Requests the running or the next execution to stop
+   * The execution stops with kStopRequested after the current instruction. The request may be
+   * made from the step callbacks or from another host thread.
+   */
+  void RequestStop() noexcept { is_stop_requested_.store(true, std::memory_order_relaxed); }
 
   /**
    * @brief Gets the version of the library
@@ -139,8 +549,18 @@ public:
   std::string_view GetVersion() noexcept;
 
 private:
+  friend class Soc; // tracks the written RAM pages of its cores
+
   internal::Emulator<CpuStates> BuildEmulator();
-  u8 *flash_{nullptr};
+  StatusCode PrepareAccessMonitor() noexcept;
+  FLoggerCallback GetLoggerCallback() const noexcept;
+  void *GetLoggerUserData() const noexcept;
+  StatusCode PrepareLazyRamFill() noexcept;
+  void ReleasePageFlags() noexcept;
+  void PrepareLoad() noexcept;
+  StatusCode FinishLoad(u32 entry_point, bool set_entry_point) noexcept;
+  const u8 *flash_{nullptr};
+  u8 *writable_flash_{nullptr}; ///< nullptr if the flash is borrowed from a FirmwareImage
   me_size_t flash_size_{0U};
   me_adr_t flash_vadr_{0x0U};
 
@@ -152,6 +572,31 @@ private:
   me_size_t ram2_size_{0U};
   me_adr_t ram2_vadr_{0x0U};
 
+  bool is_ram1_external_{false};
+  bool is_ram2_external_{false};
+
+  std::unique_ptr<internal::SparsePageStore> sparse_;
+  std::unique_ptr<internal::PluginRegistry> plugins_;
+  std::unique_ptr<internal::AccessMonitor> monitor_;
+  std::unique_ptr<internal::EdgeCoverage> coverage_;
+  std::unique_ptr<internal::IrqInjector> irqs_;
+
+  std::unique_ptr<internal::PageFlagTable> ram1_page_flags_;
+  std::unique_ptr<internal::PageFlagTable> ram2_page_flags_;
+  std::unique_ptr<internal::SnapshotStore> snapshots_;
+
+  bool lazy_ram_fill_{false};
+  bool has_lazy_ram_{false};
+
+  BusStatistics bus_stats_{};
+  FLoggerCallback logger_callback_{nullptr};
+  void *logger_user_data_{nullptr};
+  FConsoleCallback console_callback_{nullptr};
+  std::atomic<bool> is_stop_requested_{false};
+
+  bool has_golden_state_{false};
+  u32 golden_snapshot_id_{0U};
+
   CpuStates cpu_states_{};
 };
 
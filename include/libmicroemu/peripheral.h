@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Contains the interfaces for peripherals which are attached to the machine at runtime.
+ */
+#pragma once
+
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+
+namespace libmicroemu {
+
+/// @brief Wake-up time of a peripheral which does not want to be woken up
+static constexpr u64 kNoWakeUp = UINT64_MAX;
+
+/** @brief Gives a peripheral access to the machine while one of its handlers is called.
+ *
+ * The context is only valid for the duration of the handler call.
+ */
+class IPeripheralContext {
+public:
+  /**
+   * @brief Gets the virtual time of the machine.
+   * The virtual time counts the instructions executed since the last reset.
+   * @return The virtual time.
+   */
+  virtual u64 GetTime() const noexcept = 0;
+
+  /**
+   * @brief Schedules the next wake-up of the peripheral.
+   * The tick handler of the peripheral is called once the virtual time reaches the given time.
+   * A previously scheduled wake-up is replaced.
+   * @param time The virtual time of the wake-up or kNoWakeUp to cancel the wake-up.
+   */
+  virtual void ScheduleWakeUp(u64 time) noexcept = 0;
+
+  /**
+   * @brief Sets an external interrupt pending.
+   * @param irq The number of the external interrupt, starting at 0.
+   * @return StatusCode indicating success or kOutOfRange if the interrupt does not exist.
+   */
+  virtual StatusCode SetIrqPending(u32 irq) noexcept = 0;
+
+  /**
+   * @brief Reads a value from the guest address space like a bus master.
+   * Accesses are not checked by the MPU of the processor. Only the contexts of the reset and tick
+   * handlers access the memory, the contexts of the read and write handlers return kUnsuporrted.
+   * @param vadr The virtual address.
+   * @param size The size of the access, 1, 2 or 4 bytes.
+   * @param value Receives the read value.
+   * @return StatusCode indicating success, kMemInaccesible if the address cannot be read or
+   * kUnsuporrted if the context has no memory access.
+   */
+  virtual StatusCode ReadValue(me_adr_t vadr, me_size_t size, u32 &value) noexcept {
+    static_cast<void>(vadr);
+    static_cast<void>(size);
+    static_cast<void>(value);
+    return StatusCode::kUnsuporrted;
+  }
+
+  /**
+   * @brief Writes a value to the guest address space like a bus master.
+   * @param vadr The virtual address.
+   * @param size The size of the access, 1, 2 or 4 bytes.
+   * @param value The value to write.
+   * @return StatusCode indicating success, kMemInaccesible if the address cannot be written or
+   * kUnsuporrted if the context has no memory access.
+   */
+  virtual StatusCode WriteValue(me_adr_t vadr, me_size_t size, u32 value) noexcept {
+    static_cast<void>(vadr);
+    static_cast<void>(size);
+    static_cast<void>(value);
+    return StatusCode::kUnsuporrted;
+  }
+
+  /**
+   * @brief Copies a block from the guest address space.
+   * Flash and RAM are copied with memcpy, other regions byte by byte.
+   * @param vadr The virtual start address.
+   * @param dst The destination buffer.
+   * @param size The size of the block in bytes.
+   * @return StatusCode indicating success, kMemInaccesible if a byte cannot be read or
+   * kUnsuporrted if the context has no memory access.
+   */
+  virtual StatusCode ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) noexcept {
+    static_cast<void>(vadr);
+    static_cast<void>(dst);
+    static_cast<void>(size);
+    return StatusCode::kUnsuporrted;
+  }
+
+  /**
+   * @brief Copies a block to the guest address space.
+   * @param vadr The virtual start address.
+   * @param src The source buffer.
+   * @param size The size of the block in bytes.
+   * @return StatusCode indicating success, kMemInaccesible if a byte cannot be written or
+   * kUnsuporrted if the context has no memory access.
+   */
+  virtual StatusCode WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) noexcept {
+    static_cast<void>(vadr);
+    static_cast<void>(src);
+    static_cast<void>(size);
+    return StatusCode::kUnsuporrted;
+  }
+};
+
+/** @brief Interface of a peripheral which is attached to the machine at runtime.
+ *
+ * A peripheral claims an address range of the guest address space. Each access to this range is
+ * forwarded to the read or write handler. Offsets are relative to the start of the range. Access
+ * sizes are 1, 2 or 4 bytes.
+ *
+ * Peripherals are not ticked after every instruction. Instead a peripheral schedules its next
+ * wake-up through the context and its tick handler is called when the virtual time reaches it.
+ */
+class IPeripheral {
+public:
+  virtual ~IPeripheral() = default;
+
+  /**
+   * @brief Resets the peripheral. Called whenever the machine is reset.
+   * @param ctx The peripheral context.
+   */
+  virtual void Reset(IPeripheralContext &ctx) noexcept { static_cast<void>(ctx); }
+
+  /**
+   * @brief Reads from the peripheral.
+   * @param ctx The peripheral context.
+   * @param offset The offset of the access relative to the start of the address range.
+   * @param size The size of the access in bytes.
+   * @param value Receives the read value.
+   * @return StatusCode indicating success. Any other status code raises a bus fault.
+   */
+  virtual StatusCode Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                          u32 &value) noexcept = 0;
+
+  /**
+   * @brief Writes to the peripheral.
+   * @param ctx The peripheral context.
+   * @param offset The offset of the access relative to the start of the address range.
+   * @param size The size of the access in bytes.
+   * @param value The value to write.
+   * @return StatusCode indicating success. Any other status code raises a bus fault.
+   */
+  virtual StatusCode Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                           u32 value) noexcept = 0;
+
+  /**
+   * @brief Called when the scheduled wake-up time is reached.
+   * The wake-up is cleared before the call. The peripheral has to schedule a new one if it wants
+   * to be woken up again.
+   * @param ctx The peripheral context.
+   * @return StatusCode indicating success. Any other status code stops the execution.
+   */
+  virtual StatusCode Tick(IPeripheralContext &ctx) noexcept {
+    static_cast<void>(ctx);
+    return StatusCode::kSuccess;
+  }
+};
+
+} // namespace libmicroemu
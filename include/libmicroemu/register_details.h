@@ -183,6 +183,59 @@ struct CcrRegister {
   static constexpr u32 kL1CacheEnableMsk = 1U << kL1CacheEnablePos; // L1 cache enable mask
 };
 
+struct MpuRegister {
+  // MPU_TYPE - MPU Type Register
+  static constexpr u8 kTypeDRegionPos = 8U; // Number of supported data regions
+  static constexpr u32 kTypeDRegionMsk = BitMask<15U, kTypeDRegionPos>();
+
+  // MPU_CTRL - MPU Control Register
+  static constexpr u8 kCtrlEnablePos = 0U; // MPU enable bit
+  static constexpr u32 kCtrlEnableMsk = 1U << kCtrlEnablePos;
+
+  static constexpr u8 kCtrlHfNmiEnaPos = 1U; // MPU enabled during HardFault and NMI handlers
+  static constexpr u32 kCtrlHfNmiEnaMsk = 1U << kCtrlHfNmiEnaPos;
+
+  static constexpr u8 kCtrlPrivDefEnaPos = 2U; // Default memory map as privileged background
+  static constexpr u32 kCtrlPrivDefEnaMsk = 1U << kCtrlPrivDefEnaPos;
+
+  static constexpr u32 kCtrlMsk = kCtrlEnableMsk | kCtrlHfNmiEnaMsk | kCtrlPrivDefEnaMsk;
+
+  // MPU_RBAR - MPU Region Base Address Register
+  static constexpr u8 kRbarRegionPos = 0U; // Region number
+  static constexpr u32 kRbarRegionMsk = BitMask<3U, kRbarRegionPos>();
+
+  static constexpr u8 kRbarValidPos = 4U; // Region number valid bit
+  static constexpr u32 kRbarValidMsk = 1U << kRbarValidPos;
+
+  static constexpr u8 kRbarAddrPos = 5U; // Region base address
+  static constexpr u32 kRbarAddrMsk = BitMask<31U, kRbarAddrPos>();
+
+  // MPU_RASR - MPU Region Attribute and Size Register
+  static constexpr u8 kRasrEnablePos = 0U; // Region enable bit
+  static constexpr u32 kRasrEnableMsk = 1U << kRasrEnablePos;
+
+  static constexpr u8 kRasrSizePos = 1U; // Region size is 2^(SIZE+1) bytes
+  static constexpr u32 kRasrSizeMsk = BitMask<5U, kRasrSizePos>();
+
+  static constexpr u8 kRasrSrdPos = 8U; // Subregion disable bits
+  static constexpr u32 kRasrSrdMsk = BitMask<15U, kRasrSrdPos>();
+
+  static constexpr u8 kRasrAttrsPos = 16U; // TEX, S, C and B memory attributes
+  static constexpr u32 kRasrAttrsMsk = BitMask<21U, kRasrAttrsPos>();
+
+  static constexpr u8 kRasrApPos = 24U; // Access permissions
+  static constexpr u32 kRasrApMsk = BitMask<26U, kRasrApPos>();
+
+  static constexpr u8 kRasrXnPos = 28U; // Execute never bit
+  static constexpr u32 kRasrXnMsk = 1U << kRasrXnPos;
+
+  static constexpr u32 kRasrMsk =
+      kRasrEnableMsk | kRasrSizeMsk | kRasrSrdMsk | kRasrAttrsMsk | kRasrApMsk | kRasrXnMsk;
+
+  // Number of regions of the emulated MPU
+  static constexpr u32 kNoOfRegions = 8U;
+};
+
 struct ApsrRegister {
   // APSR - Application Program Status Register flags
   static constexpr u8 kNPos = 31U;   // Negative condition flag
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Contains the shared memory segment and the doorbell peripheral used for co-simulation.
+ */
+#pragma once
+
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace libmicroemu {
+
+/** @brief Notification words which are exchanged between the guest and the host.
+ *
+ * Both words are bit masks. The sender sets bits, the receiver clears the bits it handled. The
+ * words are lock-free atomics, so they can be placed in memory shared between processes.
+ */
+struct DoorbellChannel {
+  std::atomic<u32> to_host{0U};  ///< Bits rung by the guest
+  std::atomic<u32> to_guest{0U}; ///< Bits rung by the host
+
+  /**
+   * @brief Rings the guest. Called by the host.
+   * @param bits The bits to set.
+   */
+  void RingGuest(u32 bits) noexcept { to_guest.fetch_or(bits, std::memory_order_release); }
+
+  /**
+   * @brief Takes the bits rung by the guest. Called by the host.
+   * @return The bits which were set since the last call.
+   */
+  u32 TakeHostRings() noexcept { return to_host.exchange(0U, std::memory_order_acquire); }
+};
+
+static_assert(std::atomic<u32>::is_always_lock_free, "Doorbell words must be lock-free");
+static_assert(sizeof(DoorbellChannel) == 8U, "Doorbell channel layout must be two words");
+
+/** @brief Guest RAM backed by a POSIX shared memory object.
+ *
+ * The object holds the RAM bytes followed by a DoorbellChannel. A host process which maps the
+ * same object reads and writes guest buffers directly, without copying them through the
+ * emulator. The RAM is assigned to the machine as an external segment, which is never filled
+ * on a load, e.g. with Machine::SetRam2Segment(shm.GetData(), shm.GetSize(), vadr, true).
+ */
+class SharedMemory {
+public:
+  /**
+   * @brief Constructor
+   */
+  SharedMemory() noexcept = default;
+
+  /**
+   * @brief Destructor. Unmaps the memory and removes an object which was created.
+   */
+  ~SharedMemory() noexcept;
+
+  /**
+   * @brief Copy constructor for SharedMemory.
+   * @param r_src the object to be copied
+   */
+  SharedMemory(const SharedMemory &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for SharedMemory.
+   * @param r_src the object to be copied
+   */
+  SharedMemory &operator=(const SharedMemory &r_src) = delete;
+
+  /**
+   * @brief Move constructor for SharedMemory.
+   * @param r_src the object to be moved
+   */
+  SharedMemory(SharedMemory &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for SharedMemory.
+   * @param r_src the object to be moved
+   */
+  SharedMemory &operator=(SharedMemory &&r_src) = delete;
+
+  /**
+   * @brief Creates and maps a new shared memory object.
+   * The RAM is zero initialized. The object is removed again when this instance is closed.
+   * @param name Name of the object, e.g. "/microemu_ram"
+   * @param size Size of the RAM in bytes, a multiple of 4
+   * @return StatusCode indicating success, kOutOfRange if the size is invalid, kOpenFileFailed if
+   * the object cannot be created or mapped, kUnsuporrted if the host has no POSIX shared memory
+   */
+  StatusCode Create(const std::string &name, me_size_t size) noexcept;
+
+  /**
+   * @brief Maps an existing shared memory object, e.g. one created by another process.
+   * @param name Name of the object
+   * @return StatusCode indicating success, kOpenFileFailed if the object cannot be opened or
+   * mapped, kUnsuporrted if the host has no POSIX shared memory
+   */
+  StatusCode Open(const std::string &name) noexcept;
+
+  /**
+   * @brief Unmaps the memory. An object created by this instance is removed.
+   */
+  void Close() noexcept;
+
+  /**
+   * @brief Gets the RAM bytes.
+   * @return Pointer to the RAM or nullptr if nothing is mapped
+   */
+  u8 *GetData() const noexcept { return data_; }
+
+  /**
+   * @brief Gets the size of the RAM.
+   * @return Size of the RAM in bytes
+   */
+  me_size_t GetSize() const noexcept { return size_; }
+
+  /**
+   * @brief Gets the doorbell channel which follows the RAM bytes.
+   * @return Pointer to the channel or nullptr if nothing is mapped
+   */
+  DoorbellChannel *GetChannel() const noexcept;
+
+private:
+  StatusCode Map(int fd, me_size_t size) noexcept;
+
+  u8 *data_{nullptr};
+  me_size_t size_{0U};
+  std::string created_name_;
+};
+
+/// @brief Callback function called when the guest rings the host
+/// @param bits The bits rung by the guest
+using FDoorbellCallback = std::function<void(u32 bits)>;
+
+/** @brief Peripheral which exchanges notifications through a DoorbellChannel.
+ *
+ * Register map (word accesses only):
+ *   - 0x0 TO_HOST:  Writing sets the bits in the channel and calls the callback. Reads return the
+ *                   bits not yet taken by the host.
+ *   - 0x4 TO_GUEST: Reads return the bits rung by the host. Writing 1 clears a bit.
+ *
+ * The channel is polled every poll period. The interrupt is set pending as long as a bit of
+ * TO_GUEST is set.
+ */
+class Doorbell : public IPeripheral {
+public:
+  static constexpr me_offset_t kToHostOffset = 0x0U;
+  static constexpr me_offset_t kToGuestOffset = 0x4U;
+  static constexpr me_size_t kSize = 0x8U;
+
+  /**
+   * @brief Constructor
+   * @param channel The notification words, e.g. SharedMemory::GetChannel()
+   * @param irq Number of the external interrupt raised when the host rings
+   * @param poll_period Virtual time in instructions between two polls of the channel
+   * @param cb Optional callback called when the guest rings the host
+   */
+  Doorbell(DoorbellChannel &channel, u32 irq, u64 poll_period,
+           FDoorbellCallback cb = nullptr) noexcept;
+
+  void Reset(IPeripheralContext &ctx) noexcept override;
+
+  StatusCode Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                  u32 &value) noexcept override;
+
+  StatusCode Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                   u32 value) noexcept override;
+
+  StatusCode Tick(IPeripheralContext &ctx) noexcept override;
+
+private:
+  DoorbellChannel &channel_;
+  u32 irq_;
+  u64 poll_period_;
+  FDoorbellCallback cb_;
+};
+
+} // namespace libmicroemu
@@ -0,0 +1,274 @@
+/**
+ * @file
+ * @brief Contains the multi-core system on chip and the inter-core mailbox peripheral.
+ */
+#pragma once
+
+#include "libmicroemu/exec_result.h"
+#include "libmicroemu/machine.h"
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace libmicroemu {
+
+class InterCoreMailbox;
+
+/** @brief System on chip with several cores which share flash and RAM.
+ *
+ * Every core is a Machine with its own registers, exception states and runtime peripherals. The
+ * memory segments are assigned to all cores, so the cores see the same host buffers. Exclusive
+ * accesses (LDREX/STREX) use the global exclusive monitor and synchronize the cores like the
+ * global monitor of the bus. Peripherals shared between cores must be thread-safe, see
+ * InterCoreMailbox.
+ *
+ * Exec runs every core on its own host thread. By default the cores are not synchronized while
+ * they run, so the interleaving of their memory accesses depends on the host. With a quantum
+ * (SetQuantum) the run is deterministic instead: every core executes the quantum on a private
+ * copy of RAM1 and RAM2, then all cores meet at a barrier and the bytes each core changed are
+ * written to the shared RAM in core order. A core therefore sees the stores of the other cores
+ * one quantum later, and the same program produces the same result on every run. A STREX ends
+ * the quantum of its core early; the waiting STREXs are arbitrated at the barrier, see SetQuantum.
+ */
+class Soc {
+public:
+  static constexpr u32 kMaxCores = 4U;
+
+  /// Instructions executed by a core between two checks whether the SoC was stopped
+  static constexpr i64 kDefaultSlice = 10000;
+
+  /**
+   * @brief Constructor
+   * @param no_of_cores Number of cores, at most kMaxCores
+   */
+  explicit Soc(u32 no_of_cores) noexcept;
+
+  /**
+   * @brief Copy constructor for Soc.
+   * @param r_src the object to be copied
+   */
+  Soc(const Soc &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for Soc.
+   * @param r_src the object to be copied
+   */
+  Soc &operator=(const Soc &r_src) = delete;
+
+  /**
+   * @brief Move constructor for Soc.
+   * @param r_src the object to be moved
+   */
+  Soc(Soc &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for Soc.
+   * @param r_src the object to be moved
+   */
+  Soc &operator=(Soc &&r_src) = delete;
+
+  /**
+   * @brief Gets the number of cores.
+   * @return Number of cores
+   */
+  u32 GetNoOfCores() const noexcept { return no_of_cores_; }
+
+  /**
+   * @brief Gets a core, e.g. to attach peripherals or to set its logger callback.
+   * @param core Number of the core
+   * @return The machine of the core or nullptr if core is not less than GetNoOfCores()
+   */
+  Machine *GetCore(u32 core) noexcept { return (core < no_of_cores_) ? &cores_[core] : nullptr; }
+
+  /**
+   * @brief Sets the flash segment of all cores.
+   * @see Machine::SetFlashSegment
+   */
+  void SetFlashSegment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept;
+
+  /**
+   * @brief Sets the RAM1 segment of all cores.
+   * @see Machine::SetRam1Segment
+   */
+  void SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      bool is_external = false) noexcept;
+
+  /**
+   * @brief Sets the RAM2 segment of all cores.
+   * @see Machine::SetRam2Segment
+   */
+  void SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      bool is_external = false) noexcept;
+
+  /**
+   * @brief Sets the vector table a core boots from.
+   * @see Machine::SetVectorTable
+   */
+  StatusCode SetVectorTable(u32 core, me_adr_t vadr) noexcept;
+
+  /**
+   * @brief Loads an ELF file into the shared memory and resets all cores.
+   * The file is loaded by core 0. Every core then boots from its vector table. Lazy filling of
+   * the RAM (Machine::SetLazyRamFill of core 0) is completed by the load, because the RAM is
+   * shared by all cores.
+   * @param elf_file Path to the ELF file
+   * @return StatusCode indicating success or the error of the load or reset
+   */
+  StatusCode Load(const char *elf_file) noexcept;
+
+  /**
+   * @brief Resets all cores. The memory is not changed.
+   * @return StatusCode indicating success or the error of the first failing core
+   */
+  StatusCode Reset() noexcept;
+
+  /**
+   * @brief Sets the number of instructions a core executes between two checks whether the SoC
+   * was stopped. Smaller slices stop the other cores earlier at a higher overhead.
+   * @param no_of_instructions Instructions per slice, greater than 0
+   */
+  void SetSlice(i64 no_of_instructions) noexcept;
+
+  /**
+   * @brief Sets the number of instructions every core executes between two barriers.
+   * Larger quanta run more instructions in parallel, smaller quanta make the stores of a core
+   * visible to the other cores earlier. A core stops before a STREX of a tagged monitor and
+   * waits for the barrier. There a reservation is lost if another core changed the word in the
+   * quantum, and of the cores waiting for the same word the lowest one is granted the store. The
+   * STREX is executed at the start of the next quantum, so a spinlock is held by one core at a
+   * time. A run with a
+   * quantum switches the cores to private copies of the RAM, which would discard their
+   * snapshots and golden states, so it is rejected while a core holds snapshots.
+   * @param no_of_instructions Instructions per quantum, 0 runs the cores unsynchronized
+   */
+  void SetQuantum(i64 no_of_instructions) noexcept;
+
+  /**
+   * @brief Attaches the endpoints of a mailbox to all cores at the same address.
+   * With a quantum, flags raised for other cores are delivered at the next barrier.
+   * @param mailbox The mailbox, it must outlive the Soc
+   * @param vadr Address of the endpoints
+   * @return StatusCode indicating success or the error of Machine::AttachPeripheral
+   */
+  StatusCode AttachMailbox(InterCoreMailbox &mailbox, me_adr_t vadr) noexcept;
+
+  /**
+   * @brief Runs all cores in parallel until one of them terminates or fails.
+   * Core 0 runs on the calling thread, every other core on its own host thread. When a core ends,
+   * the other cores are stopped at the end of their current slice or quantum.
+   * @param max_instructions Maximum number of instructions executed by each core. -1 means
+   * infinite
+   * @return The result of the core which ended the run, or kMaxInstructionsReached if all cores
+   * reached the limit. With a quantum, the lowest core which ended in the last quantum. The
+   * number of instructions is the sum over all cores. kUnsuporrted if a quantum is set and a
+   * core holds snapshots or a golden state.
+   */
+  ExecResult Exec(i64 max_instructions = -1) noexcept;
+
+private:
+  struct PrivateRam {
+    std::unique_ptr<u8[]> ram1;
+    std::unique_ptr<u8[]> ram2;
+  };
+
+  ExecResult ExecUnsynchronized(i64 max_instructions) noexcept;
+  ExecResult ExecQuanta(i64 max_instructions) noexcept;
+  StatusCode AttachPrivateRam() noexcept;
+  void DetachPrivateRam() noexcept;
+  void ArbitrateExclusives(u32 pending_msk) noexcept;
+  bool IsWrittenByOtherCore(u32 core, me_adr_t vadr) const noexcept;
+  bool IsSameExclusive(u32 core, u32 other) const noexcept;
+  void MergeQuantum() noexcept;
+
+  std::array<Machine, kMaxCores> cores_{};
+  u32 no_of_cores_;
+  i64 slice_{kDefaultSlice};
+  i64 quantum_{0};
+  InterCoreMailbox *mailbox_{nullptr};
+
+  u8 *ram1_{nullptr};
+  me_size_t ram1_size_{0U};
+  me_adr_t ram1_vadr_{0x0U};
+  u8 *ram2_{nullptr};
+  me_size_t ram2_size_{0U};
+  me_adr_t ram2_vadr_{0x0U};
+  bool is_ram1_external_{false};
+  bool is_ram2_external_{false};
+
+  std::array<PrivateRam, kMaxCores> private_ram_{};
+  PrivateRam base_ram_{}; // content of the shared RAM at the start of the quantum
+};
+
+/** @brief Notification flags exchanged between the cores of a Soc.
+ *
+ * Every core attaches its own endpoint at the same address, see Soc::AttachMailbox.
+ *
+ * Register map of an endpoint (word accesses only):
+ *   - 0x00 FLAGS:      Flags raised for this core. Writing 1 clears a flag.
+ *   - 0x04 CORE_ID:    Number of the core which owns the endpoint (read-only).
+ *   - 0x10 + 4 * core: RAISE. Writing sets the flags of the core (write-only).
+ *
+ * The flags are lock-free atomics. Each endpoint polls the flags of its core every poll period
+ * and sets its interrupt pending as long as a flag is raised. When the Soc runs with a quantum,
+ * flags raised for another core are collected and delivered at the next barrier.
+ */
+class InterCoreMailbox {
+public:
+  static constexpr me_offset_t kFlagsOffset = 0x00U;
+  static constexpr me_offset_t kCoreIdOffset = 0x04U;
+  static constexpr me_offset_t kRaiseOffset = 0x10U;
+  static constexpr me_size_t kSize = kRaiseOffset + Soc::kMaxCores * sizeof(u32);
+
+  /**
+   * @brief Constructor
+   * @param irq Number of the external interrupt raised on a core when one of its flags is set
+   * @param poll_period Virtual time in instructions between two polls of the flags
+   */
+  InterCoreMailbox(u32 irq, u64 poll_period) noexcept;
+
+  /**
+   * @brief Gets the endpoint of a core.
+   * @param core Number of the core, less than Soc::kMaxCores
+   * @return The peripheral to attach to the core
+   */
+  IPeripheral &GetEndpoint(u32 core) noexcept { return endpoints_[core]; }
+
+  /**
+   * @brief Gets the flags raised for a core.
+   * @param core Number of the core, less than Soc::kMaxCores
+   * @return The flags
+   */
+  u32 GetFlags(u32 core) const noexcept { return flags_[core].load(std::memory_order_acquire); }
+
+private:
+  friend class Soc; // delivers the deferred flags at the barriers
+
+  void Publish() noexcept;
+
+  class Endpoint : public IPeripheral {
+  public:
+    void Reset(IPeripheralContext &ctx) noexcept override;
+    StatusCode Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                    u32 &value) noexcept override;
+    StatusCode Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                     u32 value) noexcept override;
+    StatusCode Tick(IPeripheralContext &ctx) noexcept override;
+
+    InterCoreMailbox *mailbox_{nullptr};
+    u32 core_{0U};
+  };
+
+  std::array<std::atomic<u32>, Soc::kMaxCores> flags_{};
+  std::array<std::atomic<u32>, Soc::kMaxCores> deferred_flags_{};
+  bool is_deferred_{false};
+  std::array<Endpoint, Soc::kMaxCores> endpoints_{};
+  u32 irq_;
+  u64 poll_period_;
+};
+
+static_assert(std::atomic<u32>::is_always_lock_free, "Mailbox flags must be lock-free");
+
+} // namespace libmicroemu
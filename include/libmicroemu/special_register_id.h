@@ -36,6 +36,26 @@ enum class SpecialRegisterId : u8 {
   kSysTickRvr,   ///< SYSTICK_RVR -  SysTick Reload Value Register
   kSysTickCvr,   ///< SYST_CVR - SysTick Current Value Register
   kSysTickCalib, ///< SYST_CALIB - SysTick Calibration Value Register
+  kMmfar,        ///< MemManage Fault Address Register, MMFAR
+  kMpuType,      ///< MPU_TYPE - MPU Type Register
+  kMpuCtrl,      ///< MPU_CTRL - MPU Control Register
+  kMpuRnr,       ///< MPU_RNR - MPU Region Number Register
+  kMpuRbar0,     ///< MPU_RBAR of region 0 - MPU Region Base Address Register
+  kMpuRbar1,     ///< MPU_RBAR of region 1
+  kMpuRbar2,     ///< MPU_RBAR of region 2
+  kMpuRbar3,     ///< MPU_RBAR of region 3
+  kMpuRbar4,     ///< MPU_RBAR of region 4
+  kMpuRbar5,     ///< MPU_RBAR of region 5
+  kMpuRbar6,     ///< MPU_RBAR of region 6
+  kMpuRbar7,     ///< MPU_RBAR of region 7
+  kMpuRasr0,     ///< MPU_RASR of region 0 - MPU Region Attribute and Size Register
+  kMpuRasr1,     ///< MPU_RASR of region 1
+  kMpuRasr2,     ///< MPU_RASR of region 2
+  kMpuRasr3,     ///< MPU_RASR of region 3
+  kMpuRasr4,     ///< MPU_RASR of region 4
+  kMpuRasr5,     ///< MPU_RASR of region 5
+  kMpuRasr6,     ///< MPU_RASR of region 6
+  kMpuRasr7,     ///< MPU_RASR of region 7
 
   //---------------------
   // Runtime registers
@@ -46,7 +66,7 @@ enum class SpecialRegisterId : u8 {
   kControl, ///< Control register, CONTROL
 };
 
-constexpr auto kLastPersistentSpecialRegister = SpecialRegisterId::kSysTickCalib;
+constexpr auto kLastPersistentSpecialRegister = SpecialRegisterId::kMpuRasr7;
 constexpr auto kFirstRuntimeSpecialRegister = SpecialRegisterId::kEpsr;
 constexpr auto kLastRuntimeSpecialRegister = SpecialRegisterId::kControl;
 constexpr auto kLastSpecialRegister = kLastRuntimeSpecialRegister;
@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @brief Contains the types used to configure stack guard regions.
+ */
+#pragma once
+
+#include "libmicroemu/types.h"
+
+namespace libmicroemu {
+
+/**
+ * @brief Selects the stack a guard region belongs to.
+ */
+enum class StackGuardId : u8 {
+  kMain = 0U,    ///< Guard below the main stack (MSP)
+  kProcess = 1U, ///< Guard below the process stack (PSP)
+};
+
+/// @brief Number of stack guard regions
+static constexpr u32 kNoOfStackGuards = 2U;
+
+/**
+ * @brief Selects what happens when a write hits a stack guard region.
+ */
+enum class StackGuardAction : u8 {
+  /// The write is refused and the execution stops with kStackOverflow after the instruction
+  kStop = 0U,
+
+  /// The write is refused and a precise bus fault is raised in the emulated processor
+  kFault = 1U,
+};
+
+} // namespace libmicroemu
@@ -98,6 +98,22 @@ enum class StatusCode : u32 {
 
   /** @brief Maximum instruction count reached. */
   kMaxInstructionsReached = 0x8001U,
+
+  /** @brief Execution stopped at the requested address. */
+  kStopAddressReached = 0x8002U,
+
+  /** @brief Execution stopped because a watchpoint was hit. */
+  kWatchpointHit = 0x8003U,
+
+  /** @brief Execution stopped because a write hit a stack guard region. */
+  kStackOverflow = 0x8004U,
+
+  /** @brief Execution stopped because Machine::RequestStop was called. */
+  kStopRequested = 0x8005U,
+
+  /** @brief Execution stopped before a store exclusive which waits for the arbitration of a Soc.
+   */
+  kExclusiveStorePending = 0x8006U,
 };
 
 /**
@@ -170,6 +186,21 @@ static std::string_view StatusCodeToString(const StatusCode &status_code) noexce
   case StatusCode::kMaxInstructionsReached: {
     return "MaxInstructionsReached";
   }
+  case StatusCode::kStopAddressReached: {
+    return "StopAddressReached";
+  }
+  case StatusCode::kWatchpointHit: {
+    return "WatchpointHit";
+  }
+  case StatusCode::kStackOverflow: {
+    return "StackOverflow";
+  }
+  case StatusCode::kStopRequested: {
+    return "StopRequested";
+  }
+  case StatusCode::kExclusiveStorePending: {
+    return "ExclusiveStorePending";
+  }
   default: {
     return "UnknownStatusCode";
   }
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Contains the types used to configure data watchpoints.
+ */
+#pragma once
+
+#include "libmicroemu/types.h"
+#include <functional>
+
+namespace libmicroemu {
+
+using WatchFlagsSet = u8;
+
+/**
+ * @brief Flags which select the accesses a watchpoint reacts on.
+ */
+enum class WatchFlags : WatchFlagsSet {
+  kRead = 1U << 0U,       ///< Hit on reads of the watched range
+  kWrite = 1U << 1U,      ///< Hit on writes to the watched range
+  kValueMatch = 1U << 2U, ///< Only hit if the accessed value equals the match value
+};
+
+/**
+ * @brief Describes the access which hit a watchpoint.
+ */
+struct WatchpointHit {
+  u32 id;         ///< Id of the watchpoint
+  me_adr_t vadr;  ///< Virtual address of the access
+  me_size_t size; ///< Size of the access in bytes
+  u32 value;      ///< Read or written value
+  bool is_write;  ///< True for a write access, false for a read access
+};
+
+/// @brief Callback function called when a watchpoint is hit
+/// @param hit Describes the access which hit the watchpoint
+/// @return true to stop the execution after the current instruction, false to continue
+using FWatchpointCallback = std::function<bool(const WatchpointHit &hit)>;
+
+} // namespace libmicroemu
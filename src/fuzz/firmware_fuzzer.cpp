@@ -0,0 +1,79 @@
+// libFuzzer entry points of the firmware fuzz target. See fuzz_target.h for the configuration.
+
+#include "fuzz_target.h"
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/shm.h>
+#endif
+
+namespace {
+FuzzTarget fuzz_target;
+
+constexpr size_t kCoverageMapSize = 1U << 16U; // MAP_SIZE of AFL
+
+#if defined(MICROEMU_LIBFUZZER) && defined(__linux__)
+// libFuzzer uses the counters in this section as additional coverage features
+__attribute__((used, section("__libfuzzer_extra_counters"))) uint8_t
+    extra_counters[kCoverageMapSize];
+#endif
+
+// Gets the bitmap which receives the edges of the guest code
+uint8_t *GetCoverageMap() {
+#if defined(__linux__)
+  // AFL passes its coverage map as shared memory
+  const char *shm_id = std::getenv("__AFL_SHM_ID");
+  if (shm_id != nullptr) {
+    void *map = shmat(std::atoi(shm_id), nullptr, 0);
+    if (map != reinterpret_cast<void *>(-1)) {
+      return static_cast<uint8_t *>(map);
+    }
+    std::fprintf(stderr, "WARNING: Failed to attach the shared memory of __AFL_SHM_ID\n");
+  }
+#endif
+#if defined(MICROEMU_LIBFUZZER) && defined(__linux__)
+  return extra_counters;
+#else
+  return nullptr;
+#endif
+}
+} // namespace
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  static_cast<void>(argc);
+  static_cast<void>(argv);
+
+  FuzzConfig config;
+  if (!ReadFuzzConfigFromEnv(config)) {
+    std::exit(EXIT_FAILURE);
+  }
+  const auto sc = fuzz_target.Boot(config);
+  if (sc != libmicroemu::StatusCode::kSuccess) {
+    std::fprintf(stderr, "ERROR: Failed to boot '%s' to the harness PC 0x%x: %s\n",
+                 config.elf_file.c_str(), config.harness_pc,
+                 libmicroemu::StatusCodeToString(sc).data());
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Set after booting, so the edges of the boot code are not recorded
+  uint8_t *coverage_map = GetCoverageMap();
+  if ((coverage_map != nullptr) &&
+      (fuzz_target.SetCoverageMap(coverage_map, kCoverageMapSize) !=
+       libmicroemu::StatusCode::kSuccess)) {
+    std::fprintf(stderr, "ERROR: Failed to set the coverage map\n");
+    std::exit(EXIT_FAILURE);
+  }
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (fuzz_target.RunOne(data, size) == FuzzOutcome::kCrash) {
+    // libFuzzer stores the input which aborted the process as crash
+    std::fprintf(stderr, "CRASH: %s (exit code %u)\n",
+                 libmicroemu::StatusCodeToString(fuzz_target.GetLastStatusCode()).data(),
+                 fuzz_target.GetLastExitCode());
+    std::abort();
+  }
+  return 0;
+}
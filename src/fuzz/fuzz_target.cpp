@@ -0,0 +1,133 @@
+#include "fuzz_target.h"
+#include "microemu/memory_layout.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+bool ReadEnvNumber(const char *name, uint64_t &value, bool is_required) {
+  const char *str = std::getenv(name);
+  if ((str == nullptr) || (*str == '\0')) {
+    if (is_required) {
+      std::fprintf(stderr, "ERROR: %s is not set\n", name);
+    }
+    return !is_required;
+  }
+  char *end{nullptr};
+  value = std::strtoull(str, &end, 0);
+  if (*end != '\0') {
+    std::fprintf(stderr, "ERROR: Invalid number in %s: %s\n", name, str);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+bool ReadFuzzConfigFromEnv(FuzzConfig &config) {
+  config = FuzzConfig{};
+  const char *elf_file = std::getenv("MICROEMU_FUZZ_ELF");
+  if ((elf_file == nullptr) || (*elf_file == '\0')) {
+    std::fprintf(stderr, "ERROR: MICROEMU_FUZZ_ELF is not set\n");
+    return false;
+  }
+  config.elf_file = elf_file;
+  const char *memory_config = std::getenv("MICROEMU_FUZZ_MEMORY_CONFIG");
+  if ((memory_config != nullptr) && (*memory_config != '\0')) {
+    config.memory_config = memory_config;
+  }
+
+  uint64_t harness_pc{0U};
+  uint64_t input_adr{0U};
+  uint64_t input_size{0U};
+  uint64_t instr_limit{static_cast<uint64_t>(config.instr_limit)};
+  if (!ReadEnvNumber("MICROEMU_FUZZ_HARNESS_PC", harness_pc, true) ||
+      !ReadEnvNumber("MICROEMU_FUZZ_INPUT_ADR", input_adr, true) ||
+      !ReadEnvNumber("MICROEMU_FUZZ_INPUT_SIZE", input_size, true) ||
+      !ReadEnvNumber("MICROEMU_FUZZ_INSTR_LIMIT", instr_limit, false)) {
+    return false;
+  }
+  config.harness_pc = static_cast<uint32_t>(harness_pc);
+  config.input_adr = static_cast<uint32_t>(input_adr);
+  config.input_size = static_cast<uint32_t>(input_size);
+  config.instr_limit = static_cast<int64_t>(instr_limit);
+  return true;
+}
+
+libmicroemu::StatusCode FuzzTarget::Boot(const FuzzConfig &config) {
+  return Boot(config, [&config](libmicroemu::Machine &machine, uint8_t *) {
+    return machine.Load(config.elf_file.c_str(), config.is_elf_entry_point);
+  });
+}
+
+libmicroemu::StatusCode FuzzTarget::Boot(const FuzzConfig &config, const FLoadCallback &load) {
+  config_ = config;
+  MemoryLayout layout;
+  if (!GetMemoryLayout(config_.memory_config, layout)) {
+    return libmicroemu::StatusCode::kOutOfRange;
+  }
+  flash_seg_.assign(layout.flash_size, 0U);
+  ram1_seg_.assign(layout.ram1_size, 0U);
+  ram2_seg_.assign(layout.ram2_size, 0U);
+  machine_.SetFlashSegment(flash_seg_.data(), layout.flash_size, layout.flash_vadr);
+  machine_.SetRam1Segment(ram1_seg_.data(), layout.ram1_size, layout.ram1_vadr);
+  machine_.SetRam2Segment(ram2_seg_.data(), layout.ram2_size, layout.ram2_vadr);
+  // The program output of thousands of iterations is not of interest
+  machine_.SetConsoleCallback([](const char *, libmicroemu::me_size_t) {});
+
+  auto sc = load(machine_, flash_seg_.data());
+  if (sc != libmicroemu::StatusCode::kSuccess) {
+    return sc;
+  }
+  sc = machine_.CaptureGoldenStateAt(config_.harness_pc, config_.boot_limit);
+  if (sc != libmicroemu::StatusCode::kSuccess) {
+    return sc;
+  }
+
+  // The harness returns to the address in LR at its entry
+  machine_.EvaluateState(
+      [this](libmicroemu::IRegAccessor &reg_access, libmicroemu::ISpecialRegAccessor &) {
+        return_adr_ = reg_access.ReadRegister(libmicroemu::RegisterId::kLr);
+      });
+  return libmicroemu::StatusCode::kSuccess;
+}
+
+libmicroemu::StatusCode FuzzTarget::SetCoverageMap(uint8_t *bitmap, size_t size) {
+  return machine_.SetCoverageMap(bitmap, static_cast<libmicroemu::me_size_t>(size));
+}
+
+FuzzOutcome FuzzTarget::RunOne(const uint8_t *data, size_t size) {
+  last_exit_code_ = 0U;
+  machine_.ResetCoverageLocation();
+  last_status_code_ = machine_.ResetToGoldenState();
+  if (last_status_code_ != libmicroemu::StatusCode::kSuccess) {
+    return FuzzOutcome::kCrash;
+  }
+
+  const auto len = static_cast<uint32_t>(std::min(size, static_cast<size_t>(config_.input_size)));
+  last_status_code_ = machine_.WriteMemory(config_.input_adr, data, len);
+  if (last_status_code_ != libmicroemu::StatusCode::kSuccess) {
+    return FuzzOutcome::kCrash;
+  }
+  machine_.EvaluateState(
+      [this, len](libmicroemu::IRegAccessor &reg_access, libmicroemu::ISpecialRegAccessor &) {
+        reg_access.WriteRegister(libmicroemu::RegisterId::kR0, config_.input_adr);
+        reg_access.WriteRegister(libmicroemu::RegisterId::kR1, len);
+      });
+
+  const auto res = machine_.ExecUntil(return_adr_, config_.instr_limit);
+  last_status_code_ = res.GetStatusCode();
+  last_exit_code_ = res.GetProgramExitCode();
+  if (res.IsStopAddressReached()) {
+    return FuzzOutcome::kReturned;
+  }
+  if (res.IsMaxInstructionsReached()) {
+    return FuzzOutcome::kTimeout;
+  }
+  // A program which exits successfully inside the harness is not a finding
+  if (res.IsOk() && (res.GetProgramExitCode() == EXIT_SUCCESS)) {
+    return FuzzOutcome::kReturned;
+  }
+  return FuzzOutcome::kCrash;
+}
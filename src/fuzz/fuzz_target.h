@@ -0,0 +1,85 @@
+#pragma once
+
+#include "libmicroemu/machine.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Configuration of a firmware fuzz target
+struct FuzzConfig {
+  std::string elf_file;
+  std::string memory_config{"MINIMAL"};
+  bool is_elf_entry_point{true};
+  uint32_t harness_pc{0x0U};       // entry of the function which parses the input
+  uint32_t input_adr{0x0U};        // guest buffer which receives the input
+  uint32_t input_size{0x0U};       // size of the guest buffer, longer inputs are truncated
+  int64_t boot_limit{10000000};    // instructions to reach the harness PC
+  int64_t instr_limit{100000};     // instructions per iteration
+};
+
+/**
+ * Reads the configuration from the environment:
+ *   MICROEMU_FUZZ_ELF            ELF file of the firmware (required)
+ *   MICROEMU_FUZZ_MEMORY_CONFIG  Memory configuration (NONE, STDLIB, MINIMAL), default MINIMAL
+ *   MICROEMU_FUZZ_HARNESS_PC     Address of the harness function (required)
+ *   MICROEMU_FUZZ_INPUT_ADR      Address of the guest input buffer (required)
+ *   MICROEMU_FUZZ_INPUT_SIZE     Size of the guest input buffer (required)
+ *   MICROEMU_FUZZ_INSTR_LIMIT    Instructions per iteration, default 100000
+ * Numbers are accepted in decimal or with a 0x prefix. Returns false if a value is missing or
+ * invalid.
+ */
+bool ReadFuzzConfigFromEnv(FuzzConfig &config);
+
+/// Result of a single fuzz iteration
+enum class FuzzOutcome {
+  kReturned, // the harness function returned
+  kTimeout,  // the instruction limit was reached
+  kCrash,    // the emulator reported an error or the program exited with a failure
+};
+
+/**
+ * Runs a firmware function with fuzz inputs in persistent mode.
+ *
+ * Boot loads the ELF file once, executes it up to the harness PC and captures the golden state
+ * there. Every iteration then resets the machine to the golden state, which only copies back the
+ * pages written by the previous iteration, copies the input into the guest buffer and calls the
+ * harness function as harness(input_adr, input_len). The iteration ends when the function returns
+ * to its caller, the program terminates or fails, or the instruction limit is reached. With a
+ * coverage map, the branches taken by the guest during the iterations are recorded as edges.
+ */
+class FuzzTarget {
+public:
+  /// Loads a program into the machine, whose memory segments are already set
+  using FLoadCallback =
+      std::function<libmicroemu::StatusCode(libmicroemu::Machine &machine, uint8_t *flash_seg)>;
+
+  libmicroemu::StatusCode Boot(const FuzzConfig &config);
+
+  /// Boots a program which is loaded by the callback instead of the ELF file, e.g. a raw image
+  libmicroemu::StatusCode Boot(const FuzzConfig &config, const FLoadCallback &load);
+
+  /// Records the edges of the guest code in the bitmap, see Machine::SetCoverageMap
+  libmicroemu::StatusCode SetCoverageMap(uint8_t *bitmap, size_t size);
+
+  FuzzOutcome RunOne(const uint8_t *data, size_t size);
+
+  /// Status code of the last iteration
+  libmicroemu::StatusCode GetLastStatusCode() const noexcept { return last_status_code_; }
+
+  /// Program exit code of the last iteration
+  uint32_t GetLastExitCode() const noexcept { return last_exit_code_; }
+
+  libmicroemu::Machine &GetMachine() noexcept { return machine_; }
+
+private:
+  FuzzConfig config_;
+  libmicroemu::Machine machine_;
+  std::vector<uint8_t> flash_seg_;
+  std::vector<uint8_t> ram1_seg_;
+  std::vector<uint8_t> ram2_seg_;
+  uint32_t return_adr_{0x0U};
+  libmicroemu::StatusCode last_status_code_{libmicroemu::StatusCode::kSuccess};
+  uint32_t last_exit_code_{0U};
+};
@@ -0,0 +1,30 @@
+// Replays inputs through LLVMFuzzerTestOneInput when the fuzz target is built without libFuzzer,
+// e.g. to reproduce a crash with GCC.
+//
+// usage: microemu_fuzzer <input_file> [...]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int main(int argc, char *argv[]) {
+  LLVMFuzzerInitialize(&argc, &argv);
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file.is_open()) {
+      std::fprintf(stderr, "ERROR: Failed to open input '%s'\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    const std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)),
+                                     std::istreambuf_iterator<char>());
+    std::printf("Running %s (%zu bytes)\n", argv[i], input.size());
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  return EXIT_SUCCESS;
+}
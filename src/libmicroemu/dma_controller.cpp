@@ -0,0 +1,268 @@
+#include "libmicroemu/dma_controller.h"
+
+namespace libmicroemu {
+
+static constexpr u32 kChannelFlagsMsk =
+    DmaController::kGifMsk | DmaController::kTcifMsk | DmaController::kHtifMsk |
+    DmaController::kTeifMsk;
+
+static constexpr me_size_t kNoOfChannelFlags = 4U;
+
+/// Decodes the PSIZE or MSIZE field, 0 for the reserved encoding
+static constexpr me_size_t DecodeElementSize(u32 ccr, u32 pos) noexcept {
+  const u32 enc = (ccr >> pos) & 0x3U;
+  return (enc < 3U) ? (1U << enc) : 0U;
+}
+
+DmaController::DmaController(u32 no_of_channels, u32 first_irq, u64 time_per_element) noexcept
+    : no_of_channels_(no_of_channels < kMaxChannels ? no_of_channels : kMaxChannels),
+      first_irq_(first_irq), time_per_element_(time_per_element) {}
+
+void DmaController::Reset(IPeripheralContext &ctx) noexcept {
+  isr_ = 0U;
+  channels_ = {};
+  ctx.ScheduleWakeUp(kNoWakeUp);
+}
+
+StatusCode DmaController::Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                               u32 &value) noexcept {
+  static_cast<void>(ctx);
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  if (offset == kIsrOffset) {
+    value = isr_;
+    return StatusCode::kSuccess;
+  }
+  if (offset == kIfcrOffset) {
+    value = 0U; // write-only
+    return StatusCode::kSuccess;
+  }
+
+  const u32 ch = (offset - kChannelOffset) / kChannelStride;
+  if ((offset < kChannelOffset) || (ch >= no_of_channels_)) {
+    return StatusCode::kMemInaccesible;
+  }
+  const auto &channel = channels_[ch];
+  switch ((offset - kChannelOffset) % kChannelStride) {
+  case kCcrOffset: {
+    value = channel.ccr;
+    break;
+  }
+  case kCndtrOffset: {
+    value = channel.cndtr;
+    break;
+  }
+  case kCparOffset: {
+    value = channel.cpar;
+    break;
+  }
+  case kCmarOffset: {
+    value = channel.cmar;
+    break;
+  }
+  default: {
+    value = 0U; // reserved
+    break;
+  }
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode DmaController::Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                                u32 value) noexcept {
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  if (offset == kIsrOffset) {
+    return StatusCode::kSuccess; // read-only
+  }
+  if (offset == kIfcrOffset) {
+    for (u32 ch = 0U; ch < no_of_channels_; ++ch) {
+      const u32 shift = ch * kNoOfChannelFlags;
+      if (((value >> shift) & kGifMsk) != 0U) {
+        value |= kChannelFlagsMsk << shift;
+      }
+    }
+    isr_ &= ~value;
+    return StatusCode::kSuccess;
+  }
+
+  const u32 ch = (offset - kChannelOffset) / kChannelStride;
+  if ((offset < kChannelOffset) || (ch >= no_of_channels_)) {
+    return StatusCode::kMemInaccesible;
+  }
+  auto &channel = channels_[ch];
+  const me_offset_t reg = (offset - kChannelOffset) % kChannelStride;
+  if (reg == kCcrOffset) {
+    const bool was_enabled = (channel.ccr & kCcrEnMsk) != 0U;
+    channel.ccr = value & 0x7FFFU;
+    if ((value & kCcrEnMsk) == 0U) {
+      // Disabling aborts a running transfer
+      channel.is_active = false;
+      ScheduleNext(ctx);
+    } else if (!was_enabled) {
+      Start(ctx, ch);
+    }
+    return StatusCode::kSuccess;
+  }
+
+  // The configuration registers are write protected while the channel is enabled
+  if ((channel.ccr & kCcrEnMsk) != 0U) {
+    return StatusCode::kSuccess;
+  }
+  switch (reg) {
+  case kCndtrOffset: {
+    channel.cndtr = value & 0xFFFFU;
+    break;
+  }
+  case kCparOffset: {
+    channel.cpar = value;
+    break;
+  }
+  case kCmarOffset: {
+    channel.cmar = value;
+    break;
+  }
+  default: {
+    break; // reserved
+  }
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode DmaController::Tick(IPeripheralContext &ctx) noexcept {
+  const u64 time = ctx.GetTime();
+  for (u32 ch = 0U; ch < no_of_channels_; ++ch) {
+    // Both halves are due if the wake-up came late
+    while (channels_[ch].is_active && (channels_[ch].due <= time)) {
+      Advance(ctx, ch);
+    }
+  }
+  ScheduleNext(ctx);
+  return StatusCode::kSuccess;
+}
+
+void DmaController::Start(IPeripheralContext &ctx, u32 ch) noexcept {
+  auto &channel = channels_[ch];
+  if (channel.cndtr == 0U) {
+    return; // nothing to transfer
+  }
+  channel.is_active = true;
+  channel.is_half_pending = true;
+  channel.length = channel.cndtr;
+  channel.start = ctx.GetTime();
+  // A single element completes both halves at once
+  const u32 half = channel.length / 2U;
+  channel.due = CalcDue(channel, (half > 0U) ? half : channel.length);
+  ScheduleNext(ctx);
+}
+
+u64 DmaController::CalcDue(const Channel &channel, u32 no_of_elements) const noexcept {
+  const u64 duration = static_cast<u64>(no_of_elements) * time_per_element_;
+  return channel.start + ((duration > 0U) ? duration : 1U);
+}
+
+void DmaController::Advance(IPeripheralContext &ctx, u32 ch) noexcept {
+  auto &channel = channels_[ch];
+  const u32 shift = ch * kNoOfChannelFlags;
+  const u32 half = channel.length / 2U;
+  const bool is_half = channel.is_half_pending;
+  const u32 first = is_half ? 0U : half;
+  const u32 end = is_half ? half : channel.length;
+  bool is_irq{false};
+  if (Transfer(ctx, channel, first, end - first) != StatusCode::kSuccess) {
+    isr_ |= (kGifMsk | kTeifMsk) << shift;
+    channel.ccr &= ~kCcrEnMsk;
+    channel.is_active = false;
+    is_irq = (channel.ccr & kCcrTeieMsk) != 0U;
+  } else if (is_half) {
+    isr_ |= (kGifMsk | kHtifMsk) << shift;
+    channel.cndtr = channel.length - half;
+    channel.is_half_pending = false;
+    channel.due = CalcDue(channel, channel.length);
+    is_irq = (channel.ccr & kCcrHtieMsk) != 0U;
+  } else {
+    isr_ |= (kGifMsk | kTcifMsk) << shift;
+    channel.cndtr = channel.length;
+    channel.is_active = false;
+    if ((channel.ccr & kCcrCircMsk) != 0U) {
+      // CNDTR is reloaded, the next round starts right away
+      Start(ctx, ch);
+    } else {
+      channel.cndtr = 0U;
+    }
+    is_irq = (channel.ccr & kCcrTcieMsk) != 0U;
+  }
+  if (is_irq) {
+    static_cast<void>(ctx.SetIrqPending(first_irq_ + ch));
+  }
+}
+
+StatusCode DmaController::Transfer(IPeripheralContext &ctx, const Channel &channel, u32 first,
+                                   u32 no_of_elements) noexcept {
+  const bool is_from_mem = (channel.ccr & kCcrDirMsk) != 0U;
+  const me_size_t psize = DecodeElementSize(channel.ccr, kCcrPsizePos);
+  const me_size_t msize = DecodeElementSize(channel.ccr, kCcrMsizePos);
+  const bool pinc = (channel.ccr & kCcrPincMsk) != 0U;
+  const bool minc = (channel.ccr & kCcrMincMsk) != 0U;
+  if ((psize == 0U) || (msize == 0U)) {
+    return StatusCode::kMemInaccesible;
+  }
+
+  me_adr_t src = is_from_mem ? channel.cmar : channel.cpar;
+  me_adr_t dst = is_from_mem ? channel.cpar : channel.cmar;
+  const me_size_t src_size = is_from_mem ? msize : psize;
+  const me_size_t dst_size = is_from_mem ? psize : msize;
+  const bool src_inc = is_from_mem ? minc : pinc;
+  const bool dst_inc = is_from_mem ? pinc : minc;
+  src += src_inc ? first * src_size : 0U;
+  dst += dst_inc ? first * dst_size : 0U;
+
+  if (src_inc && dst_inc && (src_size == dst_size)) {
+    // Both sides are linear buffers, copy them in chunks
+    me_size_t rest = static_cast<me_size_t>(no_of_elements) * src_size;
+    while (rest > 0U) {
+      const me_size_t len = (rest < kChunkSize) ? rest : kChunkSize;
+      auto sc = ctx.ReadMemory(src, chunk_.data(), len);
+      if (sc != StatusCode::kSuccess) {
+        return sc;
+      }
+      sc = ctx.WriteMemory(dst, chunk_.data(), len);
+      if (sc != StatusCode::kSuccess) {
+        return sc;
+      }
+      src += len;
+      dst += len;
+      rest -= len;
+    }
+    return StatusCode::kSuccess;
+  }
+
+  for (u32 i = 0U; i < no_of_elements; ++i) {
+    u32 value{0U};
+    auto sc = ctx.ReadValue(src, src_size, value);
+    if (sc != StatusCode::kSuccess) {
+      return sc;
+    }
+    sc = ctx.WriteValue(dst, dst_size, value);
+    if (sc != StatusCode::kSuccess) {
+      return sc;
+    }
+    src += src_inc ? src_size : 0U;
+    dst += dst_inc ? dst_size : 0U;
+  }
+  return StatusCode::kSuccess;
+}
+
+void DmaController::ScheduleNext(IPeripheralContext &ctx) noexcept {
+  u64 next = kNoWakeUp;
+  for (u32 ch = 0U; ch < no_of_channels_; ++ch) {
+    if (channels_[ch].is_active && (channels_[ch].due < next)) {
+      next = channels_[ch].due;
+    }
+  }
+  ctx.ScheduleWakeUp(next);
+}
+
+} // namespace libmicroemu
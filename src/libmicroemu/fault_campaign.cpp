@@ -0,0 +1,344 @@
+#include "libmicroemu/fault_campaign.h"
+#include "libmicroemu/emu_context.h"
+#include "libmicroemu/machine.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace libmicroemu {
+
+namespace {
+constexpr u64 kFnvOffsetBasis = 0xCBF29CE484222325ULL;
+constexpr u64 kFnvPrime = 0x100000001B3ULL;
+
+/// FNV-1a, continues the hash of the previous data
+u64 HashBytes(u64 hash, const u8 *data, std::size_t size) noexcept {
+  for (std::size_t i = 0U; i < size; ++i) {
+    hash ^= data[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+u64 HashWord(u64 hash, u32 word) noexcept {
+  const u8 bytes[4] = {static_cast<u8>(word), static_cast<u8>(word >> 8U),
+                       static_cast<u8>(word >> 16U), static_cast<u8>(word >> 24U)};
+  return HashBytes(hash, bytes, sizeof(bytes));
+}
+
+bool IsInSegment(me_adr_t adr, me_adr_t seg_vadr, me_size_t seg_size) noexcept {
+  return (adr >= seg_vadr) && (adr - seg_vadr < seg_size);
+}
+} // namespace
+
+const char *FaultOutcomeToString(FaultOutcome outcome) noexcept {
+  switch (outcome) {
+  case FaultOutcome::kMasked: {
+    return "Masked";
+  }
+  case FaultOutcome::kDetected: {
+    return "Detected";
+  }
+  case FaultOutcome::kSilentCorruption: {
+    return "SilentCorruption";
+  }
+  case FaultOutcome::kHang: {
+    return "Hang";
+  }
+  }
+  return "Unknown";
+}
+
+/// Machine with its own copy of the memory, runs the faulty runs of one host thread
+class FaultCampaign::Worker {
+public:
+  StatusCode Init(const FaultCampaign &campaign) noexcept {
+    campaign_ = &campaign;
+    if (!Allocate(flash_, campaign.flash_.size) || !Allocate(ram1_, campaign.ram1_.size) ||
+        !Allocate(ram2_, campaign.ram2_.size)) {
+      return StatusCode::kError;
+    }
+    machine_.SetFlashSegment(flash_.get(), campaign.flash_.size, campaign.flash_.vadr);
+    machine_.SetRam1Segment(ram1_.get(), campaign.ram1_.size, campaign.ram1_.vadr);
+    machine_.SetRam2Segment(ram2_.get(), campaign.ram2_.size, campaign.ram2_.vadr);
+    // The console output is part of the final state and must not reach the host
+    machine_.SetConsoleCallback([this](const char *buf, me_size_t len) {
+      console_hash_ = HashBytes(console_hash_, reinterpret_cast<const u8 *>(buf), len);
+    });
+    console_hash_ = kFnvOffsetBasis;
+    return campaign.setup_callback_(machine_, flash_.get());
+  }
+
+  ExecResult RunGolden(i64 max_instructions) noexcept { return machine_.Exec(max_instructions); }
+
+  /// Hash of the registers, the RAM, the console output and the exit code
+  u64 HashState(u32 exit_code) noexcept {
+    u64 hash = HashWord(console_hash_, exit_code);
+    machine_.EvaluateState([&hash](IRegAccessor &reg_access, ISpecialRegAccessor &) {
+      for (u32 reg = 0U; reg < CountRegisters(); ++reg) {
+        hash = HashWord(hash, reg_access.ReadRegister(static_cast<RegisterId>(reg)));
+      }
+    });
+    hash = HashBytes(hash, ram1_.get(), campaign_->ram1_.size);
+    return HashBytes(hash, ram2_.get(), campaign_->ram2_.size);
+  }
+
+  /// Takes the snapshot of the first injection point at reset
+  StatusCode Prepare() noexcept {
+    cursor_pos_ = 0U;
+    cursor_console_hash_ = console_hash_;
+    const auto sc = machine_.TakeSnapshot(reset_id_);
+    cursor_id_ = reset_id_;
+    return sc;
+  }
+
+  StatusCode Inject(const Fault &fault, FaultResult &result) noexcept {
+    if (fault.instruction != cursor_pos_) {
+      const auto sc = Advance(fault.instruction);
+      if (sc != StatusCode::kSuccess) {
+        return sc;
+      }
+    }
+
+    u8 *flash_byte{nullptr};
+    if (fault.location == FaultLocation::kRegister) {
+      machine_.EvaluateState([&fault](IRegAccessor &reg_access, ISpecialRegAccessor &) {
+        const auto value = reg_access.ReadRegister(fault.reg_id);
+        reg_access.WriteRegister(fault.reg_id, value ^ (1U << fault.bit));
+      });
+    } else if (IsInSegment(fault.adr, campaign_->flash_.vadr, campaign_->flash_.size)) {
+      // The flash is not part of the snapshots, so the bit is flipped back after the run
+      flash_byte = &flash_[fault.adr - campaign_->flash_.vadr];
+      *flash_byte ^= static_cast<u8>(1U << fault.bit);
+    } else {
+      u8 value{0U};
+      auto sc = machine_.ReadMemory(fault.adr, &value, 1U);
+      if (sc == StatusCode::kSuccess) {
+        value ^= static_cast<u8>(1U << fault.bit);
+        sc = machine_.WriteMemory(fault.adr, &value, 1U);
+      }
+      if (sc != StatusCode::kSuccess) {
+        return sc;
+      }
+    }
+
+    const u64 timeout = campaign_->GetTimeout();
+    if (timeout > fault.instruction) {
+      const auto max_instructions = static_cast<i64>(timeout - fault.instruction);
+      const auto exec_res =
+          (campaign_->detection_adr_ != kNoDetectionAdr)
+              ? machine_.ExecUntil(campaign_->detection_adr_, max_instructions)
+              : machine_.Exec(max_instructions);
+      result.status_code = exec_res.GetStatusCode();
+      result.exit_code = exec_res.GetProgramExitCode();
+      result.instructions = fault.instruction + exec_res.GetNoOfInstructions();
+    } else {
+      result.status_code = StatusCode::kMaxInstructionsReached;
+      result.exit_code = 0U;
+      result.instructions = fault.instruction;
+    }
+    result.outcome = Classify(result);
+
+    if (flash_byte != nullptr) {
+      *flash_byte ^= static_cast<u8>(1U << fault.bit);
+    }
+    console_hash_ = cursor_console_hash_;
+    return machine_.RestoreSnapshot(cursor_id_);
+  }
+
+private:
+  static bool Allocate(std::unique_ptr<u8[]> &seg, me_size_t size) noexcept {
+    if (size == 0U) {
+      return true;
+    }
+    seg.reset(new (std::nothrow) u8[size]);
+    if (!seg) {
+      return false;
+    }
+    std::memset(seg.get(), 0, size);
+    return true;
+  }
+
+  /// Executes from the current injection point to the next one and takes its snapshot. The
+  /// reset snapshot is kept, every later injection point replaces the snapshot of the previous one.
+  StatusCode Advance(u64 instruction) noexcept {
+    const auto exec_res = machine_.Exec(static_cast<i64>(instruction - cursor_pos_));
+    if (!exec_res.IsMaxInstructionsReached()) {
+      // The program ended earlier than in the golden run, it does not run deterministically
+      return StatusCode::kError;
+    }
+    cursor_pos_ = instruction;
+    cursor_console_hash_ = console_hash_;
+    return (cursor_id_ == reset_id_) ? machine_.TakeSnapshot(cursor_id_)
+                                     : machine_.ReplaceNewestSnapshot(cursor_id_);
+  }
+
+  FaultOutcome Classify(const FaultResult &result) noexcept {
+    if (result.status_code == StatusCode::kMaxInstructionsReached) {
+      return FaultOutcome::kHang;
+    }
+    if ((result.status_code != StatusCode::kSuccess) ||
+        (result.exit_code != campaign_->golden_exit_code_)) {
+      return FaultOutcome::kDetected;
+    }
+    return (HashState(result.exit_code) == campaign_->golden_hash_)
+               ? FaultOutcome::kMasked
+               : FaultOutcome::kSilentCorruption;
+  }
+
+  const FaultCampaign *campaign_{nullptr};
+  Machine machine_{};
+  std::unique_ptr<u8[]> flash_;
+  std::unique_ptr<u8[]> ram1_;
+  std::unique_ptr<u8[]> ram2_;
+  u64 console_hash_{kFnvOffsetBasis};
+
+  u32 reset_id_{0U};
+  u32 cursor_id_{0U};
+  u64 cursor_pos_{0U};
+  u64 cursor_console_hash_{kFnvOffsetBasis};
+};
+
+void FaultCampaign::SetFlashSegment(me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+  flash_ = Segment{seg_size, seg_vadr};
+  has_golden_run_ = false;
+}
+
+void FaultCampaign::SetRam1Segment(me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+  ram1_ = Segment{seg_size, seg_vadr};
+  has_golden_run_ = false;
+}
+
+void FaultCampaign::SetRam2Segment(me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+  ram2_ = Segment{seg_size, seg_vadr};
+  has_golden_run_ = false;
+}
+
+void FaultCampaign::SetSetupCallback(FFaultSetupCallback callback) noexcept {
+  setup_callback_ = std::move(callback);
+  has_golden_run_ = false;
+}
+
+void FaultCampaign::SetElfFile(const char *elf_file, bool set_entry_point) {
+  SetSetupCallback([file = std::string(elf_file), set_entry_point](Machine &machine, u8 *) {
+    return machine.Load(file.c_str(), set_entry_point);
+  });
+}
+
+StatusCode FaultCampaign::RunGolden(i64 max_instructions) noexcept {
+  has_golden_run_ = false;
+  if (!setup_callback_) {
+    return StatusCode::kUnsuporrted;
+  }
+  auto worker = std::unique_ptr<Worker>(new (std::nothrow) Worker());
+  if (!worker) {
+    return StatusCode::kError;
+  }
+  const auto sc = worker->Init(*this);
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  const auto exec_res = worker->RunGolden(max_instructions);
+  if (exec_res.IsErr()) {
+    return exec_res.GetStatusCode();
+  }
+  golden_instructions_ = exec_res.GetNoOfInstructions();
+  golden_exit_code_ = exec_res.GetProgramExitCode();
+  golden_hash_ = worker->HashState(golden_exit_code_);
+  has_golden_run_ = true;
+  return StatusCode::kSuccess;
+}
+
+bool FaultCampaign::IsValid(const Fault &fault) const noexcept {
+  if (fault.instruction >= golden_instructions_) {
+    return false;
+  }
+  if (fault.location == FaultLocation::kRegister) {
+    return (fault.bit < 32U) && (static_cast<u32>(fault.reg_id) < CountRegisters());
+  }
+  return (fault.bit < 8U) && (IsInSegment(fault.adr, flash_.vadr, flash_.size) ||
+                              IsInSegment(fault.adr, ram1_.vadr, ram1_.size) ||
+                              IsInSegment(fault.adr, ram2_.vadr, ram2_.size));
+}
+
+u64 FaultCampaign::GetTimeout() const noexcept {
+  return (timeout_ != 0U) ? timeout_ : 2U * golden_instructions_;
+}
+
+StatusCode FaultCampaign::Run(const Fault *faults, u32 no_of_faults, FaultResult *results,
+                              u32 no_of_threads) noexcept {
+  if (!has_golden_run_) {
+    return StatusCode::kUnsuporrted;
+  }
+  for (u32 i = 0U; i < no_of_faults; ++i) {
+    if (!IsValid(faults[i])) {
+      return StatusCode::kOutOfRange;
+    }
+  }
+  if (no_of_faults == 0U) {
+    return StatusCode::kSuccess;
+  }
+
+  // Faults are processed in the order of their injection time, so every worker only moves
+  // forward between two injection points
+  auto order = std::unique_ptr<u32[]>(new (std::nothrow) u32[no_of_faults]);
+  if (!order) {
+    return StatusCode::kError;
+  }
+  for (u32 i = 0U; i < no_of_faults; ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.get(), order.get() + no_of_faults, [faults](u32 lhs, u32 rhs) {
+    return faults[lhs].instruction < faults[rhs].instruction;
+  });
+
+  if (no_of_threads == 0U) {
+    no_of_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  no_of_threads = std::min(no_of_threads, no_of_faults);
+  auto workers = std::unique_ptr<Worker[]>(new (std::nothrow) Worker[no_of_threads]);
+  auto threads = std::unique_ptr<std::thread[]>(new (std::nothrow) std::thread[no_of_threads]);
+  if (!workers || !threads) {
+    return StatusCode::kError;
+  }
+
+  // Chunks keep the injection points of a worker close together
+  constexpr u32 kChunkSize = 16U;
+  std::atomic<u32> next_fault{0U};
+  std::atomic<StatusCode> campaign_sc{StatusCode::kSuccess};
+  auto run_worker = [&](u32 thread_no) {
+    auto &worker = workers[thread_no];
+    auto sc = worker.Init(*this);
+    if (sc == StatusCode::kSuccess) {
+      sc = worker.Prepare();
+    }
+    while (sc == StatusCode::kSuccess) {
+      const u32 first = next_fault.fetch_add(kChunkSize, std::memory_order_relaxed);
+      if ((first >= no_of_faults) ||
+          (campaign_sc.load(std::memory_order_relaxed) != StatusCode::kSuccess)) {
+        return;
+      }
+      const u32 last = std::min(first + kChunkSize, no_of_faults);
+      for (u32 i = first; (i < last) && (sc == StatusCode::kSuccess); ++i) {
+        sc = worker.Inject(faults[order[i]], results[order[i]]);
+      }
+    }
+    auto no_error = StatusCode::kSuccess;
+    campaign_sc.compare_exchange_strong(no_error, sc, std::memory_order_relaxed);
+  };
+
+  for (u32 thread_no = 1U; thread_no < no_of_threads; ++thread_no) {
+    threads[thread_no] = std::thread(run_worker, thread_no);
+  }
+  run_worker(0U);
+  for (u32 thread_no = 1U; thread_no < no_of_threads; ++thread_no) {
+    threads[thread_no].join();
+  }
+  return campaign_sc.load(std::memory_order_relaxed);
+}
+
+} // namespace libmicroemu
@@ -0,0 +1,111 @@
+#include "libmicroemu/firmware_image.h"
+#include "libmicroemu/internal/elf/elf_reader.h"
+#include <fstream>
+#include <new>
+
+namespace libmicroemu {
+
+using namespace internal;
+
+namespace {
+enum class Placement : u8 { kNone, kFlash, kSegment };
+
+bool IsCode(const Elf32_Phdr &phdr) noexcept {
+  const auto flags = phdr.p_flags;
+  return ((flags & PF_X) != 0U) && ((flags & PF_R) != 0U) && ((flags & PF_W) == 0U);
+}
+
+bool IsData(const Elf32_Phdr &phdr) noexcept {
+  const auto flags = phdr.p_flags;
+  return ((flags & PF_X) == 0U) && ((flags & PF_R) != 0U) && ((flags & PF_W) != 0U);
+}
+
+// Same placement as Machine::Load(const char *, bool)
+Placement GetPlacement(const Elf32_Phdr &phdr, me_adr_t flash_vadr,
+                       me_size_t flash_size) noexcept {
+  if (IsCode(phdr)) {
+    const bool is_in_flash = (phdr.p_vaddr >= flash_vadr) &&
+                             (phdr.p_vaddr + phdr.p_filesz < flash_vadr + flash_size);
+    return is_in_flash ? Placement::kFlash : Placement::kSegment;
+  }
+  return IsData(phdr) ? Placement::kSegment : Placement::kNone;
+}
+} // namespace
+
+StatusCode FirmwareImage::Load(const char *elf_file, me_size_t flash_size,
+                               me_adr_t flash_vadr) noexcept {
+  is_loaded_ = false;
+  segments_.reset();
+  no_of_segments_ = 0U;
+  flash_.reset(new (std::nothrow) u8[flash_size]());
+  if (!flash_) {
+    return StatusCode::kError;
+  }
+  flash_size_ = flash_size;
+  flash_vadr_ = flash_vadr;
+
+  auto file = std::ifstream(elf_file, std::ios::binary);
+  if (!file.is_open()) {
+    // Failed to open file
+    return StatusCode::kOpenFileFailed;
+  }
+  auto res_reader = ElfReader::ReadElf(file);
+  if (res_reader.IsErr()) {
+    return res_reader.status_code;
+  };
+  auto reader = res_reader.content;
+
+  // Count the segments which are not part of the flash buffer first, so they are allocated once
+  u32 no_of_segments{0U};
+  for (auto it = reader.begin(); it != reader.end(); ++it) {
+    if (GetPlacement(*it, flash_vadr, flash_size) == Placement::kSegment) {
+      ++no_of_segments;
+    }
+  }
+  if (no_of_segments > 0U) {
+    segments_.reset(new (std::nothrow) Segment[no_of_segments]);
+    if (!segments_) {
+      return StatusCode::kError;
+    }
+  }
+
+  for (auto it = reader.begin(); it != reader.end(); ++it) {
+    const auto &phdr = *it;
+    const auto placement = GetPlacement(phdr, flash_vadr, flash_size);
+    if (placement == Placement::kNone) {
+      continue;
+    }
+
+    if (placement == Placement::kFlash) {
+      auto res = reader.GetSegmentData(phdr, flash_.get(), phdr.p_filesz, 0x0, 0x0);
+      if (res.IsErr()) {
+        return res.status_code;
+      }
+      continue;
+    }
+
+    // Copied to the RAM or the sparse memory of every machine which loads the image. A corrupt
+    // size fails the allocation instead of aborting.
+    auto &segment = segments_[no_of_segments_];
+    segment.vadr = static_cast<me_adr_t>(phdr.p_vaddr);
+    segment.is_code = IsCode(phdr);
+    segment.size = static_cast<me_size_t>(phdr.p_filesz);
+    if (segment.size > 0U) {
+      segment.data.reset(new (std::nothrow) u8[segment.size]);
+      if (!segment.data) {
+        return StatusCode::kError;
+      }
+    }
+    ++no_of_segments_;
+    auto res = reader.GetSegmentData(phdr, segment.data.get(), phdr.p_filesz, 0x0, 0x0);
+    if (res.IsErr()) {
+      return res.status_code;
+    }
+  }
+
+  entry_point_ = reader.GetEntryPoint();
+  is_loaded_ = true;
+  return StatusCode::kSuccess;
+}
+
+} // namespace libmicroemu
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "libmicroemu/exception_type.h"
+#include "libmicroemu/internal/bus/access_page_table.h"
+#include "libmicroemu/internal/bus/mpu.h"
+#include "libmicroemu/internal/logic/predicates.h"
+#include "libmicroemu/register_details.h"
+#include "libmicroemu/stack_guard.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include "libmicroemu/watchpoint.h"
+#include <array>
+#include <utility>
+
+namespace libmicroemu::internal {
+
+enum class AccessAction {
+  kAllow = 0U, // Perform the access
+  kDeny = 1U,  // Refuse the access, the bus reports it as inaccessible
+};
+
+/**
+ * @brief Checks the bus accesses to flagged pages.
+ *
+ * The monitor implements data watchpoints, stack guard regions and the permission checks of the
+ * MPU. The bus consults the page table of the monitor for every access. Only accesses which touch a
+ * flagged page are handed to the monitor, which performs the exact checks against the configured
+ * ranges. If a check requests the execution to stop, the stop is recorded and picked up by the run
+ * loop after the current instruction completed.
+ */
+class AccessMonitor {
+public:
+  static constexpr u32 kMaxWatchpoints = 16U;
+
+  /**
+   * @brief Constructor
+   */
+  AccessMonitor() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~AccessMonitor() noexcept = default;
+
+  /**
+   * @brief Copy constructor for AccessMonitor.
+   * @param r_src the object to be copied
+   */
+  AccessMonitor(const AccessMonitor &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for AccessMonitor.
+   * @param r_src the object to be copied
+   */
+  AccessMonitor &operator=(const AccessMonitor &r_src) = delete;
+
+  /**
+   * @brief Move constructor for AccessMonitor.
+   * @param r_src the object to be moved
+   */
+  AccessMonitor(AccessMonitor &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for AccessMonitor.
+   * @param r_src the object to be moved
+   */
+  AccessMonitor &operator=(AccessMonitor &&r_src) = delete;
+
+  /**
+   * @brief Checks if an access touches a flagged page.
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes
+   * @return true if the access must be handed to the monitor
+   */
+  inline bool IsMonitored(me_adr_t vadr, me_size_t size) const noexcept {
+    return page_table_.GetFlags(vadr, size) != 0U;
+  }
+
+  /**
+   * @brief Gets the combined flags of all pages touched by an access.
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes
+   * @return the flags, zero if the access is not monitored
+   */
+  inline AccessFlagsSet GetFlags(me_adr_t vadr, me_size_t size) const noexcept {
+    return page_table_.GetFlags(vadr, size);
+  }
+
+  /**
+   * @brief Checks an access against the MPU permissions. Called before the access is performed.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes
+   * @param flags the flags returned by GetFlags for the access
+   * @param type the type of the access
+   * @return whether the access is allowed
+   */
+  template <typename TCpuAccessor>
+  AccessAction CheckMpu(TCpuAccessor &cpua, me_adr_t vadr, me_size_t size, AccessFlagsSet flags,
+                        MpuAccessType type) const noexcept {
+    if ((flags & static_cast<AccessFlagsSet>(AccessFlags::kMpuCheck)) != 0U) {
+      flags = mpu_.Lookup(vadr) | mpu_.Lookup(vadr + (size - 1U));
+    }
+    const bool is_privileged = Predicates::IsCurrentModePrivileged(cpua);
+    if ((flags & Mpu::GetDenyMask(type, is_privileged)) == 0U) {
+      return AccessAction::kAllow;
+    }
+
+    // The flags are compiled lazily, so the control register is authoritative
+    const auto ctrl = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuCtrl>();
+    if ((ctrl & MpuRegister::kCtrlEnableMsk) == 0U) {
+      return AccessAction::kAllow;
+    }
+
+    // HardFault and NMI handlers bypass the MPU unless HFNMIENA is set
+    if ((ctrl & MpuRegister::kCtrlHfNmiEnaMsk) == 0U) {
+      const auto ipsr = cpua.template ReadSpecialRegister<SpecialRegisterId::kIpsr>();
+      const auto exception_number = ipsr & IpsrRegister::kExceptionNumberMsk;
+      if ((exception_number == static_cast<u32>(ExceptionType::kNMI)) ||
+          (exception_number == static_cast<u32>(ExceptionType::kHardFault))) {
+        return AccessAction::kAllow;
+      }
+    }
+    return AccessAction::kDeny;
+  }
+
+  /**
+   * @brief Compiles the MPU permissions into the page table if the MPU registers changed.
+   * @param cpua the cpu accessor
+   * @return true on success, false if no host memory is available
+   */
+  template <typename TCpuAccessor> bool SyncMpu(const TCpuAccessor &cpua) noexcept {
+    if (!mpu_.Load(cpua)) {
+      return true;
+    }
+    return RebuildPageTable();
+  }
+
+  /**
+   * @brief Checks the read watchpoints. Called after the value was read from a page flagged
+   * with AccessFlags::kWatchRead. Reads are never denied.
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes
+   * @param value the read value
+   */
+  void OnRead(me_adr_t vadr, me_size_t size, u32 value) noexcept {
+    CheckWatchpoints(vadr, size, value, false);
+  }
+
+  /**
+   * @brief Checks a write access. Called before the value is written.
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes
+   * @param value the value to write
+   * @return whether the access is allowed
+   */
+  AccessAction OnWrite(me_adr_t vadr, me_size_t size, u32 value) noexcept {
+    const auto flags = page_table_.GetFlags(vadr, size);
+    if (((flags & static_cast<AccessFlagsSet>(AccessFlags::kGuard)) != 0U) &&
+        IsInStackGuard(vadr, size)) {
+      if (stack_guard_action_ == StackGuardAction::kStop) {
+        RequestStop(StatusCode::kStackOverflow);
+      }
+      return AccessAction::kDeny;
+    }
+    if ((flags & static_cast<AccessFlagsSet>(AccessFlags::kWatchWrite)) != 0U) {
+      CheckWatchpoints(vadr, size, value, true);
+    }
+    return AccessAction::kAllow;
+  }
+
+  /**
+   * @brief Adds a watchpoint.
+   * @param vadr the virtual start address of the watched range
+   * @param size size of the watched range in bytes
+   * @param flags selects the accesses the watchpoint reacts on
+   * @param match_value the value to match if WatchFlags::kValueMatch is set
+   * @param id receives the id of the watchpoint
+   * @return kSuccess, kOutOfRange if the range is empty or wraps around, neither kRead nor kWrite
+   * is set or no more watchpoints can be added, kError if no host memory is available
+   */
+  StatusCode AddWatchpoint(me_adr_t vadr, me_size_t size, WatchFlagsSet flags, u32 match_value,
+                           u32 &id) noexcept {
+    constexpr auto kAccessMsk = static_cast<WatchFlagsSet>(WatchFlags::kRead) |
+                                static_cast<WatchFlagsSet>(WatchFlags::kWrite);
+    if ((size == 0U) || ((flags & kAccessMsk) == 0U) || (vadr + (size - 1U) < vadr)) {
+      return StatusCode::kOutOfRange;
+    }
+    for (u32 i = 0U; i < kMaxWatchpoints; ++i) {
+      auto &wp = watchpoints_[i];
+      if (wp.is_used) {
+        continue;
+      }
+      wp = Watchpoint{true, vadr, static_cast<me_adr_t>(vadr + (size - 1U)), flags, match_value};
+      if (!page_table_.SetFlags(vadr, size, ToAccessFlags(flags))) {
+        wp.is_used = false;
+        return StatusCode::kError;
+      }
+      id = i;
+      return StatusCode::kSuccess;
+    }
+    return StatusCode::kOutOfRange;
+  }
+
+  /**
+   * @brief Removes a watchpoint.
+   * @param id the id of the watchpoint
+   * @return kSuccess, kOutOfRange if the watchpoint does not exist or kError if no host memory
+   * is available
+   */
+  StatusCode RemoveWatchpoint(u32 id) noexcept {
+    if ((id >= kMaxWatchpoints) || !watchpoints_[id].is_used) {
+      return StatusCode::kOutOfRange;
+    }
+    watchpoints_[id].is_used = false;
+    return RebuildPageTable() ? StatusCode::kSuccess : StatusCode::kError;
+  }
+
+  /**
+   * @brief Removes all watchpoints.
+   */
+  void ClearWatchpoints() noexcept {
+    for (auto &wp : watchpoints_) {
+      wp.is_used = false;
+    }
+    static_cast<void>(RebuildPageTable());
+  }
+
+  /**
+   * @brief Sets the callback which is called when a watchpoint is hit.
+   * @param cb the callback or nullptr to always stop on a hit
+   */
+  void SetWatchpointCallback(FWatchpointCallback cb) noexcept { cb_watchpoint_ = std::move(cb); }
+
+  /**
+   * @brief Gets the last watchpoint hit.
+   * @param hit receives the hit
+   * @return true if a watchpoint was hit
+   */
+  bool GetLastWatchpointHit(WatchpointHit &hit) const noexcept {
+    if (!has_hit_) {
+      return false;
+    }
+    hit = last_hit_;
+    return true;
+  }
+
+  /**
+   * @brief Sets a stack guard region. Writes into the region are refused.
+   * @param id the stack the guard belongs to
+   * @param stack_limit the lowest address of the stack, the guard ends right below it
+   * @param size size of the guard region in bytes
+   * @return kSuccess, kOutOfRange if the size is zero or the region wraps around, kError if no
+   * host memory is available
+   */
+  StatusCode SetStackGuard(StackGuardId id, me_adr_t stack_limit, me_size_t size) noexcept {
+    if ((size == 0U) || (stack_limit < size)) {
+      return StatusCode::kOutOfRange;
+    }
+    auto &guard = stack_guards_[static_cast<u32>(id)];
+    guard = StackGuard{true, stack_limit - size, stack_limit - 1U};
+    if (!page_table_.SetFlags(guard.first, size,
+                              static_cast<AccessFlagsSet>(AccessFlags::kGuard))) {
+      guard.is_used = false;
+      return StatusCode::kError;
+    }
+    return StatusCode::kSuccess;
+  }
+
+  /**
+   * @brief Removes all stack guard regions.
+   */
+  void ClearStackGuards() noexcept {
+    for (auto &guard : stack_guards_) {
+      guard.is_used = false;
+    }
+    static_cast<void>(RebuildPageTable());
+  }
+
+  /**
+   * @brief Selects what happens when a write hits a stack guard region.
+   * @param action the action
+   */
+  void SetStackGuardAction(StackGuardAction action) noexcept { stack_guard_action_ = action; }
+
+  /**
+   * @brief Checks if a check requested the execution to stop.
+   * @return true if the execution must stop
+   */
+  inline bool IsStopRequested() const noexcept { return is_stop_requested_; }
+
+  /**
+   * @brief Gets the status code of the requested stop and clears the request.
+   * @return the status code the execution stops with
+   */
+  StatusCode TakeStopStatus() noexcept {
+    is_stop_requested_ = false;
+    return stop_status_;
+  }
+
+private:
+  struct Watchpoint {
+    bool is_used;
+    me_adr_t first;
+    me_adr_t last; // inclusive
+    WatchFlagsSet flags;
+    u32 match_value;
+  };
+
+  struct StackGuard {
+    bool is_used;
+    me_adr_t first;
+    me_adr_t last; // inclusive
+  };
+
+  static constexpr AccessFlagsSet ToAccessFlags(WatchFlagsSet flags) noexcept {
+    AccessFlagsSet access_flags{0U};
+    if ((flags & static_cast<WatchFlagsSet>(WatchFlags::kRead)) != 0U) {
+      access_flags |= static_cast<AccessFlagsSet>(AccessFlags::kWatchRead);
+    }
+    if ((flags & static_cast<WatchFlagsSet>(WatchFlags::kWrite)) != 0U) {
+      access_flags |= static_cast<AccessFlagsSet>(AccessFlags::kWatchWrite);
+    }
+    return access_flags;
+  }
+
+  void CheckWatchpoints(me_adr_t vadr, me_size_t size, u32 value, bool is_write) noexcept {
+    const auto access_flag = static_cast<WatchFlagsSet>(is_write ? WatchFlags::kWrite
+                                                                 : WatchFlags::kRead);
+    const me_adr_t last = vadr + (size - 1U);
+    const u32 value_msk = (size >= 4U) ? 0xFFFFFFFFU : ((1U << (size * 8U)) - 1U);
+
+    for (u32 i = 0U; i < kMaxWatchpoints; ++i) {
+      const auto &wp = watchpoints_[i];
+      if (!wp.is_used || ((wp.flags & access_flag) == 0U) || (last < wp.first) ||
+          (vadr > wp.last)) {
+        continue;
+      }
+      if (((wp.flags & static_cast<WatchFlagsSet>(WatchFlags::kValueMatch)) != 0U) &&
+          ((value & value_msk) != (wp.match_value & value_msk))) {
+        continue;
+      }
+
+      last_hit_ = WatchpointHit{i, vadr, size, value & value_msk, is_write};
+      has_hit_ = true;
+      const bool is_stop = cb_watchpoint_ ? cb_watchpoint_(last_hit_) : true;
+      if (is_stop) {
+        RequestStop(StatusCode::kWatchpointHit);
+      }
+    }
+  }
+
+  bool IsInStackGuard(me_adr_t vadr, me_size_t size) const noexcept {
+    const me_adr_t last = vadr + (size - 1U);
+    for (const auto &guard : stack_guards_) {
+      if (guard.is_used && (last >= guard.first) && (vadr <= guard.last)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void RequestStop(StatusCode status) noexcept {
+    if (!is_stop_requested_) {
+      is_stop_requested_ = true;
+      stop_status_ = status;
+    }
+  }
+
+  bool RebuildPageTable() noexcept {
+    page_table_.Release();
+    for (const auto &wp : watchpoints_) {
+      if (wp.is_used && !page_table_.SetFlags(wp.first, wp.last - wp.first + 1U,
+                                              ToAccessFlags(wp.flags))) {
+        return false;
+      }
+    }
+    for (const auto &guard : stack_guards_) {
+      if (guard.is_used &&
+          !page_table_.SetFlags(guard.first, guard.last - guard.first + 1U,
+                                static_cast<AccessFlagsSet>(AccessFlags::kGuard))) {
+        return false;
+      }
+    }
+    if (mpu_.IsPresent() &&
+        !page_table_.SetFlags(Mpu::kRegistersVadr, 1U,
+                              static_cast<AccessFlagsSet>(AccessFlags::kMpuConfig))) {
+      return false;
+    }
+    if (mpu_.IsEnabled() && !mpu_.Compile(page_table_)) {
+      return false;
+    }
+    return true;
+  }
+
+  AccessPageTable page_table_;
+
+  std::array<Watchpoint, kMaxWatchpoints> watchpoints_{};
+  FWatchpointCallback cb_watchpoint_{nullptr};
+  WatchpointHit last_hit_{};
+  bool has_hit_{false};
+
+  std::array<StackGuard, kNoOfStackGuards> stack_guards_{};
+  StackGuardAction stack_guard_action_{StackGuardAction::kStop};
+
+  Mpu mpu_;
+
+  bool is_stop_requested_{false};
+  StatusCode stop_status_{StatusCode::kSuccess};
+};
+
+} // namespace libmicroemu::internal
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "libmicroemu/types.h"
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace libmicroemu::internal {
+
+using AccessFlagsSet = u16;
+
+enum class AccessFlags : AccessFlagsSet {
+  kWatchRead = 1U << 0U,      // Page contains a read watchpoint
+  kWatchWrite = 1U << 1U,     // Page contains a write watchpoint
+  kGuard = 1U << 2U,          // Page contains a stack guard region
+  kMpuConfig = 1U << 3U,      // Page contains the MPU registers
+  kMpuCheck = 1U << 4U,       // Page is not uniformly covered by the MPU regions
+  kMpuNoPrivRead = 1U << 5U,  // MPU denies privileged reads
+  kMpuNoPrivWrite = 1U << 6U, // MPU denies privileged writes
+  kMpuNoUserRead = 1U << 7U,  // MPU denies unprivileged reads
+  kMpuNoUserWrite = 1U << 8U, // MPU denies unprivileged writes
+  kMpuNoExec = 1U << 9U,      // MPU denies instruction fetches
+};
+
+/**
+ * @brief Page table holding access flags for the complete 32-bit guest address space.
+ *
+ * The flags mark pages whose accesses must take the slow path of the bus. Pages are located
+ * through a two-level table (directory -> table). Tables are only allocated for directory entries
+ * which contain differently flagged pages. A directory entry without a table holds flags which are
+ * valid for all of its pages, so the lookup of most addresses ends at the directory.
+ */
+class AccessPageTable {
+public:
+  static constexpr u32 kPageShift = 10U;
+  static constexpr u32 kDirShift = 20U;
+  static constexpr u32 kNoOfDirEntries = 1U << (32U - kDirShift);
+  static constexpr u32 kNoOfTableEntries = 1U << (kDirShift - kPageShift);
+
+  /**
+   * @brief Constructor
+   */
+  AccessPageTable() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~AccessPageTable() noexcept { Release(); }
+
+  /**
+   * @brief Copy constructor for AccessPageTable.
+   * @param r_src the object to be copied
+   */
+  AccessPageTable(const AccessPageTable &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for AccessPageTable.
+   * @param r_src the object to be copied
+   */
+  AccessPageTable &operator=(const AccessPageTable &r_src) = delete;
+
+  /**
+   * @brief Move constructor for AccessPageTable.
+   * @param r_src the object to be moved
+   */
+  AccessPageTable(AccessPageTable &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for AccessPageTable.
+   * @param r_src the object to be moved
+   */
+  AccessPageTable &operator=(AccessPageTable &&r_src) = delete;
+
+  /**
+   * @brief Gets the flags of the page which contains the given address.
+   * @param vadr the virtual address
+   * @return the flags of the page
+   */
+  inline AccessFlagsSet GetFlags(me_adr_t vadr) const noexcept {
+    const AccessFlagsSet *table = dir_[vadr >> kDirShift];
+    if (table == nullptr) {
+      return dir_flags_[vadr >> kDirShift];
+    }
+    return table[(vadr >> kPageShift) & (kNoOfTableEntries - 1U)];
+  }
+
+  /**
+   * @brief Gets the combined flags of all pages touched by an access.
+   * @param vadr the virtual address of the access
+   * @param size the size of the access in bytes (at most one page)
+   * @return the combined flags of the first and the last page
+   */
+  inline AccessFlagsSet GetFlags(me_adr_t vadr, me_size_t size) const noexcept {
+    return GetFlags(vadr) | GetFlags(vadr + (size - 1U));
+  }
+
+  /**
+   * @brief Sets flags for all pages touched by an address range.
+   * @param vadr the virtual start address of the range
+   * @param size size of the range in bytes
+   * @param flags the flags to set
+   * @return true on success, false if no host memory is available
+   */
+  bool SetFlags(me_adr_t vadr, u64 size, AccessFlagsSet flags) noexcept {
+    if (size == 0U) {
+      return true;
+    }
+    const u64 first_page = static_cast<u64>(vadr) >> kPageShift;
+    const u64 last_page = (static_cast<u64>(vadr) + size - 1U) >> kPageShift;
+    u64 page = first_page;
+    while (page <= last_page) {
+      const auto page_vadr = static_cast<me_adr_t>(page << kPageShift);
+      const u32 dir_idx = page_vadr >> kDirShift;
+      AccessFlagsSet *&table = dir_[dir_idx];
+
+      // Directory entries which are covered completely keep their flags without a table
+      const bool is_dir_start = (page & (kNoOfTableEntries - 1U)) == 0U;
+      if ((table == nullptr) && is_dir_start && ((last_page - page) >= (kNoOfTableEntries - 1U))) {
+        dir_flags_[dir_idx] |= flags;
+        page += kNoOfTableEntries;
+        continue;
+      }
+
+      if (table == nullptr) {
+        table = new (std::nothrow) AccessFlagsSet[kNoOfTableEntries];
+        if (table == nullptr) {
+          return false;
+        }
+        std::fill(table, table + kNoOfTableEntries, dir_flags_[dir_idx]);
+      }
+      table[(page_vadr >> kPageShift) & (kNoOfTableEntries - 1U)] |= flags;
+      ++page;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Clears the flags of all pages and releases the tables.
+   */
+  void Release() noexcept {
+    for (auto &table : dir_) {
+      delete[] table;
+      table = nullptr;
+    }
+    dir_flags_.fill(0U);
+  }
+
+private:
+  std::array<AccessFlagsSet *, kNoOfDirEntries> dir_{};
+  std::array<AccessFlagsSet, kNoOfDirEntries> dir_flags_{};
+};
+
+} // namespace libmicroemu::internal
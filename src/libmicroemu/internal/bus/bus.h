@@ -1,5 +1,8 @@
 #pragma once
+#include "libmicroemu/bus_statistics.h"
 #include "libmicroemu/exception_type.h"
+#include "libmicroemu/internal/bus/access_monitor.h"
+#include "libmicroemu/internal/bus/mem/mem_traits.h"
 #include "libmicroemu/internal/bus/mem_access_results.h"
 #include "libmicroemu/internal/result.h"
 #include "libmicroemu/logger.h"
@@ -24,6 +27,7 @@ template <typename TCpuAccessor, typename TExceptionTrigger, typename TLogger,
 class Bus : public TBusParticipant... {
 public:
   using ExcTrig = TExceptionTrigger;
+  static constexpr u32 kNoOfParticipants = static_cast<u32>(sizeof...(TBusParticipant));
 
   explicit Bus(const TBusParticipant &...participant) : TBusParticipant(participant)... {}
 
@@ -56,8 +60,20 @@ public:
    */
   Bus &operator=(Bus &&r_src) = default;
 
+  /**
+   * @brief Assigns the access monitor which checks accesses to flagged pages.
+   * @param monitor the access monitor or nullptr to disable all checks
+   */
+  void SetAccessMonitor(AccessMonitor *monitor) { monitor_ = monitor; }
+
+  /**
+   * @brief Assigns the counters which are incremented for every resolved access.
+   * @param stats array with one entry per bus participant or nullptr to disable the counting
+   */
+  void SetStatistics(BusRegionStatistics *stats) { stats_ = stats; }
+
   template <typename T> Result<T> Read(TCpuAccessor &cpua, me_adr_t vadr) const {
-    auto read_result = ForwardRead<T, TBusParticipant...>(cpua, vadr);
+    auto read_result = MonitoredRead<T, false>(cpua, vadr, false);
     switch (read_result.status_code) {
     case ReadStatusCode::kOk: {
       return Ok<T>(read_result.content);
@@ -75,12 +91,19 @@ public:
 
   template <typename T>
   Result<T> ReadOrRaise(TCpuAccessor &cpua, me_adr_t vadr, BusExceptionType exc_type) const {
-    auto read_res = ForwardRead<T, TBusParticipant...>(cpua, vadr);
+    const bool is_fetch = exc_type == BusExceptionType::kRaiseInstructionBusError;
+    auto read_res = MonitoredRead<T, true>(cpua, vadr, is_fetch);
 
     if (read_res.status_code == ReadStatusCode::kOk) {
       return Ok(read_res.content);
     }
 
+    if ((exc_type != BusExceptionType::kRaiseNoException) &&
+        (read_res.status_code == ReadStatusCode::kAccessViolation)) {
+      RaiseMemManage(cpua, vadr, exc_type);
+      return Ok(read_res.content);
+    }
+
     switch (exc_type) {
     case BusExceptionType::kRaiseNoException: {
       return Ok(read_res.content); // No exception to be triggered
@@ -150,7 +173,7 @@ public:
 
   template <typename T> Result<void> Write(TCpuAccessor &cpua, me_adr_t vadr, T value) const {
 
-    auto write_res = ForwardWrite<T, TBusParticipant...>(cpua, vadr, value);
+    auto write_res = MonitoredWrite<T, false>(cpua, vadr, value);
     switch (write_res.status_code) {
     case WriteStatusCode::kOk: {
       return Ok();
@@ -166,13 +189,125 @@ public:
     // not reachable
   }
 
+  /**
+   * @brief Reads a block of memory.
+   *
+   * The block is split at the participant boundaries. Participants backed by contiguous host
+   * memory copy their part with memcpy, the sparse memory copies it page by page, all others
+   * (e.g. peripherals) are read byte by byte. Pages with read watchpoints are read byte by byte
+   * as well, so the watchpoints still trigger.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual start address
+   * @param dst the destination buffer
+   * @param size the size of the block in bytes
+   * @return Ok or the error of the first byte which could not be read
+   */
+  Result<void> ReadBlock(TCpuAccessor &cpua, me_adr_t vadr, u8 *dst, me_size_t size) const {
+    constexpr auto kMonitoredMsk = static_cast<AccessFlagsSet>(AccessFlags::kWatchRead);
+    while (size > 0U) {
+      const me_size_t step = GetBlockStep(vadr, size, kMonitoredMsk);
+      me_size_t len = (step > 0U) ? ForwardReadBlock<TBusParticipant...>(vadr, dst, step) : 0U;
+      if (len == 0U) {
+        TRY_ASSIGN(byte, void, Read<u8>(cpua, vadr));
+        *dst = byte;
+        len = 1U;
+      }
+      vadr += len;
+      dst += len;
+      size -= len;
+    }
+    return Ok();
+  }
+
+  /**
+   * @brief Writes a block of memory.
+   *
+   * The counterpart of ReadBlock. Pages with write watchpoints or stack guards are written byte by
+   * byte. Written pages are flagged dirty for the snapshots.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual start address
+   * @param src the source buffer
+   * @param size the size of the block in bytes
+   * @return Ok or the error of the first byte which could not be written
+   */
+  Result<void> WriteBlock(TCpuAccessor &cpua, me_adr_t vadr, const u8 *src,
+                          me_size_t size) const {
+    constexpr auto kMonitoredMsk =
+        static_cast<AccessFlagsSet>(static_cast<AccessFlagsSet>(AccessFlags::kWatchWrite) |
+                                    static_cast<AccessFlagsSet>(AccessFlags::kGuard));
+    while (size > 0U) {
+      const me_size_t step = GetBlockStep(vadr, size, kMonitoredMsk);
+      me_size_t len = (step > 0U) ? ForwardWriteBlock<TBusParticipant...>(vadr, src, step) : 0U;
+      if (len == 0U) {
+        TRY(void, Write<u8>(cpua, vadr, *src));
+        len = 1U;
+      }
+      vadr += len;
+      src += len;
+      size -= len;
+    }
+    return Ok();
+  }
+
   template <typename T>
   Result<void> WriteOrRaise(TCpuAccessor &cpua, me_adr_t vadr, T value,
                             BusExceptionType exc_type) const {
-    auto write_res = ForwardWrite<T, TBusParticipant...>(cpua, vadr, value);
+    auto write_res = MonitoredWrite<T, true>(cpua, vadr, value);
     if (write_res.status_code == WriteStatusCode::kOk) {
       return Ok();
     }
+    return RaiseWriteError(cpua, vadr, write_res.status_code, exc_type);
+  }
+
+  /**
+   * @brief Reserves a location for an exclusive store.
+   *
+   * Participants backed by host memory keep the reservation in the global exclusive monitor.
+   * Processors which share this memory from different host threads therefore fail an exclusive
+   * store after any store of another observer, also if it wrote back the old value.
+   * @param vadr the virtual address
+   * @return the version to be passed to StoreExclusiveOrRaise
+   */
+  u32 Reserve(me_adr_t vadr) const { return ForwardReserve<TBusParticipant...>(vadr); }
+
+  /**
+   * @brief Stores a value if the location was not written since it was reserved.
+   * @tparam T the type of the value
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address
+   * @param version the version returned by Reserve
+   * @param value the value to be stored
+   * @param exc_type the exception to be raised if the access fails
+   * @return true if the value was stored
+   */
+  template <typename T>
+  Result<bool> StoreExclusiveOrRaise(TCpuAccessor &cpua, me_adr_t vadr, u32 version, T value,
+                                     BusExceptionType exc_type) const {
+    bool is_stored{false};
+    auto write_res = MonitoredStoreExclusive<T>(cpua, vadr, version, value, is_stored);
+    if (write_res.status_code == WriteStatusCode::kOk) {
+      return Ok(is_stored);
+    }
+    TRY(bool, RaiseWriteError(cpua, vadr, write_res.status_code, exc_type));
+    return Ok(false);
+  }
+
+private:
+  /**
+   * @brief Raises the exception of a failed write.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address of the write
+   * @param status_code the status of the write
+   * @param exc_type the exception to be raised
+   * @return Ok if the exception was raised
+   */
+  Result<void> RaiseWriteError(TCpuAccessor &cpua, me_adr_t vadr, WriteStatusCode status_code,
+                               BusExceptionType exc_type) const {
+    if ((exc_type != BusExceptionType::kRaiseNoException) &&
+        (status_code == WriteStatusCode::kAccessViolation)) {
+      RaiseMemManage(cpua, vadr, exc_type);
+      return Ok();
+    }
 
     switch (exc_type) {
     case BusExceptionType::kRaiseNoException: {
@@ -238,19 +373,216 @@ public:
     return Err(StatusCode::kUnexpected);
   }
 
-private:
+  /**
+   * @brief Reads through the access monitor.
+   * @tparam T the type of the value to be read
+   * @tparam kIsMpuChecked true for accesses of the processor which are subject to the MPU
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address to be read
+   * @param is_fetch true for instruction fetches
+   * @return the result of the read operation
+   */
+  template <typename T, bool kIsMpuChecked>
+  ReadResult<T> MonitoredRead(TCpuAccessor &cpua, me_adr_t vadr, bool is_fetch) const {
+    if (monitor_ == nullptr) {
+      return ForwardRead<T, TBusParticipant...>(cpua, vadr, is_fetch);
+    }
+
+    // Only accesses to flagged pages take the slow path
+    const auto flags = monitor_->GetFlags(vadr, sizeof(T));
+    if (flags == 0U) {
+      return ForwardRead<T, TBusParticipant...>(cpua, vadr, is_fetch);
+    }
+    if constexpr (kIsMpuChecked) {
+      if (((flags & Mpu::kCheckMsk) != 0U) &&
+          (monitor_->CheckMpu(cpua, vadr, sizeof(T), flags,
+                              is_fetch ? MpuAccessType::kFetch : MpuAccessType::kRead) ==
+           AccessAction::kDeny)) {
+        return ReadResult<T>{T{}, ReadStatusCode::kAccessViolation};
+      }
+    }
+
+    auto read_res = ForwardRead<T, TBusParticipant...>(cpua, vadr, is_fetch);
+    if (((flags & static_cast<AccessFlagsSet>(AccessFlags::kWatchRead)) != 0U) && !is_fetch &&
+        (read_res.status_code == ReadStatusCode::kOk)) {
+      monitor_->OnRead(vadr, sizeof(T), read_res.content);
+    }
+    return read_res;
+  }
+
+  /**
+   * @brief Writes through the access monitor.
+   * @tparam T the type of the value to be written
+   * @tparam kIsMpuChecked true for accesses of the processor which are subject to the MPU
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address to be written
+   * @param value the value to be written
+   * @return the result of the write operation
+   */
+  template <typename T, bool kIsMpuChecked>
+  WriteResult<T> MonitoredWrite(TCpuAccessor &cpua, me_adr_t vadr, T value) const {
+    if (monitor_ == nullptr) {
+      return ForwardWrite<T, TBusParticipant...>(cpua, vadr, value);
+    }
+
+    // Only accesses to flagged pages take the slow path
+    const auto flags = monitor_->GetFlags(vadr, sizeof(T));
+    if (flags == 0U) {
+      return ForwardWrite<T, TBusParticipant...>(cpua, vadr, value);
+    }
+    if constexpr (kIsMpuChecked) {
+      if (((flags & Mpu::kCheckMsk) != 0U) &&
+          (monitor_->CheckMpu(cpua, vadr, sizeof(T), flags, MpuAccessType::kWrite) ==
+           AccessAction::kDeny)) {
+        return WriteResult<T>{WriteStatusCode::kAccessViolation};
+      }
+    }
+    if (monitor_->OnWrite(vadr, sizeof(T), value) == AccessAction::kDeny) {
+      return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+    }
+
+    const auto write_res = ForwardWrite<T, TBusParticipant...>(cpua, vadr, value);
+    if constexpr (kIsMpuChecked) {
+      if ((flags & static_cast<AccessFlagsSet>(AccessFlags::kMpuConfig)) != 0U) {
+        // The processor possibly reprogrammed the MPU
+        static_cast<void>(monitor_->SyncMpu(cpua));
+      }
+    }
+    return write_res;
+  }
+
+  /**
+   * @brief Stores exclusively through the access monitor.
+   * @tparam T the type of the value
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address
+   * @param version the version returned by Reserve
+   * @param value the value to be stored
+   * @param is_stored set to true if the value was stored
+   * @return the result of the write operation
+   */
+  template <typename T>
+  WriteResult<T> MonitoredStoreExclusive(TCpuAccessor &cpua, me_adr_t vadr, u32 version, T value,
+                                         bool &is_stored) const {
+    const auto flags =
+        (monitor_ != nullptr) ? monitor_->GetFlags(vadr, sizeof(T)) : AccessFlagsSet{0U};
+    if (flags == 0U) {
+      return ForwardStoreExclusive<T, TBusParticipant...>(cpua, vadr, version, value, is_stored);
+    }
+    if (((flags & Mpu::kCheckMsk) != 0U) &&
+        (monitor_->CheckMpu(cpua, vadr, sizeof(T), flags, MpuAccessType::kWrite) ==
+         AccessAction::kDeny)) {
+      return WriteResult<T>{WriteStatusCode::kAccessViolation};
+    }
+    if (monitor_->OnWrite(vadr, sizeof(T), value) == AccessAction::kDeny) {
+      return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+    }
+
+    const auto write_res =
+        ForwardStoreExclusive<T, TBusParticipant...>(cpua, vadr, version, value, is_stored);
+    if ((flags & static_cast<AccessFlagsSet>(AccessFlags::kMpuConfig)) != 0U) {
+      // The processor possibly reprogrammed the MPU
+      static_cast<void>(monitor_->SyncMpu(cpua));
+    }
+    return write_res;
+  }
+
+  /**
+   * @brief Gets the number of bytes of a block which may be copied without the access monitor.
+   * @param vadr the virtual start address
+   * @param size the remaining size of the block
+   * @param monitored_msk flags of pages which have to be accessed byte by byte
+   * @return the number of bytes up to the next monitored page or 0 if vadr is monitored
+   */
+  me_size_t GetBlockStep(me_adr_t vadr, me_size_t size, AccessFlagsSet monitored_msk) const {
+    if (monitor_ == nullptr) {
+      return size;
+    }
+    if ((monitor_->GetFlags(vadr, 1U) & monitored_msk) != 0U) {
+      return 0U;
+    }
+    // Stop at the end of the page, the flags of the next page may differ
+    constexpr me_size_t kPageSize = 1U << AccessPageTable::kPageShift;
+    const me_size_t page_rest = kPageSize - (vadr & (kPageSize - 1U));
+    return (size < page_rest) ? size : page_rest;
+  }
+
+  /**
+   * @brief Raises a MemManage fault for an access denied by the MPU.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address of the access
+   * @param exc_type the bus exception the access would raise, selects the fault status bit
+   */
+  void RaiseMemManage(TCpuAccessor &cpua, me_adr_t vadr, BusExceptionType exc_type) const {
+    auto cfsr = cpua.template ReadSpecialRegister<SpecialRegisterId::kCfsr>();
+    switch (exc_type) {
+    case BusExceptionType::kRaiseStkerr: {
+      cfsr |= CfsrMemManage::kStkerrMsk;
+      break;
+    }
+    case BusExceptionType::kRaiseUnstkerr: {
+      cfsr |= CfsrMemManage::kUnstkerrMsk;
+      break;
+    }
+    case BusExceptionType::kRaiseInstructionBusError: {
+      // MMFAR is not valid for instruction access violations
+      cfsr |= CfsrMemManage::kIaccViolMsk;
+      break;
+    }
+    default: {
+      cpua.template WriteSpecialRegister<SpecialRegisterId::kMmfar>(vadr);
+      cfsr |= CfsrMemManage::kMmarValidMsk;
+      cfsr |= CfsrMemManage::kDaccViolMsk;
+      break;
+    }
+    }
+    cpua.template WriteSpecialRegister<SpecialRegisterId::kCfsr>(cfsr);
+    ExcTrig::SetPending(cpua, ExceptionType::kMemoryManagementFault);
+  }
+
+  /**
+   * @brief Gets the index of a bus participant.
+   * @tparam Rest the bus participants which follow the participant
+   * @return the position of the participant on the bus
+   */
+  template <typename... Rest> static constexpr u32 GetParticipantIdx() noexcept {
+    return static_cast<u32>(sizeof...(TBusParticipant) - sizeof...(Rest) - 1U);
+  }
+
+  /**
+   * @brief Counts an access of the given width.
+   * @tparam T the type of the accessed value
+   * @param counters the counters of the access kind
+   */
+  template <typename T> static inline void CountAccess(BusAccessCounters &counters) noexcept {
+    constexpr u32 kWidthIdx = (sizeof(T) == 1U) ? 0U : ((sizeof(T) == 2U) ? 1U : 2U);
+    ++counters.accesses[kWidthIdx];
+    counters.bytes += sizeof(T);
+  }
+
   template <typename T, typename TAct, typename... Rest>
-  ReadResult<T> ForwardRead(TCpuAccessor &cpua, me_adr_t vadr) const {
+  ReadResult<T> ForwardRead(TCpuAccessor &cpua, me_adr_t vadr, bool is_fetch) const {
     if (!TAct::IsVAdrInRange(vadr)) {
-      return ForwardRead<T, Rest...>(cpua, vadr);
+      return ForwardRead<T, Rest...>(cpua, vadr, is_fetch);
+    }
+    if (stats_ != nullptr) {
+      auto &region = stats_[GetParticipantIdx<Rest...>()];
+      CountAccess<T>(is_fetch ? region.fetches : region.reads);
+    }
+    if constexpr (has_kIsAlias_v<TAct>) {
+      // Alias participants resolve the translated address through the bus
+      return TAct::template Read<T>(cpua, vadr, *this);
+    } else {
+      const auto read_result = TAct::template Read<T>(cpua, vadr);
+      return read_result;
     }
-    const auto read_result = TAct::template Read<T>(cpua, vadr);
-    return read_result;
   }
 
-  template <typename T> ReadResult<T> ForwardRead(TCpuAccessor &cpua, me_adr_t vadr) const {
+  template <typename T>
+  ReadResult<T> ForwardRead(TCpuAccessor &cpua, me_adr_t vadr, bool is_fetch) const {
     static_cast<void>(vadr);
     static_cast<void>(cpua);
+    static_cast<void>(is_fetch);
     return ReadResult<T>{T{}, ReadStatusCode::kReadNotAllowed};
   }
 
@@ -291,8 +623,16 @@ private:
     if (!TAct::IsVAdrInRange(vadr)) {
       return ForwardWrite<T, Rest...>(cpua, vadr, value);
     }
-    const auto write_res = TAct::template Write<T>(cpua, vadr, value);
-    return write_res;
+    if (stats_ != nullptr) {
+      CountAccess<T>(stats_[GetParticipantIdx<Rest...>()].writes);
+    }
+    if constexpr (has_kIsAlias_v<TAct>) {
+      // Alias participants resolve the translated address through the bus
+      return TAct::template Write<T>(cpua, vadr, value, *this);
+    } else {
+      const auto write_res = TAct::template Write<T>(cpua, vadr, value);
+      return write_res;
+    }
   }
 
   template <typename T>
@@ -302,6 +642,136 @@ private:
     static_cast<void>(cpua);
     return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
   }
+
+  template <typename TAct, typename... Rest>
+  me_size_t ForwardReadBlock(me_adr_t vadr, u8 *dst, me_size_t size) const {
+    if (!TAct::IsVAdrInRange(vadr)) {
+      return ForwardReadBlock<Rest...>(vadr, dst, size);
+    }
+    if constexpr (has_kIsContiguous_v<TAct>) {
+      const me_size_t len = TAct::ReadBlock(vadr, dst, size);
+      if (stats_ != nullptr) {
+        stats_[GetParticipantIdx<Rest...>()].reads.bytes += len;
+      }
+      return len;
+    } else if constexpr (has_kIsPaged_v<TAct>) {
+      // The block must not reach into an address mapped by another participant
+      const me_size_t unmapped = ForwardGetUnmappedLen<TBusParticipant...>(vadr, size);
+      const me_size_t len = (unmapped > 0U) ? TAct::ReadBlock(vadr, dst, unmapped) : 0U;
+      if (stats_ != nullptr) {
+        stats_[GetParticipantIdx<Rest...>()].reads.bytes += len;
+      }
+      return len;
+    } else {
+      return 0U; // not backed by host memory
+    }
+  }
+
+  template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) == 0U>>
+  me_size_t ForwardReadBlock(me_adr_t vadr, u8 *dst, me_size_t size) const {
+    static_cast<void>(vadr);
+    static_cast<void>(dst);
+    static_cast<void>(size);
+    return 0U;
+  }
+
+  template <typename TAct, typename... Rest>
+  me_size_t ForwardWriteBlock(me_adr_t vadr, const u8 *src, me_size_t size) const {
+    if (!TAct::IsVAdrInRange(vadr)) {
+      return ForwardWriteBlock<Rest...>(vadr, src, size);
+    }
+    if constexpr (has_kIsContiguous_v<TAct> && !TAct::kReadOnly) {
+      const me_size_t len = TAct::WriteBlock(vadr, src, size);
+      if (stats_ != nullptr) {
+        stats_[GetParticipantIdx<Rest...>()].writes.bytes += len;
+      }
+      return len;
+    } else if constexpr (has_kIsPaged_v<TAct>) {
+      const me_size_t unmapped = ForwardGetUnmappedLen<TBusParticipant...>(vadr, size);
+      const me_size_t len = (unmapped > 0U) ? TAct::WriteBlock(vadr, src, unmapped) : 0U;
+      if (stats_ != nullptr) {
+        stats_[GetParticipantIdx<Rest...>()].writes.bytes += len;
+      }
+      return len;
+    } else {
+      return 0U; // not backed by writable host memory
+    }
+  }
+
+  template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) == 0U>>
+  me_size_t ForwardWriteBlock(me_adr_t vadr, const u8 *src, me_size_t size) const {
+    static_cast<void>(vadr);
+    static_cast<void>(src);
+    static_cast<void>(size);
+    return 0U;
+  }
+
+  template <typename TAct, typename... Rest>
+  me_size_t ForwardGetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if constexpr (!has_kIsPaged_v<TAct>) {
+      size = TAct::GetUnmappedLen(vadr, size);
+    }
+    return ForwardGetUnmappedLen<Rest...>(vadr, size);
+  }
+
+  template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) == 0U>>
+  me_size_t ForwardGetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    static_cast<void>(vadr);
+    return size;
+  }
+
+  template <typename TAct, typename... Rest> u32 ForwardReserve(me_adr_t vadr) const {
+    if (!TAct::IsVAdrInRange(vadr)) {
+      return ForwardReserve<Rest...>(vadr);
+    }
+    if constexpr (has_kIsAtomic_v<TAct>) {
+      return TAct::Reserve(vadr);
+    } else {
+      // Memory without host atomics is not shared, so the local monitor suffices
+      return 0U;
+    }
+  }
+
+  template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) == 0U>>
+  u32 ForwardReserve(me_adr_t vadr) const {
+    static_cast<void>(vadr);
+    return 0U;
+  }
+
+  template <typename T, typename TAct, typename... Rest>
+  WriteResult<T> ForwardStoreExclusive(TCpuAccessor &cpua, me_adr_t vadr, u32 version, T value,
+                                       bool &is_stored) const {
+    if (!TAct::IsVAdrInRange(vadr)) {
+      return ForwardStoreExclusive<T, Rest...>(cpua, vadr, version, value, is_stored);
+    }
+    if constexpr (has_kIsAtomic_v<TAct>) {
+      const auto write_res =
+          TAct::template StoreExclusive<T>(cpua, vadr, version, value, is_stored);
+      if ((stats_ != nullptr) && is_stored) {
+        CountAccess<T>(stats_[GetParticipantIdx<Rest...>()].writes);
+      }
+      return write_res;
+    } else {
+      static_cast<void>(version);
+      const auto write_res = ForwardWrite<T, TAct, Rest...>(cpua, vadr, value);
+      is_stored = write_res.status_code == WriteStatusCode::kOk;
+      return write_res;
+    }
+  }
+
+  template <typename T>
+  WriteResult<T> ForwardStoreExclusive(TCpuAccessor &cpua, me_adr_t vadr, u32 version, T value,
+                                       bool &is_stored) const {
+    static_cast<void>(vadr);
+    static_cast<void>(version);
+    static_cast<void>(value);
+    static_cast<void>(cpua);
+    is_stored = false;
+    return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+  }
+
+  AccessMonitor *monitor_{nullptr};
+  BusRegionStatistics *stats_{nullptr};
 };
 
 } // namespace libmicroemu::internal
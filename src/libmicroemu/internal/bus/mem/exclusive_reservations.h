@@ -0,0 +1,206 @@
+#pragma once
+
+#include "libmicroemu/types.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Global exclusive monitor shared by all processors of the process.
+ *
+ * Reservations are tracked per granule of host memory, so processors which share a buffer from
+ * different host threads observe each other, independent of the address the buffer is mapped to.
+ * Every granule hashes to a version. LDREX records the version, every store to the granule
+ * increments it and STREX only stores if the version is still the recorded one. A STREX therefore
+ * fails after any intervening store, also if the old value was written back (ABA). An odd version
+ * marks a store in progress, which makes the check and the store of a STREX atomic.
+ *
+ * Versions are only maintained on host pages which were reserved at least once. The page flag is
+ * the only cost of a store to other pages. A store which races with the first reservation of its
+ * page is not seen by that reservation. Granules which share a version fail more STREX than
+ * needed, which the architecture permits.
+ */
+class ExclusiveReservations {
+public:
+  static constexpr u32 kGranuleShift = 3U;
+  static constexpr u32 kPageShift = 10U;
+  static constexpr u32 kNoOfVersions = 4096U;
+  static constexpr u32 kNoOfPages = 4096U;
+
+  /**
+   * @brief Serializes a store to the granules of a host location with exclusive stores.
+   * Locks nothing if the page of the location was never reserved.
+   */
+  class StoreGuard {
+  public:
+    /**
+     * @brief Constructor. Waits until no other store to the granules is in progress.
+     * @param ptr the host location
+     * @param size the size of the store in bytes, at most the size of a granule
+     */
+    StoreGuard(const u8 *ptr, me_size_t size) noexcept {
+      if (!IsReserved(ptr) && !IsReserved(ptr + size - 1U)) {
+        return;
+      }
+      first_ = GetVersionIdx(ptr);
+      last_ = GetVersionIdx(ptr + size - 1U);
+      if (last_ < first_) {
+        std::swap(first_, last_); // same locking order on all threads
+      }
+      Lock(first_);
+      if (last_ != first_) {
+        Lock(last_);
+      }
+    }
+
+    /**
+     * @brief Destructor. Publishes the store by incrementing the versions.
+     */
+    ~StoreGuard() noexcept {
+      if (first_ == kNoIdx) {
+        return;
+      }
+      if (last_ != first_) {
+        Unlock(last_);
+      }
+      Unlock(first_);
+    }
+
+    StoreGuard(const StoreGuard &r_src) = delete;
+    StoreGuard &operator=(const StoreGuard &r_src) = delete;
+    StoreGuard(StoreGuard &&r_src) = delete;
+    StoreGuard &operator=(StoreGuard &&r_src) = delete;
+
+  private:
+    static constexpr u32 kNoIdx = ~0U;
+    u32 first_{kNoIdx};
+    u32 last_{kNoIdx};
+  };
+
+  /**
+   * @brief Copies a block to host memory. Granules on reserved pages are stored one by one
+   * under a StoreGuard.
+   * @param dst the host destination
+   * @param src the source buffer
+   * @param size the size of the block in bytes
+   */
+  static void Store(u8 *dst, const u8 *src, me_size_t size) noexcept {
+    if (!IsReserved(dst, size)) {
+      std::memcpy(dst, src, size);
+      return;
+    }
+    constexpr std::uintptr_t kGranuleSize = std::uintptr_t{1U} << kGranuleShift;
+    while (size > 0U) {
+      const auto ofs = reinterpret_cast<std::uintptr_t>(dst) & (kGranuleSize - 1U);
+      const me_size_t len =
+          (size < kGranuleSize - ofs) ? size : static_cast<me_size_t>(kGranuleSize - ofs);
+      const StoreGuard guard(dst, len);
+      std::memcpy(dst, src, len);
+      dst += len;
+      src += len;
+      size -= len;
+    }
+  }
+
+  /**
+   * @brief Reserves the granule of a host location for an exclusive store.
+   * @param ptr the host location
+   * @return the version the store exclusive must find
+   */
+  static u32 Reserve(const u8 *ptr) noexcept {
+    // Stores to the page maintain the versions from now on
+    pages_[GetPageIdx(ptr)].store(true, std::memory_order_seq_cst);
+    const auto &version = versions_[GetVersionIdx(ptr)];
+    u32 value = version.load(std::memory_order_acquire);
+    while ((value & 1U) != 0U) {
+      std::this_thread::yield();
+      value = version.load(std::memory_order_acquire);
+    }
+    return value;
+  }
+
+  /**
+   * @brief Starts an exclusive store if the granule was not written since its reservation.
+   * A successful call must be followed by EndExclusiveStore after the value was stored. Only the
+   * granule of the first byte is checked, which covers word aligned stores to host buffers with
+   * at least word alignment.
+   * @param ptr the host location
+   * @param reserved_version the version returned by Reserve
+   * @return true if the store may be done
+   */
+  static bool BeginExclusiveStore(const u8 *ptr, u32 reserved_version) noexcept {
+    u32 expected = reserved_version;
+    return versions_[GetVersionIdx(ptr)].compare_exchange_strong(
+        expected, reserved_version + 1U, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Ends an exclusive store which was started by BeginExclusiveStore.
+   * @param ptr the host location
+   */
+  static void EndExclusiveStore(const u8 *ptr) noexcept { Unlock(GetVersionIdx(ptr)); }
+
+private:
+  static bool IsReserved(const u8 *ptr) noexcept {
+    return pages_[GetPageIdx(ptr)].load(std::memory_order_seq_cst);
+  }
+
+  static bool IsReserved(const u8 *ptr, me_size_t size) noexcept {
+    if (size == 0U) {
+      return false;
+    }
+    const auto first = reinterpret_cast<std::uintptr_t>(ptr) >> kPageShift;
+    const auto last = (reinterpret_cast<std::uintptr_t>(ptr) + size - 1U) >> kPageShift;
+    for (auto page = first; (page <= last) && (page - first < kNoOfPages); ++page) {
+      if (pages_[page & (kNoOfPages - 1U)].load(std::memory_order_seq_cst)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static u32 GetPageIdx(const u8 *ptr) noexcept {
+    return static_cast<u32>(reinterpret_cast<std::uintptr_t>(ptr) >> kPageShift) &
+           (kNoOfPages - 1U);
+  }
+
+  static u32 GetVersionIdx(const u8 *ptr) noexcept {
+    // Neighbouring granules are spread over different cache lines
+    const auto granule =
+        static_cast<u32>(reinterpret_cast<std::uintptr_t>(ptr) >> kGranuleShift);
+    return (granule * 0x9E3779B1U) >> (32U - kVersionBits);
+  }
+
+  static void Lock(u32 idx) noexcept {
+    auto &version = versions_[idx];
+    u32 value = version.load(std::memory_order_relaxed);
+    while (true) {
+      if (((value & 1U) == 0U) &&
+          version.compare_exchange_weak(value, value + 1U, std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return;
+      }
+      if ((value & 1U) != 0U) {
+        std::this_thread::yield();
+        value = version.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  static void Unlock(u32 idx) noexcept {
+    versions_[idx].fetch_add(1U, std::memory_order_release);
+  }
+
+  static constexpr u32 kVersionBits = 12U;
+  static_assert((1U << kVersionBits) == kNoOfVersions, "Versions must be indexed by the hash");
+
+  static inline std::array<std::atomic<u32>, kNoOfVersions> versions_{};
+  static inline std::array<std::atomic<bool>, kNoOfPages> pages_{};
+};
+
+} // namespace libmicroemu::internal
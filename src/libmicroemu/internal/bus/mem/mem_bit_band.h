@@ -0,0 +1,149 @@
+#pragma once
+
+#include "libmicroemu/internal/bus/mem_access_results.h"
+#include "libmicroemu/types.h"
+#include <type_traits>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Bit-band alias regions of the Cortex-M3/M4.
+ *
+ * Every word of an alias region maps to a single bit of the corresponding bit-band region:
+ *   bit_word_adr = alias_base + (byte_offset * 32) + (bit_number * 4)
+ * Reading an alias word returns the bit in bit 0. Writing an alias word sets or clears the bit
+ * according to bit 0 of the written value with a read-modify-write of the backing word.
+ *
+ * The participant does not hold any memory. It translates the address and forwards the access
+ * to the bus, which resolves the backing memory or peripheral. It is placed behind the memories
+ * on the bus, so accesses to them are not slowed down.
+ * @tparam Id the id of the memory
+ * @tparam TCpuAccessor the cpu accessor
+ */
+template <unsigned Id, typename TCpuAccessor> class MemBitBand {
+public:
+  static constexpr bool kReadOnly = false;
+  static constexpr bool kIsAlias = true;
+
+  static constexpr me_adr_t kSramBitBandBase = 0x20000000U;
+  static constexpr me_adr_t kSramAliasBase = 0x22000000U;
+  static constexpr me_adr_t kPeriphBitBandBase = 0x40000000U;
+  static constexpr me_adr_t kPeriphAliasBase = 0x42000000U;
+  static constexpr me_size_t kAliasSize = 0x02000000U; // 32 MiB alias for 1 MiB bit-band region
+
+  /**
+   * @brief Constructor
+   */
+  MemBitBand() = default;
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~MemBitBand() = default;
+
+  /**
+   * @brief Copy constructor for MemBitBand.
+   * @param r_src the object to be copied
+   */
+  MemBitBand(const MemBitBand &r_src) = default;
+
+  /**
+   * @brief Copy assignment operator for MemBitBand.
+   * @param r_src the object to be copied
+   */
+  MemBitBand &operator=(const MemBitBand &r_src) = default;
+
+  /**
+   * @brief Move constructor for MemBitBand.
+   * @param r_src the object to be moved
+   */
+  MemBitBand(MemBitBand &&r_src) = default;
+
+  /**
+   * @brief Move assignment operator for MemBitBand.
+   * @param r_src the object to be moved
+   */
+  MemBitBand &operator=(MemBitBand &&r_src) = default;
+
+  template <typename T, typename TBus>
+  ReadResult<T> Read(TCpuAccessor &cpua, me_adr_t vadr, const TBus &bus) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+        "Read only allows u32, u16 and u8");
+    // clang-format on
+    me_adr_t word_adr{0U};
+    u32 bit{0U};
+    Translate(vadr, word_adr, bit);
+
+    const auto read_res = bus.template Read<u32>(cpua, word_adr);
+    if (read_res.IsErr()) {
+      return ReadResult<T>{0U, ReadStatusCode::kReadNotAllowed};
+    }
+    return ReadResult<T>{static_cast<T>((read_res.content >> bit) & 0x1U), ReadStatusCode::kOk};
+  }
+
+  template <typename T, typename TBus>
+  WriteResult<T> Write(TCpuAccessor &cpua, me_adr_t vadr, T value, const TBus &bus) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+         "Write only allows u32, u16 and u8 types");
+    // clang-format on
+    me_adr_t word_adr{0U};
+    u32 bit{0U};
+    Translate(vadr, word_adr, bit);
+
+    const auto read_res = bus.template Read<u32>(cpua, word_adr);
+    if (read_res.IsErr()) {
+      return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+    }
+    u32 word = read_res.content & ~(1U << bit);
+    word |= (static_cast<u32>(value) & 0x1U) << bit;
+
+    const auto write_res = bus.template Write<u32>(cpua, word_adr, word);
+    if (write_res.IsErr()) {
+      return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+    }
+    return WriteResult<T>{WriteStatusCode::kOk};
+  }
+
+  /**
+   * @brief Gets the number of bytes from an address up to the start of the next alias region.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by the next alias region
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if (IsVAdrInRange(vadr)) {
+      return 0U;
+    }
+    const me_size_t sram_distance = kSramAliasBase - vadr;
+    const me_size_t periph_distance = kPeriphAliasBase - vadr;
+    const me_size_t distance = (sram_distance < periph_distance) ? sram_distance : periph_distance;
+    return (distance < size) ? distance : size;
+  }
+
+  bool IsVAdrInRange(me_adr_t vadr) const {
+    return ((vadr - kSramAliasBase) < kAliasSize) || ((vadr - kPeriphAliasBase) < kAliasSize);
+  }
+
+private:
+  /**
+   * @brief Translates an alias address to the backing word address and the bit within the word.
+   */
+  static inline void Translate(me_adr_t vadr, me_adr_t &word_adr, u32 &bit) {
+    const bool is_sram = (vadr - kSramAliasBase) < kAliasSize;
+    const me_adr_t alias_ofs = vadr - (is_sram ? kSramAliasBase : kPeriphAliasBase);
+    const me_adr_t byte_adr = (is_sram ? kSramBitBandBase : kPeriphBitBandBase) + (alias_ofs >> 5U);
+
+    word_adr = byte_adr & ~0x3U;
+    bit = ((byte_adr & 0x3U) << 3U) | ((alias_ofs >> 2U) & 0x7U);
+  }
+};
+
+} // namespace libmicroemu::internal
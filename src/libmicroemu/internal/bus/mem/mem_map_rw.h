@@ -6,7 +6,10 @@
 #include "libmicroemu/internal/utils/bit_manip.h"
 #include "libmicroemu/logger.h"
 #include "libmicroemu/types.h"
+#include <array>
+#include <cassert>
 #include <tuple>
+#include <utility>
 
 namespace libmicroemu::internal {
 
@@ -25,37 +28,106 @@ public:
   static constexpr auto kRegisters = TPeripheral::kRegisters;
 
   template <typename T> static ReadResult<T> ReadRegister(TCpuAccessor &cpua, me_adr_t padr) {
-    return ReadRegisterRecursive<T, decltype(kRegisters)>(padr, cpua);
+    assert(padr >= GetBeginPhysicalAddress() && padr <= GetEndPhysicalAddress());
+    return kReadTable<T>[ToSlot(padr)](padr, cpua);
   }
 
   template <typename T>
   static WriteResult<T> WriteRegister(TCpuAccessor &cpua, me_adr_t padr, T value) {
-    return WriteRegisterRecursive<T, decltype(kRegisters)>(padr, cpua, value);
+    assert(padr >= GetBeginPhysicalAddress() && padr <= GetEndPhysicalAddress());
+    return kWriteTable<T>[ToSlot(padr)](padr, cpua, value);
   }
 
 private:
-  template <typename T, typename Registers, std::size_t Index = 0U>
-  static ReadResult<T> ReadRegisterRecursive(const u32 &padr, TCpuAccessor &cpua) {
-    if constexpr (Index < std::tuple_size_v<Registers>) {
-      using TypeRegAccess = std::tuple_element_t<Index, Registers>;
-
-      auto constexpr pstart_adr = static_cast<me_adr_t>(TypeRegAccess::kAdr);
-      auto constexpr pend_adr = static_cast<me_adr_t>(pstart_adr + sizeof(u32) - 1U);
-      if (padr >= pstart_adr && padr <= pend_adr) {
-
-        const auto read_32 = TypeRegAccess::ReadRegister(cpua);
-        const me_adr_t start_byte = padr - pstart_adr;
-        T read_t = Bm32::ExtractType<T>(read_32, start_byte);
-        LOG_TRACE(TLogger, "READ: padr = 0x%X, width = %u, value = 0x%X", padr, sizeof(T), read_t);
-
-        return ReadResult<T>{read_t, ReadStatusCode::kOk};
-      } else {
-        return ReadRegisterRecursive<T, Registers, Index + 1U>(padr, cpua);
+  using Registers = std::remove_cv_t<decltype(kRegisters)>;
+  static constexpr std::size_t kNoOfRegisters = std::tuple_size_v<Registers>;
+
+  // Every register occupies one 32-bit slot of the dense dispatch tables
+  static constexpr std::size_t kNoOfSlots =
+      ((GetEndPhysicalAddress() - GetBeginPhysicalAddress()) >> 2U) + 1U;
+
+  template <typename T> using ReadFn = ReadResult<T> (*)(const u32 &padr, TCpuAccessor &cpua);
+  template <typename T>
+  using WriteFn = WriteResult<T> (*)(const u32 &padr, TCpuAccessor &cpua, T value);
+
+  static constexpr std::size_t ToSlot(me_adr_t padr) {
+    return static_cast<std::size_t>((padr - GetBeginPhysicalAddress()) >> 2U);
+  }
+
+  template <typename T> static ReadResult<T> ReadNotAllowed(const u32 &padr, TCpuAccessor &cpua) {
+    static_cast<void>(padr);
+    static_cast<void>(cpua);
+    return ReadResult<T>{0x0U, ReadStatusCode::kReadNotAllowed};
+  }
+
+  template <typename T>
+  static WriteResult<T> WriteNotAllowed(const u32 &padr, TCpuAccessor &cpua, T value) {
+    static_cast<void>(padr);
+    static_cast<void>(cpua);
+    static_cast<void>(value);
+    return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+  }
+
+  template <typename TRegAccess, typename T>
+  static ReadResult<T> PerformRead(const u32 &padr, TCpuAccessor &cpua) {
+    const auto read_32 = TRegAccess::ReadRegister(cpua);
+    const me_adr_t start_byte = padr - static_cast<me_adr_t>(TRegAccess::kAdr);
+    T read_t = Bm32::ExtractType<T>(read_32, start_byte);
+    LOG_TRACE(TLogger, "READ: padr = 0x%X, width = %u, value = 0x%X", padr, sizeof(T), read_t);
+
+    return ReadResult<T>{read_t, ReadStatusCode::kOk};
+  }
+
+  template <std::size_t... Is>
+  static constexpr bool AreRegistersValid(std::index_sequence<Is...>) {
+    constexpr std::array<me_adr_t, kNoOfRegisters> kAdrs = {
+        static_cast<me_adr_t>(std::tuple_element_t<Is, Registers>::kAdr)...};
+    std::array<bool, kNoOfSlots> is_used{};
+    for (const auto adr : kAdrs) {
+      if ((adr < GetBeginPhysicalAddress()) || (adr > GetEndPhysicalAddress()) ||
+          ((adr & 0x3U) != 0U) || is_used[ToSlot(adr)]) {
+        return false;
       }
+      is_used[ToSlot(adr)] = true;
     }
-    return ReadResult<T>{0x0U, ReadStatusCode::kReadNotAllowed};
+    return true;
+  }
+  static_assert(AreRegistersValid(std::make_index_sequence<kNoOfRegisters>{}),
+                "Registers must be word aligned, unique and within the peripheral range");
+
+  template <typename T, std::size_t... Is>
+  static constexpr std::array<ReadFn<T>, kNoOfSlots> MakeReadTable(std::index_sequence<Is...>) {
+    std::array<ReadFn<T>, kNoOfSlots> table{};
+    for (auto &fn : table) {
+      fn = &ReadNotAllowed<T>;
+    }
+    ((table[ToSlot(static_cast<me_adr_t>(std::tuple_element_t<Is, Registers>::kAdr))] =
+          &PerformRead<std::tuple_element_t<Is, Registers>, T>),
+     ...);
+    return table;
   }
 
+  template <typename T, std::size_t... Is>
+  static constexpr std::array<WriteFn<T>, kNoOfSlots> MakeWriteTable(std::index_sequence<Is...>) {
+    std::array<WriteFn<T>, kNoOfSlots> table{};
+    for (auto &fn : table) {
+      fn = &WriteNotAllowed<T>;
+    }
+    ((table[ToSlot(static_cast<me_adr_t>(std::tuple_element_t<Is, Registers>::kAdr))] =
+          &PerformWrite<std::tuple_element_t<Is, Registers>, T>),
+     ...);
+    return table;
+  }
+
+  // Dense jump tables indexed by the register slot. Unused slots refuse the access.
+  template <typename T>
+  static constexpr std::array<ReadFn<T>, kNoOfSlots> kReadTable =
+      MakeReadTable<T>(std::make_index_sequence<kNoOfRegisters>{});
+
+  template <typename T>
+  static constexpr std::array<WriteFn<T>, kNoOfSlots> kWriteTable =
+      MakeWriteTable<T>(std::make_index_sequence<kNoOfRegisters>{});
+
   template <
       typename TRegAccess, typename T,
       typename std::enable_if_t<!TRegAccess::kReadOnly && !TRegAccess::kUseReadModifyWrite, T> = 0>
@@ -109,23 +181,6 @@ private:
     static_cast<void>(value);
     return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
   }
-
-  template <typename T, typename Registers, std::size_t Index = 0U>
-  static WriteResult<T> WriteRegisterRecursive(const u32 &padr, TCpuAccessor &cpua, T value) {
-    if constexpr (Index < std::tuple_size_v<Registers>) {
-      using TypeRegAccess = std::tuple_element_t<Index, Registers>;
-
-      auto constexpr pstart_adr = static_cast<me_adr_t>(TypeRegAccess::kAdr);
-      auto constexpr pend_adr = static_cast<me_adr_t>(pstart_adr + sizeof(u32) - 1U);
-
-      if (padr >= pstart_adr && padr <= pend_adr) {
-        return PerformWrite<TypeRegAccess, T>(padr, cpua, value);
-      } else {
-        return WriteRegisterRecursive<T, Registers, Index + 1U>(padr, cpua, value);
-      }
-    }
-    return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
-  }
 };
 
 template <unsigned Id, unsigned VadrOffset, unsigned VadrRange, typename TCpuAccessor,
@@ -170,51 +225,6 @@ public:
 
   static constexpr bool kReadOnly = false;
 
-  // -------------------------------------------------
-  // Read from Peripheral List
-  // -------------------------------------------------
-
-  template <typename T, typename First, typename... Rest>
-  static ReadResult<T> ReadRegisters(TCpuAccessor &cpua, const u32 &padr) {
-    using Type = MemMapAccessPoint<TCpuAccessor, First, TLogger>;
-
-    if (padr >= Type::GetBeginPhysicalAddress() && padr <= Type::GetEndPhysicalAddress()) {
-      const auto read_32 = Type::template ReadRegister<T>(cpua, padr);
-      return read_32;
-    } else {
-      return ReadRegisters<T, Rest...>(cpua, padr);
-    }
-  }
-
-  template <typename T> static ReadResult<T> ReadRegisters(TCpuAccessor &cpua, const u32 &padr) {
-    static_cast<void>(cpua);
-    static_cast<void>(padr);
-    return ReadResult<T>{0x0U, ReadStatusCode::kReadNotAllowed};
-  }
-
-  // -------------------------------------------------
-  // Write from Peripheral List
-  // -------------------------------------------------
-  template <typename T, typename First, typename... Rest>
-  static WriteResult<T> WriteRegisters(TCpuAccessor &cpua, const u32 &padr, const T &value) {
-    using Type = MemMapAccessPoint<TCpuAccessor, First, TLogger>;
-
-    if (padr >= Type::GetBeginPhysicalAddress() && padr <= Type::GetEndPhysicalAddress()) {
-      const auto write_32 = Type::template WriteRegister<T>(cpua, padr, value);
-      return write_32;
-    } else {
-      return WriteRegisters<T, Rest...>(cpua, padr, value);
-    }
-  }
-
-  template <typename T>
-  static WriteResult<T> WriteRegisters(TCpuAccessor &cpua, const u32 &padr, const T &value) {
-    static_cast<void>(cpua);
-    static_cast<void>(padr);
-    static_cast<void>(value);
-    return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
-  }
-
   // -------------------------------------------------
   // API Methods
   // -------------------------------------------------
@@ -229,7 +239,7 @@ public:
 
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     assert(IsPAdrInRange(padr) == true);
-    auto read_res = ReadRegisters<T, TPeripherals...>(cpua, padr);
+    auto read_res = kReadFns<T>[kGranuleMap[padr >> kGranuleShift]](cpua, padr);
     return ReadResult<T>{static_cast<T>(read_res.content), read_res.status_code};
   }
 
@@ -246,11 +256,25 @@ public:
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     assert(IsPAdrInRange(padr) == true);
 
-    auto write_res = WriteRegisters<T, TPeripherals...>(cpua, padr, value);
+    auto write_res = kWriteFns<T>[kGranuleMap[padr >> kGranuleShift]](cpua, padr, value);
 
     return WriteResult<T>{write_res.status_code};
   }
 
+  /**
+   * @brief Gets the number of bytes from an address up to the start of the peripheral range.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by the peripheral range
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if (IsVAdrInRange(vadr)) {
+      return 0U;
+    }
+    const me_size_t distance = VadrOffset - vadr;
+    return (distance < size) ? distance : size;
+  }
+
   bool IsVAdrInRange(me_adr_t vadr) const {
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     if (IsPAdrInRange(padr) == false) {
@@ -260,6 +284,84 @@ public:
   }
 
 private:
+  // The peripheral of an address is looked up in a table with one entry per granule of 16 bytes.
+  // Entry 0 means no peripheral, entry i + 1 refers to the i-th peripheral.
+  static constexpr u32 kGranuleShift = 4U;
+  static constexpr std::size_t kNoOfGranules =
+      (static_cast<std::size_t>(VadrRange) + (1U << kGranuleShift) - 1U) >> kGranuleShift;
+  static constexpr std::size_t kNoOfPeripherals = sizeof...(TPeripherals);
+  static_assert(kNoOfPeripherals < 0xFFU, "Too many peripherals");
+
+  template <typename T> using ReadFn = ReadResult<T> (*)(TCpuAccessor &cpua, me_adr_t padr);
+  template <typename T>
+  using WriteFn = WriteResult<T> (*)(TCpuAccessor &cpua, me_adr_t padr, T value);
+
+  template <typename T> static ReadResult<T> ReadNotAllowed(TCpuAccessor &cpua, me_adr_t padr) {
+    static_cast<void>(cpua);
+    static_cast<void>(padr);
+    return ReadResult<T>{0x0U, ReadStatusCode::kReadNotAllowed};
+  }
+
+  template <typename T>
+  static WriteResult<T> WriteNotAllowed(TCpuAccessor &cpua, me_adr_t padr, T value) {
+    static_cast<void>(cpua);
+    static_cast<void>(padr);
+    static_cast<void>(value);
+    return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+  }
+
+  static constexpr std::array<u8, kNoOfGranules> MakeGranuleMap() {
+    constexpr std::array<me_adr_t, kNoOfPeripherals> kBegins = {
+        MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::GetBeginPhysicalAddress()...};
+    constexpr std::array<me_adr_t, kNoOfPeripherals> kEnds = {
+        MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::GetEndPhysicalAddress()...};
+
+    std::array<u8, kNoOfGranules> map{};
+    for (std::size_t i = 0U; i < kNoOfPeripherals; ++i) {
+      for (std::size_t g = kBegins[i] >> kGranuleShift; g <= (kEnds[i] >> kGranuleShift); ++g) {
+        map[g] = static_cast<u8>(i + 1U);
+      }
+    }
+    return map;
+  }
+
+  static constexpr bool ArePeripheralsValid() {
+    constexpr std::array<me_adr_t, kNoOfPeripherals> kBegins = {
+        MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::GetBeginPhysicalAddress()...};
+    constexpr std::array<me_adr_t, kNoOfPeripherals> kEnds = {
+        MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::GetEndPhysicalAddress()...};
+    constexpr me_adr_t kGranuleMsk = (1U << kGranuleShift) - 1U;
+
+    std::array<bool, kNoOfGranules> is_used{};
+    for (std::size_t i = 0U; i < kNoOfPeripherals; ++i) {
+      if (((kBegins[i] & kGranuleMsk) != 0U) || ((kEnds[i] & kGranuleMsk) != kGranuleMsk) ||
+          (kEnds[i] >= VadrRange) || (kBegins[i] > kEnds[i])) {
+        return false;
+      }
+      for (std::size_t g = kBegins[i] >> kGranuleShift; g <= (kEnds[i] >> kGranuleShift); ++g) {
+        if (is_used[g]) {
+          return false;
+        }
+        is_used[g] = true;
+      }
+    }
+    return true;
+  }
+  static_assert(ArePeripheralsValid(),
+                "Peripheral ranges must be 16 byte aligned, disjoint and within the mapped range");
+
+  static constexpr std::array<u8, kNoOfGranules> kGranuleMap = MakeGranuleMap();
+
+  template <typename T>
+  static constexpr std::array<ReadFn<T>, kNoOfPeripherals + 1U> kReadFns = {
+      &ReadNotAllowed<T>,
+      &MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::template ReadRegister<T>...};
+
+  template <typename T>
+  static constexpr std::array<WriteFn<T>, kNoOfPeripherals + 1U> kWriteFns = {
+      &WriteNotAllowed<T>,
+      &MemMapAccessPoint<TCpuAccessor, TPeripherals, TLogger>::template WriteRegister<T>...};
+
   me_adr_t ConvertToPhysicalAdr(me_adr_t vadr) const { return vadr - VadrOffset; }
   bool IsPAdrInRange(me_adr_t padr) const { return padr < VadrRange; }
 };
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "libmicroemu/internal/bus/mem_access_results.h"
+#include "libmicroemu/internal/peripherals/plugin_registry.h"
+#include "libmicroemu/types.h"
+#include <cassert>
+#include <type_traits>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Bus participant which forwards accesses to the peripherals attached at runtime.
+ *
+ * The participant is placed behind the flash, RAM and the built-in peripherals on the bus, so
+ * accesses to those are not slowed down. If no registry is assigned, the participant behaves as
+ * if it is not present.
+ * @tparam Id the id of the memory
+ * @tparam TCpuAccessor the cpu accessor
+ * @tparam TContext the context handed to the peripheral handlers
+ */
+template <unsigned Id, typename TCpuAccessor, typename TContext> class MemPlugin {
+public:
+  static constexpr bool kReadOnly = false;
+
+  /**
+   * @brief Constructor
+   */
+  explicit MemPlugin(PluginRegistry *const registry) : registry_(registry) {}
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~MemPlugin() = default;
+
+  /**
+   * @brief Copy constructor for MemPlugin.
+   * @param r_src the object to be copied
+   */
+  MemPlugin(const MemPlugin &r_src) = default;
+
+  /**
+   * @brief Copy assignment operator for MemPlugin.
+   * @param r_src the object to be copied
+   */
+  MemPlugin &operator=(const MemPlugin &r_src) = default;
+
+  /**
+   * @brief Move constructor for MemPlugin.
+   * @param r_src the object to be moved
+   */
+  MemPlugin(MemPlugin &&r_src) = default;
+
+  /**
+   * @brief Move assignment operator for MemPlugin.
+   * @param r_src the object to be moved
+   */
+  MemPlugin &operator=(MemPlugin &&r_src) = default;
+
+  template <typename T> ReadResult<T> Read(TCpuAccessor &cpua, me_adr_t vadr) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+        "Read only allows u32, u16 and u8");
+    // clang-format on
+    const auto idx = registry_->Find(vadr);
+    assert(idx != PluginRegistry::kNotFound);
+    const auto &entry = registry_->GetEntry(idx);
+
+    TContext ctx(*registry_, cpua, idx);
+    u32 value{0U};
+    const auto sc = entry.peripheral->Read(ctx, vadr - entry.begin, sizeof(T), value);
+    if (sc != StatusCode::kSuccess) {
+      return ReadResult<T>{0U, ReadStatusCode::kReadNotAllowed};
+    }
+    return ReadResult<T>{static_cast<T>(value), ReadStatusCode::kOk};
+  }
+
+  template <typename T> WriteResult<T> Write(TCpuAccessor &cpua, me_adr_t vadr, T value) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+         "Write only allows u32, u16 and u8 types");
+    // clang-format on
+    const auto idx = registry_->Find(vadr);
+    assert(idx != PluginRegistry::kNotFound);
+    const auto &entry = registry_->GetEntry(idx);
+
+    TContext ctx(*registry_, cpua, idx);
+    const auto sc = entry.peripheral->Write(ctx, vadr - entry.begin, sizeof(T), value);
+    if (sc != StatusCode::kSuccess) {
+      return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+    }
+    return WriteResult<T>{WriteStatusCode::kOk};
+  }
+
+  /**
+   * @brief Gets the number of bytes from an address up to the start of the next peripheral.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by the next peripheral
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if (registry_ == nullptr) {
+      return size;
+    }
+    return registry_->GetUnmappedLen(vadr, size);
+  }
+
+  bool IsVAdrInRange(me_adr_t vadr) const {
+    // if no registry was assigned always return that this memory has no valid access range
+    if (registry_ == nullptr) {
+      return false;
+    }
+    return registry_->Find(vadr) != PluginRegistry::kNotFound;
+  }
+
+private:
+  PluginRegistry *const registry_{nullptr};
+};
+
+} // namespace libmicroemu::internal
@@ -3,6 +3,8 @@
 #include "libmicroemu/internal/bus/mem_access_results.h"
 #include "libmicroemu/internal/result.h"
 #include "libmicroemu/types.h"
+#include <cassert>
+#include <cstring>
 #include <type_traits>
 
 using libmicroemu::internal::Result;
@@ -12,6 +14,7 @@ namespace libmicroemu ::internal {
 template <unsigned Id, typename TCpuAccessor, typename TEndianessC> class MemRo {
 public:
   static constexpr bool kReadOnly = true;
+  static constexpr bool kIsContiguous = true;
 
   /**
    * @brief Constructor
@@ -83,6 +86,35 @@ public:
     return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
   }
 
+  /**
+   * @brief Copies a block from the memory.
+   * @param vadr the virtual start address
+   * @param dst the destination buffer
+   * @param size the size of the block in bytes
+   * @return the number of bytes copied, limited by the end of the memory
+   */
+  me_size_t ReadBlock(me_adr_t vadr, u8 *dst, me_size_t size) const {
+    const me_adr_t padr = ConvertToPhysicalAdr(vadr);
+    assert(IsPAdrInRange(padr) == true);
+    const me_size_t len = (size < buf_size_ - padr) ? size : (buf_size_ - padr);
+    std::memcpy(dst, &buf_[padr], len);
+    return len;
+  }
+
+  /**
+   * @brief Gets the number of bytes from an address up to the start of the memory.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by the memory
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if (IsVAdrInRange(vadr)) {
+      return 0U;
+    }
+    const me_size_t distance = vadr_offset_ - vadr;
+    return (distance < size) ? distance : size;
+  }
+
   bool IsVAdrInRange(me_adr_t vadr) const {
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     if (IsPAdrInRange(padr) == false) {
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "libmicroemu/internal/bus/mem/exclusive_reservations.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
 #include "libmicroemu/internal/bus/mem_access_results.h"
 #include "libmicroemu/types.h"
+#include <cassert>
+#include <cstring>
 #include <type_traits>
 
 namespace libmicroemu::internal {
@@ -9,12 +13,17 @@ namespace libmicroemu::internal {
 template <unsigned Id, typename TCpuAccessor, typename TEndianessC> class MemRw {
 public:
   static constexpr bool kReadOnly = false;
+  static constexpr bool kIsContiguous = true;
+  static constexpr bool kIsAtomic = true;
 
   /**
    * @brief Constructor
+   * @param page_flags optional page flag array. If present, written pages are flagged dirty and
+   * unfilled pages are filled on their first access.
    */
-  explicit MemRw(u8 *const buf, const me_size_t buf_size, const me_adr_t vadr_offset)
-      : buf_(buf), vadr_offset_(vadr_offset), buf_size_(buf_size) {}
+  explicit MemRw(u8 *const buf, const me_size_t buf_size, const me_adr_t vadr_offset,
+                 PageFlagsSet *const page_flags = nullptr)
+      : buf_(buf), vadr_offset_(vadr_offset), buf_size_(buf_size), page_flags_(page_flags) {}
 
   /**
    * @brief Destructor
@@ -57,6 +66,9 @@ public:
 
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     assert(IsPAdrInRange(padr) == true);
+    if (page_flags_ != nullptr) {
+      PageFlagTable::FillUnfilled(page_flags_, buf_, buf_size_, padr, sizeof(T));
+    }
     T val = *reinterpret_cast<const T *>(&buf_[padr]);
     T cval = TEndianessC::template Convert<T>(val);
 
@@ -76,11 +88,130 @@ public:
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     assert(IsPAdrInRange(padr) == true);
 
-    *reinterpret_cast<T *const>(&buf_[padr]) = value;
+    if (page_flags_ != nullptr) {
+      PageFlagTable::FillUnfilled(page_flags_, buf_, buf_size_, padr, sizeof(T));
+    }
+    {
+      const ExclusiveReservations::StoreGuard guard(&buf_[padr], sizeof(T));
+      *reinterpret_cast<T *const>(&buf_[padr]) = value;
+    }
+    if (page_flags_ != nullptr) {
+      PageFlagTable::MarkDirty(page_flags_, padr, sizeof(T));
+    }
+
+    return WriteResult<T>{WriteStatusCode::kOk};
+  }
+
+  /**
+   * @brief Reserves a location for an exclusive store.
+   *
+   * The reservation is kept in the global exclusive monitor, so emulators sharing the buffer
+   * between host threads observe each other.
+   * @param vadr the virtual address
+   * @return the version to be passed to StoreExclusive
+   */
+  u32 Reserve(me_adr_t vadr) const {
+    const me_adr_t padr = ConvertToPhysicalAdr(vadr);
+    assert(IsPAdrInRange(padr) == true);
+    return ExclusiveReservations::Reserve(&buf_[padr]);
+  }
+
+  /**
+   * @brief Stores a value if the location was not written since it was reserved.
+   * @param cpua the cpu accessor
+   * @param vadr the virtual address
+   * @param version the version returned by Reserve
+   * @param value the value to be stored
+   * @param is_stored set to true if the value was stored
+   * @return the result of the write operation
+   */
+  template <typename T>
+  WriteResult<T> StoreExclusive(TCpuAccessor &cpua, me_adr_t vadr, u32 version, T value,
+                                bool &is_stored) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value || 
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,  
+         "StoreExclusive only allows u32, u16 and u8 types");
+    // clang-format on
+    static_cast<void>(cpua);
+
+    const me_adr_t padr = ConvertToPhysicalAdr(vadr);
+    assert(IsPAdrInRange(padr) == true);
+
+    if (page_flags_ != nullptr) {
+      PageFlagTable::FillUnfilled(page_flags_, buf_, buf_size_, padr, sizeof(T));
+    }
+    u8 *const ptr = &buf_[padr];
+    is_stored = ExclusiveReservations::BeginExclusiveStore(ptr, version);
+    if (!is_stored) {
+      return WriteResult<T>{WriteStatusCode::kOk};
+    }
+    const T converted = TEndianessC::template Convert<T>(value);
+    std::memcpy(ptr, &converted, sizeof(T));
+    ExclusiveReservations::EndExclusiveStore(ptr);
+    if (page_flags_ != nullptr) {
+      PageFlagTable::MarkDirty(page_flags_, padr, sizeof(T));
+    }
 
     return WriteResult<T>{WriteStatusCode::kOk};
   }
 
+  /**
+   * @brief Copies a block from the memory.
+   * @param vadr the virtual start address
+   * @param dst the destination buffer
+   * @param size the size of the block in bytes
+   * @return the number of bytes copied, limited by the end of the memory
+   */
+  me_size_t ReadBlock(me_adr_t vadr, u8 *dst, me_size_t size) const {
+    const me_adr_t padr = ConvertToPhysicalAdr(vadr);
+    assert(IsPAdrInRange(padr) == true);
+    const me_size_t len = (size < buf_size_ - padr) ? size : (buf_size_ - padr);
+    if ((page_flags_ != nullptr) && (len > 0U)) {
+      PageFlagTable::FillUnfilled(page_flags_, buf_, buf_size_, padr, len);
+    }
+    std::memcpy(dst, &buf_[padr], len);
+    return len;
+  }
+
+  /**
+   * @brief Copies a block to the memory.
+   * @param vadr the virtual start address
+   * @param src the source buffer
+   * @param size the size of the block in bytes
+   * @return the number of bytes copied, limited by the end of the memory
+   */
+  me_size_t WriteBlock(me_adr_t vadr, const u8 *src, me_size_t size) const {
+    const me_adr_t padr = ConvertToPhysicalAdr(vadr);
+    assert(IsPAdrInRange(padr) == true);
+    const me_size_t len = (size < buf_size_ - padr) ? size : (buf_size_ - padr);
+    if ((page_flags_ != nullptr) && (len > 0U)) {
+      // Bytes of the first and last page which are not overwritten keep the pattern
+      PageFlagTable::FillUnfilled(page_flags_, buf_, buf_size_, padr, len);
+    }
+    ExclusiveReservations::Store(&buf_[padr], src, len);
+    if ((page_flags_ != nullptr) && (len > 0U)) {
+      PageFlagTable::MarkDirtyRange(page_flags_, padr, len);
+    }
+    return len;
+  }
+
+  /**
+   * @brief Gets the number of bytes from an address up to the start of the memory.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by the memory
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const {
+    if (IsVAdrInRange(vadr)) {
+      return 0U;
+    }
+    const me_size_t distance = vadr_offset_ - vadr;
+    return (distance < size) ? distance : size;
+  }
+
   bool IsVAdrInRange(me_adr_t vadr) const {
     const me_adr_t padr = ConvertToPhysicalAdr(vadr);
     if (IsPAdrInRange(padr) == false) {
@@ -93,6 +224,7 @@ private:
   u8 *const buf_{nullptr};
   const me_adr_t vadr_offset_{0U};
   const me_size_t buf_size_{0U};
+  PageFlagsSet *const page_flags_{nullptr};
 
   me_adr_t ConvertToPhysicalAdr(me_adr_t vadr) const { return vadr - vadr_offset_; }
   bool IsPAdrInRange(me_adr_t padr) const { return padr < buf_size_; }
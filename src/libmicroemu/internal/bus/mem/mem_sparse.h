@@ -0,0 +1,198 @@
+#pragma once
+
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
+#include "libmicroemu/internal/bus/mem_access_results.h"
+#include "libmicroemu/types.h"
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Optional sparse memory class.
+ *
+ * This class represents the remaining guest address space which is not covered by any other bus
+ * participant. The memory is backed by a SparsePageStore, which commits host pages on the first
+ * write. If no page store is assigned, the memory behaves as if it is not present. Addresses in a
+ * fault region of the page store are not present either.
+ * @tparam Id the id of the memory
+ * @tparam TEndianessC the endianess converter
+ */
+template <unsigned Id, typename TCpuAccessor, typename TEndianessC> class MemSparse {
+public:
+  static constexpr bool kReadOnly = false;
+  static constexpr bool kIsPaged = true;
+
+  /**
+   * @brief Constructor
+   */
+  explicit MemSparse(SparsePageStore *const store) : store_(store) {}
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~MemSparse() = default;
+
+  /**
+   * @brief Copy constructor for MemSparse.
+   * @param r_src the object to be copied
+   */
+  MemSparse(const MemSparse &r_src) = default;
+
+  /**
+   * @brief Copy assignment operator for MemSparse.
+   * @param r_src the object to be copied
+   */
+  MemSparse &operator=(const MemSparse &r_src) = default;
+
+  /**
+   * @brief Move constructor for MemSparse.
+   * @param r_src the object to be moved
+   */
+  MemSparse(MemSparse &&r_src) = default;
+
+  /**
+   * @brief Move assignment operator for MemSparse.
+   * @param r_src the object to be moved
+   */
+  MemSparse &operator=(MemSparse &&r_src) = default;
+
+  template <typename T> ReadResult<T> Read(TCpuAccessor &cpua, me_adr_t vadr) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+        "Read only allows u32, u16 and u8");
+    // clang-format on
+    static_cast<void>(cpua);
+    assert(store_ != nullptr);
+
+    T val{0U};
+    const me_adr_t page_ofs = vadr & SparsePageStore::kPageMask;
+    if (page_ofs + sizeof(T) <= SparsePageStore::kPageSize) {
+      const u8 *page = store_->GetPage(vadr);
+      if (page != nullptr) {
+        val = *reinterpret_cast<const T *>(&page[page_ofs]);
+      } else {
+        std::memset(&val, store_->GetFillValue(), sizeof(T));
+      }
+    } else {
+      // Unaligned access crossing a page boundary
+      u8 raw[sizeof(T)];
+      for (me_size_t i = 0U; i < sizeof(T); ++i) {
+        const me_adr_t byte_vadr = vadr + i;
+        const u8 *page = store_->GetPage(byte_vadr);
+        raw[i] = (page != nullptr) ? page[byte_vadr & SparsePageStore::kPageMask]
+                                   : store_->GetFillValue();
+      }
+      std::memcpy(&val, raw, sizeof(T));
+    }
+    T cval = TEndianessC::template Convert<T>(val);
+
+    return ReadResult<T>{cval, ReadStatusCode::kOk};
+  }
+
+  template <typename T> WriteResult<T> Write(TCpuAccessor &cpua, me_adr_t vadr, T value) const {
+    // clang-format off
+    static_assert(
+        std::is_same<T, u32>::value ||
+        std::is_same<T, u16>::value ||
+        std::is_same<T, u8>::value,
+         "Write only allows u32, u16 and u8 types");
+    // clang-format on
+    static_cast<void>(cpua);
+    assert(store_ != nullptr);
+
+    const me_adr_t page_ofs = vadr & SparsePageStore::kPageMask;
+    if (page_ofs + sizeof(T) <= SparsePageStore::kPageSize) {
+      u8 *page = store_->GetWritablePage(vadr);
+      if (page == nullptr) {
+        return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+      }
+      *reinterpret_cast<T *const>(&page[page_ofs]) = value;
+    } else {
+      // Unaligned access crossing a page boundary
+      u8 raw[sizeof(T)];
+      std::memcpy(raw, &value, sizeof(T));
+      if (!store_->Store(vadr, raw, sizeof(T))) {
+        return WriteResult<T>{WriteStatusCode::kWriteNotAllowed};
+      }
+    }
+
+    return WriteResult<T>{WriteStatusCode::kOk};
+  }
+
+  /**
+   * @brief Copies a block from the memory. Committed pages are copied with memcpy, untouched
+   * pages read as the fill value.
+   * @param vadr the virtual start address
+   * @param dst the destination buffer
+   * @param size the size of the block in bytes
+   * @return the number of bytes copied, limited by the next fault region
+   */
+  me_size_t ReadBlock(me_adr_t vadr, u8 *dst, me_size_t size) const {
+    assert(store_ != nullptr);
+    const me_size_t len = store_->GetNoFaultLen(vadr, size);
+    me_size_t copied{0U};
+    while (copied < len) {
+      const me_adr_t page_ofs = vadr & SparsePageStore::kPageMask;
+      const me_size_t rest = len - copied;
+      const me_size_t chunk = (rest < SparsePageStore::kPageSize - page_ofs)
+                                  ? rest
+                                  : (SparsePageStore::kPageSize - page_ofs);
+      const u8 *page = store_->GetPage(vadr);
+      if (page != nullptr) {
+        std::memcpy(&dst[copied], &page[page_ofs], chunk);
+      } else {
+        std::memset(&dst[copied], store_->GetFillValue(), chunk);
+      }
+      vadr += chunk;
+      copied += chunk;
+    }
+    return len;
+  }
+
+  /**
+   * @brief Copies a block to the memory. The touched pages are committed.
+   * @param vadr the virtual start address
+   * @param src the source buffer
+   * @param size the size of the block in bytes
+   * @return the number of bytes copied, limited by the next fault region and the available host
+   * memory
+   */
+  me_size_t WriteBlock(me_adr_t vadr, const u8 *src, me_size_t size) const {
+    assert(store_ != nullptr);
+    const me_size_t len = store_->GetNoFaultLen(vadr, size);
+    me_size_t copied{0U};
+    while (copied < len) {
+      u8 *page = store_->GetWritablePage(vadr);
+      if (page == nullptr) {
+        break;
+      }
+      const me_adr_t page_ofs = vadr & SparsePageStore::kPageMask;
+      const me_size_t rest = len - copied;
+      const me_size_t chunk = (rest < SparsePageStore::kPageSize - page_ofs)
+                                  ? rest
+                                  : (SparsePageStore::kPageSize - page_ofs);
+      std::memcpy(&page[page_ofs], &src[copied], chunk);
+      vadr += chunk;
+      copied += chunk;
+    }
+    return copied;
+  }
+
+  bool IsVAdrInRange(me_adr_t vadr) const {
+    // if no page store was assigned always return that this memory has no valid access range
+    if (store_ == nullptr) {
+      return false;
+    }
+    return !store_->IsFaultAdr(vadr);
+  }
+
+private:
+  SparsePageStore *const store_{nullptr};
+};
+
+} // namespace libmicroemu::internal
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 // Helper type for SFINAE
 // Empty struct to be used as a placeholder for the second template parameter
 template <typename...> using void_t = void;
@@ -11,3 +13,42 @@ template <typename T> struct has_kRegisters<T, void_t<decltype(T::kRegisters)>>
 
 // Helper variable for simpler usage
 template <typename T> constexpr bool has_kRegisters_v = has_kRegisters<T>::value;
+
+// Bus participants with kIsAlias translate an access and forward it to the bus again
+template <typename T, typename = void> struct has_kIsAlias : std::false_type {};
+
+// Specialization if T::kIsAlias is valid
+template <typename T> struct has_kIsAlias<T, void_t<decltype(T::kIsAlias)>> : std::true_type {};
+
+// Helper variable for simpler usage
+template <typename T> constexpr bool has_kIsAlias_v = has_kIsAlias<T>::value;
+
+// Bus participants with kIsAtomic exchange values with host atomics
+template <typename T, typename = void> struct has_kIsAtomic : std::false_type {};
+
+// Specialization if T::kIsAtomic is valid
+template <typename T> struct has_kIsAtomic<T, void_t<decltype(T::kIsAtomic)>> : std::true_type {};
+
+// Helper variable for simpler usage
+template <typename T> constexpr bool has_kIsAtomic_v = has_kIsAtomic<T>::value;
+
+// Bus participants with kIsContiguous are backed by contiguous host memory and copy blocks
+template <typename T, typename = void> struct has_kIsContiguous : std::false_type {};
+
+// Specialization if T::kIsContiguous is valid
+template <typename T>
+struct has_kIsContiguous<T, void_t<decltype(T::kIsContiguous)>> : std::true_type {};
+
+// Helper variable for simpler usage
+template <typename T> constexpr bool has_kIsContiguous_v = has_kIsContiguous<T>::value;
+
+// Bus participants with kIsPaged are backed by host pages and copy blocks page by page. They
+// cover the addresses which are not mapped by the other participants, which therefore provide
+// GetUnmappedLen
+template <typename T, typename = void> struct has_kIsPaged : std::false_type {};
+
+// Specialization if T::kIsPaged is valid
+template <typename T> struct has_kIsPaged<T, void_t<decltype(T::kIsPaged)>> : std::true_type {};
+
+// Helper variable for simpler usage
+template <typename T> constexpr bool has_kIsPaged_v = has_kIsPaged<T>::value;
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "libmicroemu/types.h"
+#include <cstring>
+#include <new>
+
+namespace libmicroemu::internal {
+
+using PageFlagsSet = u8;
+
+enum class PageFlags : PageFlagsSet {
+  kDirty = 1U << 0U,    // Page was written since the flags were cleared
+  kUnfilled = 1U << 1U, // Page was not yet filled with the uninitialized memory pattern
+};
+
+/// Pattern of RAM which was not written since the ELF file was loaded
+constexpr u8 kUninitializedPattern = 0xFFU;
+
+/**
+ * @brief Table holding the flags of every page of a contiguous memory segment.
+ *
+ * The table is owned by the machine and handed to the memory bus participants as a raw
+ * pointer. Participants which get a null pointer do not track any page state.
+ */
+class PageFlagTable {
+public:
+  static constexpr u32 kPageShift = 10U;
+  static constexpr me_size_t kPageSize = 1U << kPageShift;
+
+  /**
+   * @brief Constructor
+   */
+  PageFlagTable() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~PageFlagTable() noexcept { delete[] flags_; }
+
+  /**
+   * @brief Copy constructor for PageFlagTable.
+   * @param r_src the object to be copied
+   */
+  PageFlagTable(const PageFlagTable &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for PageFlagTable.
+   * @param r_src the object to be copied
+   */
+  PageFlagTable &operator=(const PageFlagTable &r_src) = delete;
+
+  /**
+   * @brief Move constructor for PageFlagTable.
+   * @param r_src the object to be moved
+   */
+  PageFlagTable(PageFlagTable &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for PageFlagTable.
+   * @param r_src the object to be moved
+   */
+  PageFlagTable &operator=(PageFlagTable &&r_src) = delete;
+
+  /**
+   * @brief Calculates the number of pages needed to cover a memory segment.
+   * @param mem_size size of the memory segment in bytes
+   * @return number of pages
+   */
+  static constexpr me_size_t CalcNoOfPages(me_size_t mem_size) noexcept {
+    return static_cast<me_size_t>((static_cast<u64>(mem_size) + kPageSize - 1U) >> kPageShift);
+  }
+
+  /**
+   * @brief Allocates the table for a memory segment of the given size. All flags are cleared.
+   *
+   * One additional guard entry is allocated so that the page following the last byte of an
+   * access can always be flagged without a range check.
+   * @param mem_size size of the memory segment in bytes
+   * @return true on success, false if no host memory is available
+   */
+  bool Allocate(me_size_t mem_size) noexcept {
+    delete[] flags_;
+    no_of_pages_ = CalcNoOfPages(mem_size);
+    mem_size_ = mem_size;
+    flags_ = new (std::nothrow) PageFlagsSet[no_of_pages_ + 1U];
+    if (flags_ == nullptr) {
+      no_of_pages_ = 0U;
+      mem_size_ = 0U;
+      return false;
+    }
+    std::memset(flags_, 0, no_of_pages_ + 1U);
+    return true;
+  }
+
+  /**
+   * @brief Gets the raw flag array which is handed to the bus participants.
+   * @return pointer to the flags or nullptr if the table was not allocated
+   */
+  inline PageFlagsSet *GetRaw() const noexcept { return flags_; }
+
+  /**
+   * @brief Gets the number of pages covered by the table.
+   * @return number of pages
+   */
+  inline me_size_t GetNoOfPages() const noexcept { return no_of_pages_; }
+
+  /**
+   * @brief Gets the size of the memory segment covered by the table.
+   * @return size in bytes
+   */
+  inline me_size_t GetMemSize() const noexcept { return mem_size_; }
+
+  /**
+   * @brief Checks if all given flags are set for a page.
+   * @param page page index
+   * @param flags flags to check
+   * @return true if all flags are set
+   */
+  inline bool IsSet(me_size_t page, PageFlags flags) const noexcept {
+    const auto msk = static_cast<PageFlagsSet>(flags);
+    return (flags_[page] & msk) == msk;
+  }
+
+  /**
+   * @brief Clears the given flags of all pages.
+   * @param flags flags to clear
+   */
+  void ClearAll(PageFlags flags) noexcept {
+    const auto msk = static_cast<PageFlagsSet>(~static_cast<PageFlagsSet>(flags));
+    for (me_size_t i = 0U; i <= no_of_pages_; ++i) {
+      flags_[i] &= msk;
+    }
+  }
+
+  /**
+   * @brief Sets the given flags of all pages. The guard entry is not touched.
+   * @param flags flags to set
+   */
+  void SetAll(PageFlags flags) noexcept {
+    const auto msk = static_cast<PageFlagsSet>(flags);
+    for (me_size_t i = 0U; i < no_of_pages_; ++i) {
+      flags_[i] |= msk;
+    }
+  }
+
+  /**
+   * @brief Clears the given flags of a single page.
+   * @param page page index
+   * @param flags flags to clear
+   */
+  inline void Clear(me_size_t page, PageFlags flags) noexcept {
+    flags_[page] &= static_cast<PageFlagsSet>(~static_cast<PageFlagsSet>(flags));
+  }
+
+  /**
+   * @brief Flags all pages touched by an access as dirty.
+   * @param page_flags raw flag array
+   * @param padr physical address of the access
+   * @param size size of the access in bytes
+   */
+  static inline void MarkDirty(PageFlagsSet *page_flags, me_adr_t padr, me_size_t size) noexcept {
+    constexpr auto kDirtyMsk = static_cast<PageFlagsSet>(PageFlags::kDirty);
+    page_flags[padr >> kPageShift] |= kDirtyMsk;
+    page_flags[(padr + size - 1U) >> kPageShift] |= kDirtyMsk;
+  }
+
+  /**
+   * @brief Flags all pages of a block as dirty.
+   * @param page_flags raw flag array
+   * @param padr physical start address of the block
+   * @param size size of the block in bytes, at least 1
+   */
+  static inline void MarkDirtyRange(PageFlagsSet *page_flags, me_adr_t padr,
+                                    me_size_t size) noexcept {
+    constexpr auto kDirtyMsk = static_cast<PageFlagsSet>(PageFlags::kDirty);
+    const me_size_t last_page = (padr + size - 1U) >> kPageShift;
+    for (me_size_t page = padr >> kPageShift; page <= last_page; ++page) {
+      page_flags[page] |= kDirtyMsk;
+    }
+  }
+
+  /**
+   * @brief Fills all unfilled pages touched by an access with the uninitialized memory pattern.
+   * @param page_flags raw flag array
+   * @param buf the memory segment
+   * @param buf_size size of the memory segment in bytes
+   * @param padr physical address of the access
+   * @param size size of the access in bytes, at least 1
+   */
+  static inline void FillUnfilled(PageFlagsSet *page_flags, u8 *buf, me_size_t buf_size,
+                                  me_adr_t padr, me_size_t size) noexcept {
+    constexpr auto kUnfilledMsk = static_cast<PageFlagsSet>(PageFlags::kUnfilled);
+    const me_size_t last_page = (padr + size - 1U) >> kPageShift;
+    for (me_size_t page = padr >> kPageShift; page <= last_page; ++page) {
+      if ((page_flags[page] & kUnfilledMsk) != 0U) {
+        const me_size_t ofs = page << kPageShift;
+        const me_size_t len = (kPageSize < buf_size - ofs) ? kPageSize : (buf_size - ofs);
+        std::memset(&buf[ofs], kUninitializedPattern, len);
+        page_flags[page] &= static_cast<PageFlagsSet>(~kUnfilledMsk);
+      }
+    }
+  }
+
+  /**
+   * @brief Fills all pages which are still unfilled.
+   * @param buf the memory segment covered by the table
+   */
+  void FillAllUnfilled(u8 *buf) noexcept {
+    if (mem_size_ > 0U) {
+      FillUnfilled(flags_, buf, mem_size_, 0U, mem_size_);
+    }
+  }
+
+private:
+  PageFlagsSet *flags_{nullptr};
+  me_size_t no_of_pages_{0U};
+  me_size_t mem_size_{0U};
+};
+
+} // namespace libmicroemu::internal
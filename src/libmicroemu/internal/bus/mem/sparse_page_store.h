@@ -0,0 +1,330 @@
+#pragma once
+
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include "libmicroemu/types.h"
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Lazily committed page store spanning the full 32-bit guest address space.
+ *
+ * The store behaves as if the complete 4 GiB address space was reserved. Host memory is only
+ * committed for a page when it is written for the first time. Pages are located through a
+ * two-level page table (directory -> table -> page), so the host footprint is proportional to the
+ * number of touched pages. Reads of untouched pages return the fill value without committing
+ * memory.
+ *
+ * Every page carries a set of page flags. Committing or writing a page flags it dirty.
+ *
+ * Address ranges can be marked as fault regions. Accesses to these ranges are reported as not
+ * present, so the bus raises a fault as it does for unmapped memory.
+ */
+class SparsePageStore {
+public:
+  static constexpr u32 kPageShift = 12U;
+  static constexpr me_size_t kPageSize = 1U << kPageShift;
+  static constexpr me_adr_t kPageMask = kPageSize - 1U;
+
+  static constexpr u32 kDirShift = 22U;
+  static constexpr u32 kNoOfDirEntries = 1U << (32U - kDirShift);
+  static constexpr u32 kNoOfTableEntries = 1U << (kDirShift - kPageShift);
+
+  static constexpr u32 kMaxFaultRegions = 8U;
+  static constexpr u8 kDefaultFillValue = 0xFFU;
+
+  /**
+   * @brief Constructor
+   */
+  SparsePageStore() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~SparsePageStore() noexcept { Release(); }
+
+  /**
+   * @brief Copy constructor for SparsePageStore.
+   * @param r_src the object to be copied
+   */
+  SparsePageStore(const SparsePageStore &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for SparsePageStore.
+   * @param r_src the object to be copied
+   */
+  SparsePageStore &operator=(const SparsePageStore &r_src) = delete;
+
+  /**
+   * @brief Move constructor for SparsePageStore.
+   * @param r_src the object to be moved
+   */
+  SparsePageStore(SparsePageStore &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for SparsePageStore.
+   * @param r_src the object to be moved
+   */
+  SparsePageStore &operator=(SparsePageStore &&r_src) = delete;
+
+  /**
+   * @brief Returns the committed page which contains the given address.
+   * @param vadr the virtual address
+   * @return pointer to the start of the page or nullptr if the page was not committed yet
+   */
+  inline u8 *GetPage(me_adr_t vadr) const noexcept {
+    const PageTable *table = dir_[vadr >> kDirShift];
+    if (table == nullptr) {
+      return nullptr;
+    }
+    return table->pages[ToTableIndex(vadr)];
+  }
+
+  /**
+   * @brief Returns the page which contains the given address for writing.
+   *
+   * The page is committed if necessary and flagged dirty.
+   * @param vadr the virtual address
+   * @return pointer to the start of the page or nullptr if no host memory is available
+   */
+  inline u8 *GetWritablePage(me_adr_t vadr) noexcept {
+    PageTable *table = dir_[vadr >> kDirShift];
+    if (table != nullptr) {
+      const auto idx = ToTableIndex(vadr);
+      u8 *page = table->pages[idx];
+      if (page != nullptr) {
+        table->flags[idx] |= static_cast<PageFlagsSet>(PageFlags::kDirty);
+        return page;
+      }
+    }
+    return CommitPage(vadr);
+  }
+
+  /**
+   * @brief Returns the page which contains the given address and commits it if necessary.
+   *
+   * A freshly committed page is initialized with the fill value and flagged dirty.
+   * @param vadr the virtual address
+   * @return pointer to the start of the page or nullptr if no host memory is available
+   */
+  u8 *CommitPage(me_adr_t vadr) noexcept {
+    PageTable *&table = dir_[vadr >> kDirShift];
+    if (table == nullptr) {
+      table = new (std::nothrow) PageTable{};
+      if (table == nullptr) {
+        return nullptr;
+      }
+    }
+
+    const auto idx = ToTableIndex(vadr);
+    u8 *&page = table->pages[idx];
+    if (page == nullptr) {
+      page = new (std::nothrow) u8[kPageSize];
+      if (page == nullptr) {
+        return nullptr;
+      }
+      std::memset(page, fill_value_, kPageSize);
+      ++no_of_committed_pages_;
+    }
+    table->flags[idx] |= static_cast<PageFlagsSet>(PageFlags::kDirty);
+    return page;
+  }
+
+  /**
+   * @brief Releases the host memory of the page which contains the given address.
+   * @param vadr the virtual address
+   */
+  void DecommitPage(me_adr_t vadr) noexcept {
+    PageTable *table = dir_[vadr >> kDirShift];
+    if (table == nullptr) {
+      return;
+    }
+    const auto idx = ToTableIndex(vadr);
+    if (table->pages[idx] != nullptr) {
+      delete[] table->pages[idx];
+      table->pages[idx] = nullptr;
+      --no_of_committed_pages_;
+    }
+    table->flags[idx] = 0U;
+  }
+
+  /**
+   * @brief Calls a function for every committed page.
+   * @param fn function with the signature fn(me_adr_t page_vadr, u8 *page, PageFlagsSet &flags)
+   */
+  template <typename TFunc> void ForEachPage(TFunc fn) noexcept {
+    for (u32 dir_idx = 0U; dir_idx < kNoOfDirEntries; ++dir_idx) {
+      PageTable *table = dir_[dir_idx];
+      if (table == nullptr) {
+        continue;
+      }
+      for (u32 idx = 0U; idx < kNoOfTableEntries; ++idx) {
+        if (table->pages[idx] == nullptr) {
+          continue;
+        }
+        const me_adr_t page_vadr = (dir_idx << kDirShift) | (idx << kPageShift);
+        fn(page_vadr, table->pages[idx], table->flags[idx]);
+      }
+    }
+  }
+
+  /**
+   * @brief Clears the given flags of all committed pages.
+   * @param flags flags to clear
+   */
+  void ClearAll(PageFlags flags) noexcept {
+    const auto msk = static_cast<PageFlagsSet>(~static_cast<PageFlagsSet>(flags));
+    ForEachPage([msk](me_adr_t, u8 *, PageFlagsSet &page_flags) { page_flags &= msk; });
+  }
+
+  /**
+   * @brief Copies a block of host memory into the store and commits all touched pages.
+   * @param vadr the virtual start address
+   * @param src the source buffer
+   * @param size number of bytes to copy
+   * @return true on success, false if no host memory is available
+   */
+  bool Store(me_adr_t vadr, const u8 *src, me_size_t size) noexcept {
+    while (size > 0U) {
+      u8 *page = GetWritablePage(vadr);
+      if (page == nullptr) {
+        return false;
+      }
+      const me_adr_t page_ofs = vadr & kPageMask;
+      const me_size_t chunk = (size < kPageSize - page_ofs) ? size : (kPageSize - page_ofs);
+      std::memcpy(&page[page_ofs], src, chunk);
+
+      src += chunk;
+      size -= chunk;
+      vadr += chunk;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Decommits all pages. The fault regions are kept.
+   */
+  void Release() noexcept {
+    for (auto &table : dir_) {
+      if (table == nullptr) {
+        continue;
+      }
+      for (auto &page : table->pages) {
+        delete[] page;
+      }
+      delete table;
+      table = nullptr;
+    }
+    no_of_committed_pages_ = 0U;
+  }
+
+  /**
+   * @brief Adds an address range which faults on access.
+   * @param vadr the virtual start address of the range
+   * @param size size of the range in bytes
+   * @return true on success, false if the size is zero or no more regions can be added
+   */
+  bool AddFaultRegion(me_adr_t vadr, me_size_t size) noexcept {
+    if ((size == 0U) || (no_of_fault_regions_ >= kMaxFaultRegions)) {
+      return false;
+    }
+    // The last address is stored inclusive so that regions may end at 0xFFFFFFFF.
+    fault_regions_[no_of_fault_regions_] = FaultRegion{vadr, vadr + (size - 1U)};
+    ++no_of_fault_regions_;
+    return true;
+  }
+
+  /**
+   * @brief Removes all fault regions.
+   */
+  void ClearFaultRegions() noexcept { no_of_fault_regions_ = 0U; }
+
+  /**
+   * @brief Checks if the given address lies within a fault region.
+   * @param vadr the virtual address
+   * @return true if accesses to this address must fault
+   */
+  inline bool IsFaultAdr(me_adr_t vadr) const noexcept {
+    for (u32 i = 0U; i < no_of_fault_regions_; ++i) {
+      const auto &region = fault_regions_[i];
+      if ((vadr >= region.first) && (vadr <= region.last)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Gets the number of bytes from the given address up to the next fault region.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which do not lie within a fault region
+   */
+  me_size_t GetNoFaultLen(me_adr_t vadr, me_size_t size) const noexcept {
+    for (u32 i = 0U; i < no_of_fault_regions_; ++i) {
+      const auto &region = fault_regions_[i];
+      if ((vadr >= region.first) && (vadr <= region.last)) {
+        return 0U;
+      }
+      const me_size_t distance = region.first - vadr;
+      if (distance < size) {
+        size = distance;
+      }
+    }
+    return size;
+  }
+
+  /**
+   * @brief Sets the value which is returned by untouched pages.
+   *
+   * Only pages which are committed after this call are affected.
+   * @param fill_value the fill value
+   */
+  void SetFillValue(u8 fill_value) noexcept { fill_value_ = fill_value; }
+
+  /**
+   * @brief Gets the value which is returned by untouched pages.
+   * @return the fill value
+   */
+  inline u8 GetFillValue() const noexcept { return fill_value_; }
+
+  /**
+   * @brief Gets the number of committed pages.
+   * @return number of committed pages
+   */
+  me_size_t GetNoOfCommittedPages() const noexcept { return no_of_committed_pages_; }
+
+  /**
+   * @brief Gets the number of bytes which are backed by host memory.
+   * @return number of committed bytes (page tables are not included)
+   */
+  u64 GetCommittedBytes() const noexcept {
+    return static_cast<u64>(no_of_committed_pages_) * kPageSize;
+  }
+
+private:
+  struct FaultRegion {
+    me_adr_t first;
+    me_adr_t last;
+  };
+
+  struct PageTable {
+    std::array<u8 *, kNoOfTableEntries> pages;
+    std::array<PageFlagsSet, kNoOfTableEntries> flags;
+  };
+
+  static inline u32 ToTableIndex(me_adr_t vadr) noexcept {
+    return (vadr >> kPageShift) & (kNoOfTableEntries - 1U);
+  }
+
+  std::array<PageTable *, kNoOfDirEntries> dir_{};
+  std::array<FaultRegion, kMaxFaultRegions> fault_regions_{};
+  u32 no_of_fault_regions_{0U};
+  me_size_t no_of_committed_pages_{0U};
+  u8 fill_value_{kDefaultFillValue};
+};
+
+} // namespace libmicroemu::internal
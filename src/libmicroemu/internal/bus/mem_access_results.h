@@ -6,6 +6,7 @@ namespace libmicroemu::internal {
 enum class ReadStatusCode : u32 {
   kOk = 0U,
   kReadNotAllowed = 1U,
+  kAccessViolation = 2U, // Denied by the MPU
 };
 
 template <typename T> struct ReadResult {
@@ -16,6 +17,7 @@ template <typename T> struct ReadResult {
 enum class WriteStatusCode : u32 {
   kOk = 0U,
   kWriteNotAllowed = 1U,
+  kAccessViolation = 2U, // Denied by the MPU
 };
 
 template <typename T> struct WriteResult {
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "libmicroemu/internal/bus/access_page_table.h"
+#include "libmicroemu/register_details.h"
+#include "libmicroemu/special_register_id.h"
+#include "libmicroemu/types.h"
+#include <algorithm>
+#include <array>
+
+namespace libmicroemu::internal {
+
+enum class MpuAccessType {
+  kRead = 0U,  // Data read
+  kWrite = 1U, // Data write
+  kFetch = 2U, // Instruction fetch
+};
+
+/**
+ * @brief Compiles the regions of the PMSAv7 memory protection unit into page flags.
+ *
+ * The MPU registers are part of the processor state. Whenever they differ from the registers the
+ * flags were compiled from, the permissions are evaluated once for every address interval between
+ * two region or subregion boundaries and stored as deny flags in the page table. Pages which are
+ * crossed by a boundary are marked with kMpuCheck and resolved by the region walk of Lookup.
+ */
+class Mpu {
+public:
+  static constexpr AccessFlagsSet kDenyMsk = static_cast<AccessFlagsSet>(
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoPrivRead) |
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoPrivWrite) |
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserRead) |
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserWrite) |
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec));
+
+  /// @brief Flags which require a permission check
+  static constexpr AccessFlagsSet kCheckMsk =
+      static_cast<AccessFlagsSet>(kDenyMsk | static_cast<AccessFlagsSet>(AccessFlags::kMpuCheck));
+
+  /// @brief Address of the first MPU register
+  static constexpr me_adr_t kRegistersVadr = 0xE000ED90U;
+
+  /**
+   * @brief Loads the MPU registers from the processor state.
+   * @param cpua the cpu accessor
+   * @return true if the registers changed since the last call
+   */
+  template <typename TCpuAccessor> bool Load(const TCpuAccessor &cpua) noexcept {
+    std::array<u32, kNoOfRegisters> regs{};
+    regs[kTypeIdx] = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuType>();
+    regs[kCtrlIdx] = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuCtrl>();
+    for (u32 i = 0U; i < MpuRegister::kNoOfRegions; ++i) {
+      regs[kRbarIdx + i] = cpua.ReadSpecialRegister(
+          static_cast<SpecialRegisterId>(static_cast<u32>(SpecialRegisterId::kMpuRbar0) + i));
+      regs[kRasrIdx + i] = cpua.ReadSpecialRegister(
+          static_cast<SpecialRegisterId>(static_cast<u32>(SpecialRegisterId::kMpuRasr0) + i));
+    }
+    if (regs == regs_) {
+      return false;
+    }
+    regs_ = regs;
+    return true;
+  }
+
+  /**
+   * @brief Checks if the processor has an MPU.
+   * @return true if MPU_TYPE reports at least one region
+   */
+  inline bool IsPresent() const noexcept {
+    return (regs_[kTypeIdx] & MpuRegister::kTypeDRegionMsk) != 0U;
+  }
+
+  /**
+   * @brief Checks if the MPU is present and enabled.
+   * @return true if the accesses are checked
+   */
+  inline bool IsEnabled() const noexcept {
+    return IsPresent() && ((regs_[kCtrlIdx] & MpuRegister::kCtrlEnableMsk) != 0U);
+  }
+
+  /**
+   * @brief Gets the flags which deny an access of the given type.
+   * @param type the type of the access
+   * @param is_privileged true if the access is privileged
+   * @return the deny flags
+   */
+  static constexpr AccessFlagsSet GetDenyMask(MpuAccessType type, bool is_privileged) noexcept {
+    const auto read_msk = static_cast<AccessFlagsSet>(is_privileged ? AccessFlags::kMpuNoPrivRead
+                                                                    : AccessFlags::kMpuNoUserRead);
+    switch (type) {
+    case MpuAccessType::kWrite: {
+      return static_cast<AccessFlagsSet>(is_privileged ? AccessFlags::kMpuNoPrivWrite
+                                                       : AccessFlags::kMpuNoUserWrite);
+    }
+    case MpuAccessType::kFetch: {
+      return static_cast<AccessFlagsSet>(read_msk |
+                                         static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec));
+    }
+    case MpuAccessType::kRead:
+    default: {
+      return read_msk;
+    }
+    }
+  }
+
+  /**
+   * @brief Evaluates the permissions of an address by walking the regions.
+   * @param vadr the virtual address
+   * @return the deny flags of the address
+   */
+  AccessFlagsSet Lookup(me_adr_t vadr) const noexcept {
+    // The private peripheral bus always uses the default memory map
+    if ((vadr >= kPpbBegin) && (vadr < kPpbEnd)) {
+      return static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec);
+    }
+
+    // The region with the highest number takes priority
+    for (u32 i = MpuRegister::kNoOfRegions; i > 0U; --i) {
+      const auto region = GetRegion(i - 1U);
+      if (!region.is_enabled || ((static_cast<u64>(vadr) - region.base) >= region.size)) {
+        continue;
+      }
+      if (region.size >= kMinSubregionSize) {
+        const auto subregion = (static_cast<u64>(vadr) - region.base) / (region.size / 8U);
+        if ((region.srd & (1U << subregion)) != 0U) {
+          continue;
+        }
+      }
+      return region.flags;
+    }
+
+    // Background region
+    if ((regs_[kCtrlIdx] & MpuRegister::kCtrlPrivDefEnaMsk) != 0U) {
+      return static_cast<AccessFlagsSet>(
+          static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserRead) |
+          static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserWrite) | GetDefaultMapXn(vadr));
+    }
+    return kDenyMsk;
+  }
+
+  /**
+   * @brief Stores the deny flags of the whole address space in a page table.
+   * @param table the page table
+   * @return true on success, false if no host memory is available
+   */
+  bool Compile(AccessPageTable &table) const noexcept {
+    // Permissions only change at region, subregion and default memory map boundaries
+    std::array<u64, kMaxBoundaries> bounds{};
+    u32 no_of_bounds{0U};
+    for (const auto bound : kDefaultMapBoundaries) {
+      bounds[no_of_bounds++] = bound;
+    }
+    for (u32 i = 0U; i < MpuRegister::kNoOfRegions; ++i) {
+      const auto region = GetRegion(i);
+      if (!region.is_enabled) {
+        continue;
+      }
+      // Subregion boundaries only matter if a subregion is disabled
+      const u32 steps = ((region.size >= kMinSubregionSize) && (region.srd != 0U)) ? 8U : 1U;
+      for (u32 step = 0U; step <= steps; ++step) {
+        bounds[no_of_bounds++] = region.base + (region.size / steps) * step;
+      }
+    }
+    std::sort(bounds.begin(), bounds.begin() + no_of_bounds);
+    const auto bounds_end = std::unique(bounds.begin(), bounds.begin() + no_of_bounds);
+    no_of_bounds = static_cast<u32>(bounds_end - bounds.begin());
+
+    constexpr u64 kPageMsk = (1U << AccessPageTable::kPageShift) - 1U;
+    for (u32 i = 0U; (i + 1U) < no_of_bounds; ++i) {
+      const u64 begin = bounds[i];
+      const u64 end = bounds[i + 1U];
+      const u64 full_begin = (begin + kPageMsk) & ~kPageMsk;
+      const u64 full_end = end & ~kPageMsk;
+
+      const auto flags = Lookup(static_cast<me_adr_t>(begin));
+      if ((full_begin < full_end) && (flags != 0U) &&
+          !table.SetFlags(static_cast<me_adr_t>(full_begin), full_end - full_begin, flags)) {
+        return false;
+      }
+      // A page crossed by the boundary is resolved by a region walk
+      if (((begin & kPageMsk) != 0U) &&
+          !table.SetFlags(static_cast<me_adr_t>(begin), 1U,
+                          static_cast<AccessFlagsSet>(AccessFlags::kMpuCheck))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  struct Region {
+    bool is_enabled;
+    u64 base;
+    u64 size;
+    u32 srd;
+    AccessFlagsSet flags;
+  };
+
+  static constexpr u32 kTypeIdx = 0U;
+  static constexpr u32 kCtrlIdx = 1U;
+  static constexpr u32 kRbarIdx = 2U;
+  static constexpr u32 kRasrIdx = kRbarIdx + MpuRegister::kNoOfRegions;
+  static constexpr u32 kNoOfRegisters = kRasrIdx + MpuRegister::kNoOfRegions;
+
+  static constexpr me_adr_t kPpbBegin = 0xE0000000U;
+  static constexpr me_adr_t kPpbEnd = 0xE0100000U;
+  static constexpr u64 kMinRegionSize = 32U;
+  static constexpr u64 kMinSubregionSize = 256U;
+
+  static constexpr std::array<u64, 7U> kDefaultMapBoundaries = {
+      0x0U, 0x40000000U, 0x60000000U, 0xA0000000U, kPpbBegin, kPpbEnd, 0x100000000U};
+  static constexpr u32 kMaxBoundaries =
+      static_cast<u32>(kDefaultMapBoundaries.size()) + 9U * MpuRegister::kNoOfRegions;
+
+  Region GetRegion(u32 idx) const noexcept {
+    const u32 rbar = regs_[kRbarIdx + idx];
+    const u32 rasr = regs_[kRasrIdx + idx];
+    const u64 size = 1ULL
+                     << (((rasr & MpuRegister::kRasrSizeMsk) >> MpuRegister::kRasrSizePos) + 1U);
+    const bool is_enabled =
+        ((rasr & MpuRegister::kRasrEnableMsk) != 0U) && (size >= kMinRegionSize);
+
+    // The base address is aligned to the region size
+    const u64 base = static_cast<u64>(rbar & MpuRegister::kRbarAddrMsk) & ~(size - 1U);
+    const u32 srd = (rasr & MpuRegister::kRasrSrdMsk) >> MpuRegister::kRasrSrdPos;
+
+    auto flags = ApToFlags((rasr & MpuRegister::kRasrApMsk) >> MpuRegister::kRasrApPos);
+    if ((rasr & MpuRegister::kRasrXnMsk) != 0U) {
+      flags |= static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec);
+    }
+    return Region{is_enabled, base, size, srd, flags};
+  }
+
+  static constexpr AccessFlagsSet ApToFlags(u32 ap) noexcept {
+    constexpr auto kNoPrivRead = static_cast<AccessFlagsSet>(AccessFlags::kMpuNoPrivRead);
+    constexpr auto kNoPrivWrite = static_cast<AccessFlagsSet>(AccessFlags::kMpuNoPrivWrite);
+    constexpr auto kNoUserRead = static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserRead);
+    constexpr auto kNoUserWrite = static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserWrite);
+
+    switch (ap) {
+    case 0b001U: { // privileged read/write, unprivileged no access
+      return kNoUserRead | kNoUserWrite;
+    }
+    case 0b010U: { // privileged read/write, unprivileged read-only
+      return kNoUserWrite;
+    }
+    case 0b011U: { // full access
+      return 0U;
+    }
+    case 0b101U: { // privileged read-only, unprivileged no access
+      return kNoPrivWrite | kNoUserRead | kNoUserWrite;
+    }
+    case 0b110U:   // read-only
+    case 0b111U: { // read-only
+      return kNoPrivWrite | kNoUserWrite;
+    }
+    case 0b000U: // no access
+    default: {   // reserved
+      return kNoPrivRead | kNoPrivWrite | kNoUserRead | kNoUserWrite;
+    }
+    }
+  }
+
+  static constexpr AccessFlagsSet GetDefaultMapXn(me_adr_t vadr) noexcept {
+    // Peripheral, device and system regions of the default memory map are execute never
+    const bool is_xn = ((vadr >= 0x40000000U) && (vadr < 0x60000000U)) || (vadr >= 0xA0000000U);
+    return is_xn ? static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec) : AccessFlagsSet{0U};
+  }
+
+  std::array<u32, kNoOfRegisters> regs_{};
+};
+
+} // namespace libmicroemu::internal
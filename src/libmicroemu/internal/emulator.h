@@ -1,11 +1,17 @@
 #pragma once
 
+#include "libmicroemu/internal/bus/access_monitor.h"
 #include "libmicroemu/internal/bus/bus.h"
 #include "libmicroemu/internal/bus/endianess_converters.h"
+#include "libmicroemu/internal/bus/mem/mem_bit_band.h"
 #include "libmicroemu/internal/bus/mem/mem_map_rw.h"
+#include "libmicroemu/internal/bus/mem/mem_plugin.h"
 #include "libmicroemu/internal/bus/mem/mem_ro.h"
 #include "libmicroemu/internal/bus/mem/mem_rw.h"
 #include "libmicroemu/internal/bus/mem/mem_rw_optional.h"
+#include "libmicroemu/internal/bus/mem/mem_sparse.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
 #include "libmicroemu/internal/cpu_accessor.h"
 #include "libmicroemu/internal/cpu_ops.h"
 #include "libmicroemu/internal/decoder/decoder.h"
@@ -18,12 +24,15 @@
 #include "libmicroemu/internal/logic/reg_ops.h"
 #include "libmicroemu/internal/logic/reset_logic.h"
 #include "libmicroemu/internal/logic/spec_reg_ops.h"
+#include "libmicroemu/internal/peripherals/irq_injector.h"
+#include "libmicroemu/internal/peripherals/plugin_registry.h"
 #include "libmicroemu/internal/peripherals/sys_ctrl_block.h"
 #include "libmicroemu/internal/peripherals/sys_tick.h"
 #include "libmicroemu/internal/processor/processor.h"
 #include "libmicroemu/internal/processor/step_flags.h"
 #include "libmicroemu/internal/result.h"
 #include "libmicroemu/internal/semihosting/semihosting.h"
+#include "libmicroemu/internal/trace/edge_coverage.h"
 #include "libmicroemu/logger.h"
 #include "libmicroemu/types.h"
 
@@ -43,12 +52,16 @@ public:
   // Aliases for peripherals
   using SysCtrlBlock = SysCtrlBlock<CpuAccessor, StaticLogger>;
   using SysTick = SysTick<CpuAccessor, ExceptionTrigger, StaticLogger>;
+  using PluginContext = PluginContext<CpuAccessor, ExceptionTrigger>;
 
   // Aliases for bus clients
   using EndConv = LittleToLittleEndianConverter;
   using Flash = MemRo<0U, CpuAccessor, EndConv>;
   using Ram0 = MemRw<1U, CpuAccessor, EndConv>;
   using Ram1 = MemRwOptional<2U, CpuAccessor, EndConv>;
+  using Plugins = MemPlugin<5U, CpuAccessor, PluginContext>;
+  using BitBand = MemBitBand<6U, CpuAccessor>;
+  using Sparse = MemSparse<4U, CpuAccessor, EndConv>;
 
   // clang-format off
   using Peripherals = MemMapRw<3U, 0xE0000000U, 0xFFFFU, 
@@ -68,9 +81,17 @@ public:
       Flash,
       Ram0, 
       Ram1, 
-      Peripherals
+      Peripherals,
+      Plugins,
+      BitBand,
+      Sparse // must be the last bus client, it covers every address not mapped before
    >;
   // clang-format on
+  static_assert(Bus::kNoOfParticipants == kNoOfBusRegions,
+                "BusRegion must list the bus clients in the order of the bus");
+
+  // Context of the reset and tick handlers of runtime peripherals
+  using PluginBusContext = PluginBusContext<CpuAccessor, ExceptionTrigger, Bus>;
 
   // Semihosting modules
   using Semihosting = Semihosting<CpuAccessor, Bus, StaticLogger>;
@@ -98,25 +119,51 @@ public:
     flash_vadr_ = seg_vadr;
   }
 
-  void SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) {
+  void SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      PageFlagsSet *page_flags = nullptr) {
     ram1_ = seg_ptr;
     ram1_size_ = seg_size;
     ram1_vadr_ = seg_vadr;
+    ram1_page_flags_ = page_flags;
   }
 
-  void SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) {
+  void SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                      PageFlagsSet *page_flags = nullptr) {
     ram2_ = seg_ptr;
     ram2_size_ = seg_size;
     ram2_vadr_ = seg_vadr;
+    ram2_page_flags_ = page_flags;
   }
 
+  void SetSparseMemory(SparsePageStore *sparse) { sparse_ = sparse; }
+
+  void SetPluginRegistry(PluginRegistry *plugins) { plugins_ = plugins; }
+
+  void SetAccessMonitor(AccessMonitor *monitor) { monitor_ = monitor; }
+
+  void SetBusStatistics(BusStatistics *bus_stats) { bus_stats_ = bus_stats; }
+
+  void SetConsoleCallback(const FConsoleCallback *console) { console_ = console; }
+
+  void SetStopRequest(std::atomic<bool> *stop_request) { stop_request_ = stop_request; }
+
+  void SetEdgeCoverage(EdgeCoverage *coverage) { coverage_ = coverage; }
+
+  void SetIrqInjector(IrqInjector *irqs) { irqs_ = irqs; }
+
   Bus BuildBus() {
     Flash code_access(const_cast<u8 *>(flash_), flash_size_, flash_vadr_);
-    Ram0 rw_mem_access(ram1_, ram1_size_, ram1_vadr_);
-    Ram1 rw_stack_access(ram2_, ram2_size_, ram2_vadr_);
+    Ram0 rw_mem_access(ram1_, ram1_size_, ram1_vadr_, ram1_page_flags_);
+    Ram1 rw_stack_access(ram2_, ram2_size_, ram2_vadr_, ram2_page_flags_);
     Peripherals peripheral_access;
-
-    Bus bus(code_access, rw_mem_access, rw_stack_access, peripheral_access);
+    Plugins plugin_access(plugins_);
+    BitBand bit_band_access;
+    Sparse sparse_access(sparse_);
+
+    Bus bus(code_access, rw_mem_access, rw_stack_access, peripheral_access, plugin_access,
+            bit_band_access, sparse_access);
+    bus.SetAccessMonitor(monitor_);
+    bus.SetStatistics(bus_stats_ != nullptr ? bus_stats_->regions.data() : nullptr);
     return bus;
   }
 
@@ -126,9 +173,28 @@ public:
 
     auto res = ResetLogic::TakeReset(cpua, bus);
     TRY(void, res);
+
+    if (plugins_ != nullptr) {
+      plugins_->Reset<PluginBusContext>(cpua, bus);
+    }
+    if (irqs_ != nullptr) {
+      irqs_->Clear();
+    }
     return Ok();
   }
 
+  Result<void> ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) {
+    auto bus = BuildBus();
+    auto &cpua = static_cast<CpuAccessor &>(cpu_states_);
+    return bus.ReadBlock(cpua, vadr, dst, size);
+  }
+
+  Result<void> WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) {
+    auto bus = BuildBus();
+    auto &cpua = static_cast<CpuAccessor &>(cpu_states_);
+    return bus.WriteBlock(cpua, vadr, src, size);
+  }
+
   void SetEntryPoint(u32 entry_point) {
     const auto aligned_entry_point = entry_point & (~0x1U);
 
@@ -137,11 +203,18 @@ public:
     PcOps::BranchTo(cpua, aligned_entry_point);
   }
 
+  /**
+   * @brief Executes instructions until the program terminates or a limit is reached.
+   * @tparam kIsStopAdr if true, execution stops before the instruction at stop_adr is executed
+   * @tparam kIsCoverage if true, every taken branch is recorded in the edge coverage map
+   */
+  template <bool kIsStopAdr = false, bool kIsCoverage = false>
   ExecResult Exec(i64 instr_limit, FPreExecStepCallback cb_pre_exec,
-                  FPostExecStepCallback cb_post_exec) {
+                  FPostExecStepCallback cb_post_exec, me_adr_t stop_adr = 0U) {
+    static_cast<void>(stop_adr); // unused if kIsStopAdr is false
     auto bus = BuildBus();
     auto &cpua = static_cast<CpuAccessor &>(cpu_states_);
-    auto semihosting = Semihosting(cpua, bus);
+    auto semihosting = Semihosting(cpua, bus, console_);
 
     u64 instr_count{0U};
     bool is_instr_limit = instr_limit > 0;
@@ -164,25 +237,81 @@ public:
           return Ok<SvcFlagsSet>(svc_flags);
         });
 
+    // The MPU registers may have been changed by a reset or a restored snapshot
+    if ((monitor_ != nullptr) && !monitor_->SyncMpu(cpua)) {
+      return ExecResult(StatusCode::kError, EXIT_FAILURE, instr_count);
+    }
+
     while (true) {
+      if constexpr (kIsStopAdr) {
+        // The pc points to the current instruction + 4
+        const auto pc = static_cast<me_adr_t>(cpua.template ReadRegister<RegisterId::kPc>());
+        if (static_cast<me_adr_t>(pc - 4U) == stop_adr) {
+          return ExecResult(StatusCode::kStopAddressReached, EXIT_SUCCESS, instr_count);
+        }
+      }
+
+      me_adr_t pc_before_step{0U};
+      if constexpr (kIsCoverage) {
+        pc_before_step = static_cast<me_adr_t>(cpua.template ReadRegister<RegisterId::kPc>());
+      }
+
       const auto step_ret = Processor::Step(cpua, bus, delegates);
       if (step_ret.IsErr()) {
-        return ExecResult(step_ret.status_code, EXIT_FAILURE);
+        return ExecResult(step_ret.status_code, EXIT_FAILURE, instr_count);
       }
 
       const auto step_flags = step_ret.content;
+      if ((step_flags & static_cast<StepFlagsSet>(StepFlags::kStepExclusiveStorePending)) != 0U) {
+        // The STREX was not executed, it is fetched again by the next Exec
+        return ExecResult(StatusCode::kExclusiveStorePending, EXIT_SUCCESS, instr_count);
+      }
+      if constexpr (kIsCoverage) {
+        // Instructions which do not branch advance the pc by their size
+        const auto pc = static_cast<me_adr_t>(cpua.template ReadRegister<RegisterId::kPc>());
+        const me_adr_t instr_size =
+            (step_flags & static_cast<StepFlagsSet>(StepFlags::kStep32Bit)) != 0U ? 4U : 2U;
+        if (static_cast<me_adr_t>(pc - pc_before_step) != instr_size) {
+          coverage_->AddEdge(pc);
+        }
+      }
+
+      ++instr_count;
       if (step_flags & static_cast<StepFlagsSet>(StepFlags::kStepTerminationRequest)) {
-        return ExecResult(StatusCode::kSuccess, semihosting.GetExitStatusCode());
+        return ExecResult(StatusCode::kSuccess, semihosting.GetExitStatusCode(), instr_count);
       }
 
       const auto systick_ret = SysTick::Step(cpua);
       if (systick_ret.IsErr()) {
-        return ExecResult(systick_ret.status_code, EXIT_FAILURE);
+        return ExecResult(systick_ret.status_code, EXIT_FAILURE, instr_count);
+      }
+
+      if ((plugins_ != nullptr) && plugins_->AdvanceTime()) {
+        const auto sc_wake_up = plugins_->WakeUp<PluginBusContext>(cpua, bus);
+        if (sc_wake_up != StatusCode::kSuccess) {
+          return ExecResult(sc_wake_up, EXIT_FAILURE, instr_count);
+        }
+      }
+
+      if (irqs_ != nullptr) {
+        // The plugin registry owns the virtual time, see Machine::EnableIrqInjection
+        const u64 time = (plugins_ != nullptr) ? plugins_->GetTime() : 0U;
+        if (irqs_->IsDue(time)) {
+          irqs_->Deliver<ExceptionTrigger>(cpua, time);
+        }
+      }
+
+      if ((monitor_ != nullptr) && monitor_->IsStopRequested()) {
+        return ExecResult(monitor_->TakeStopStatus(), EXIT_SUCCESS, instr_count);
+      }
+
+      if ((stop_request_ != nullptr) && stop_request_->load(std::memory_order_relaxed)) {
+        stop_request_->store(false, std::memory_order_relaxed);
+        return ExecResult(StatusCode::kStopRequested, EXIT_SUCCESS, instr_count);
       }
 
-      ++instr_count;
       if (is_instr_limit && instr_count >= u_instr_limit) {
-        return ExecResult(StatusCode::kMaxInstructionsReached, EXIT_SUCCESS);
+        return ExecResult(StatusCode::kMaxInstructionsReached, EXIT_SUCCESS, instr_count);
       }
     }
 
@@ -230,10 +359,21 @@ private:
   u8 *ram1_{nullptr};
   me_size_t ram1_size_{0U};
   me_adr_t ram1_vadr_{0U};
+  PageFlagsSet *ram1_page_flags_{nullptr};
 
   u8 *ram2_{nullptr};
   me_size_t ram2_size_{0U};
   me_adr_t ram2_vadr_{0U};
+  PageFlagsSet *ram2_page_flags_{nullptr};
+
+  SparsePageStore *sparse_{nullptr};
+  PluginRegistry *plugins_{nullptr};
+  AccessMonitor *monitor_{nullptr};
+  BusStatistics *bus_stats_{nullptr};
+  const FConsoleCallback *console_{nullptr};
+  std::atomic<bool> *stop_request_{nullptr};
+  EdgeCoverage *coverage_{nullptr};
+  IrqInjector *irqs_{nullptr};
 
   TCpuStates &cpu_states_;
 };
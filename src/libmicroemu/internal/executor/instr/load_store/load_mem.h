@@ -1,6 +1,7 @@
 #pragma once
 
 #include "libmicroemu/internal/result.h"
+#include "libmicroemu/internal/utils/bit_manip.h"
 #include "libmicroemu/types.h"
 
 namespace libmicroemu::internal {
@@ -94,9 +95,13 @@ public:
 template <typename TInstrContext> class LoadMemExU32 {
 public:
   static inline Result<u32> Read(const TInstrContext &ictx, const me_adr_t &address) {
+    // Reserved before the read, so a store between both fails the STREX
+    const u32 version = ictx.bus.Reserve(address);
     TRY_ASSIGN(r_data, u32,
                ictx.bus.template ReadOrRaise<u32>(ictx.cpua, address,
                                                   BusExceptionType::kRaisePreciseDataBusError));
+    // SetExclusiveMonitors(address,4);
+    ictx.cpua.GetExclusiveMonitorStates().SetExclusive(address, version);
     return Ok(r_data);
   }
 };
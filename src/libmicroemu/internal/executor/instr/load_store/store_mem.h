@@ -58,9 +58,22 @@ template <typename TInstrContext> class StoreMemExU32 {
 public:
   static inline Result<void> Write(const TInstrContext &ictx, const u32 &address, const u32 &rt,
                                    u32 &rd) {
-    TRY(void, ictx.bus.template WriteOrRaise<u32>(ictx.cpua, address, rt,
-                                                  BusExceptionType::kRaisePreciseDataBusError));
-    rd = 0x0U; // operation always succeeds ... updates memory
+    // if ExclusiveMonitorsPass(address,4) then
+    auto &monitor = ictx.cpua.GetExclusiveMonitorStates();
+    if (!monitor.IsExclusive(address)) {
+      // A grant of the arbitration is only valid for the tagged address
+      monitor.ClearExclusive();
+      rd = 0x1U;
+      return Ok();
+    }
+    const u32 version = monitor.GetVersion();
+    monitor.ClearExclusive();
+
+    // The global monitor passes if no other observer wrote the location since the LDREX
+    TRY_ASSIGN(is_stored, void,
+               ictx.bus.template StoreExclusiveOrRaise<u32>(
+                   ictx.cpua, address, version, rt, BusExceptionType::kRaisePreciseDataBusError));
+    rd = is_stored ? 0x0U : 0x1U;
     return Ok();
   }
 };
@@ -471,6 +471,7 @@ public:
 
     // SCS_UpdateStatusRegs(); // update SCS registers as appropriate
     // ClearExclusiveLocal(ProcessorID());
+    cpua.GetExclusiveMonitorStates().ClearExclusive();
     // SetEventRegister();   // see WFE instruction for more details
     // InstructionSynchronizationBarrier('1111');
     return Ok();
@@ -618,6 +619,7 @@ public:
       }
 
       // ClearExclusiveLocal(ProcessorID());
+      cpua.GetExclusiveMonitorStates().ClearExclusive();
       // SetEventRegister();  // see WFE instruction for more details
       // InstructionSynchronizationBarrier('1111');
 
@@ -83,7 +83,10 @@ public:
     Exc::InitDefaultExceptionStates(cpua);
 
     // ResetSCSRegs(); /* catch-all function for System Control Space reset */
+    cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuCtrl>(0U);
+    cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuRnr>(0U);
     // ClearExclusiveLocal(ProcessorID()); /* Synchronization (LDREX* / STREX*) monitor support */
+    cpua.GetExclusiveMonitorStates().ClearExclusive();
     // ClearEventRegister(); /* see WFE instruction for more details */
 
     // All registers are UNKNOWN
@@ -33,6 +33,14 @@ public:
       return "SYSTICK_CVR";
     case SpecialRegisterId::kSysTickCalib:
       return "SYSTICK_CALIB";
+    case SpecialRegisterId::kMmfar:
+      return "MMFAR";
+    case SpecialRegisterId::kMpuType:
+      return "MPU_TYPE";
+    case SpecialRegisterId::kMpuCtrl:
+      return "MPU_CTRL";
+    case SpecialRegisterId::kMpuRnr:
+      return "MPU_RNR";
     case SpecialRegisterId::kXpsr:
       return "XPSR";
     default:
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "libmicroemu/exception_type.h"
+#include "libmicroemu/types.h"
+#include <array>
+#include <atomic>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Receives external interrupts from host threads while the machine runs.
+ *
+ * Host threads are the producers, the run loop of the machine is the only consumer. Interrupts
+ * without a time are collected in an atomic bitmask. Interrupts with a virtual time are pushed
+ * to a bounded lock-free queue (one sequence number per cell) and moved to a list of the consumer
+ * when they are drained. Every producer raises a signal flag after its push, so the run loop only
+ * loads one atomic and compares two integers per instruction.
+ */
+class IrqInjector {
+public:
+  static constexpr u32 kCapacity = 256U;
+  static constexpr u64 kNoTime = ~static_cast<u64>(0U);
+
+  /**
+   * @brief Constructor
+   */
+  IrqInjector() noexcept {
+    for (u32 i = 0U; i < kCapacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Sets an external interrupt pending at the next instruction. Thread-safe.
+   * @param irq number of the external interrupt
+   */
+  void Inject(u32 irq) noexcept {
+    pending_.fetch_or(1U << irq, std::memory_order_release);
+    is_signaled_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Sets an external interrupt pending when the virtual time is reached. Thread-safe.
+   * @param irq number of the external interrupt
+   * @param time virtual time
+   * @return true on success, false if the queue is full
+   */
+  bool InjectAt(u32 irq, u64 time) noexcept {
+    u32 pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      auto &cell = cells_[pos % kCapacity];
+      const u32 sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<i32>(sequence - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+          cell.irq = irq;
+          cell.time = time;
+          cell.sequence.store(pos + 1U, std::memory_order_release);
+          is_signaled_.store(true, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Checks if interrupts were injected or a timed interrupt is due.
+   * @param time current virtual time
+   */
+  inline bool IsDue(u64 time) const noexcept {
+    return is_signaled_.load(std::memory_order_relaxed) || (time >= next_time_);
+  }
+
+  /**
+   * @brief Sets all injected interrupts pending whose time is reached.
+   * @tparam TExceptionTrigger used to set interrupts pending
+   * @param cpua the cpu accessor
+   * @param time current virtual time
+   */
+  template <typename TExceptionTrigger, typename TCpuAccessor>
+  void Deliver(TCpuAccessor &cpua, u64 time) noexcept {
+    if (is_signaled_.exchange(false, std::memory_order_acquire)) {
+      u32 pending = pending_.exchange(0U, std::memory_order_acquire);
+      while (pending != 0U) {
+        const u32 irq = CountTrailingZeros(pending);
+        pending &= pending - 1U;
+        SetPending<TExceptionTrigger>(cpua, irq);
+      }
+      Drain();
+    }
+
+    u32 i = 0U;
+    next_time_ = kNoTime;
+    while (i < no_of_timed_) {
+      if (timed_[i].time <= time) {
+        SetPending<TExceptionTrigger>(cpua, timed_[i].irq);
+        timed_[i] = timed_[--no_of_timed_];
+        continue;
+      }
+      next_time_ = (timed_[i].time < next_time_) ? timed_[i].time : next_time_;
+      ++i;
+    }
+  }
+
+  /**
+   * @brief Discards all injected interrupts, e.g. when the virtual time is reset.
+   * Must be called by the consumer.
+   */
+  void Clear() noexcept {
+    pending_.store(0U, std::memory_order_relaxed);
+    is_signaled_.store(false, std::memory_order_relaxed);
+    do {
+      no_of_timed_ = 0U;
+      Drain();
+    } while (no_of_timed_ == kCapacity);
+    no_of_timed_ = 0U;
+    is_signaled_.store(false, std::memory_order_relaxed);
+    next_time_ = kNoTime;
+  }
+
+private:
+  struct Timed {
+    u32 irq;
+    u64 time;
+  };
+
+  struct Cell {
+    std::atomic<u32> sequence;
+    u32 irq;
+    u64 time;
+  };
+
+  static u32 CountTrailingZeros(u32 value) noexcept {
+    u32 count{0U};
+    while ((value & 1U) == 0U) {
+      value >>= 1U;
+      ++count;
+    }
+    return count;
+  }
+
+  template <typename TExceptionTrigger, typename TCpuAccessor>
+  static void SetPending(TCpuAccessor &cpua, u32 irq) noexcept {
+    TExceptionTrigger::SetPending(cpua,
+                                  static_cast<ExceptionType>(CountInternalExceptions() + irq));
+  }
+
+  /// Moves the queued interrupts to the list of the consumer
+  void Drain() noexcept {
+    while (no_of_timed_ < kCapacity) {
+      auto &cell = cells_[dequeue_pos_ % kCapacity];
+      const u32 sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence != dequeue_pos_ + 1U) {
+        return; // empty
+      }
+      timed_[no_of_timed_++] = Timed{cell.irq, cell.time};
+      cell.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+      ++dequeue_pos_;
+    }
+    // The list is full, the remaining cells are drained once interrupts were delivered
+    is_signaled_.store(true, std::memory_order_relaxed);
+  }
+
+  // shared with the producers
+  std::atomic<bool> is_signaled_{false};
+  std::atomic<u32> pending_{0U};
+  alignas(64) std::atomic<u32> enqueue_pos_{0U};
+  std::array<Cell, kCapacity> cells_;
+
+  // owned by the consumer
+  alignas(64) u32 dequeue_pos_{0U};
+  std::array<Timed, kCapacity> timed_{};
+  u32 no_of_timed_{0U};
+  u64 next_time_{kNoTime};
+};
+
+static_assert(std::atomic<u32>::is_always_lock_free, "IRQ injection must be lock-free");
+
+} // namespace libmicroemu::internal
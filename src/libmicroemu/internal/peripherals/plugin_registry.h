@@ -0,0 +1,344 @@
+#pragma once
+
+#include "libmicroemu/exception_type.h"
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/status_code.h"
+#include "libmicroemu/types.h"
+#include <array>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief Holds the peripherals which are attached to the machine at runtime.
+ *
+ * The registry keeps the address ranges sorted, so the peripheral of an address is found by a
+ * bounds check followed by a binary search. It also owns the virtual time and the wake-up time of
+ * every peripheral. The earliest wake-up is cached, so the run loop only compares two integers per
+ * instruction.
+ */
+class PluginRegistry {
+public:
+  static constexpr u32 kMaxPeripherals = 16U;
+  static constexpr i32 kNotFound = -1;
+
+  struct Entry {
+    IPeripheral *peripheral;
+    me_adr_t begin;
+    me_adr_t last; // inclusive
+    u64 wake_up;
+  };
+
+  /**
+   * @brief Constructor
+   */
+  PluginRegistry() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~PluginRegistry() noexcept = default;
+
+  /**
+   * @brief Copy constructor for PluginRegistry.
+   * @param r_src the object to be copied
+   */
+  PluginRegistry(const PluginRegistry &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for PluginRegistry.
+   * @param r_src the object to be copied
+   */
+  PluginRegistry &operator=(const PluginRegistry &r_src) = delete;
+
+  /**
+   * @brief Move constructor for PluginRegistry.
+   * @param r_src the object to be moved
+   */
+  PluginRegistry(PluginRegistry &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for PluginRegistry.
+   * @param r_src the object to be moved
+   */
+  PluginRegistry &operator=(PluginRegistry &&r_src) = delete;
+
+  /**
+   * @brief Adds a peripheral.
+   * @param peripheral the peripheral
+   * @param vadr the virtual start address of its range
+   * @param size size of the range in bytes
+   * @return true on success, false if the range is empty, wraps around, overlaps another
+   * peripheral or no more peripherals can be added
+   */
+  bool Add(IPeripheral *peripheral, me_adr_t vadr, me_size_t size) noexcept {
+    if ((peripheral == nullptr) || (size == 0U) || (no_of_entries_ >= kMaxPeripherals)) {
+      return false;
+    }
+    const me_adr_t last = vadr + (size - 1U);
+    if (last < vadr) {
+      return false;
+    }
+
+    // Insertion sort by start address
+    u32 pos = 0U;
+    while ((pos < no_of_entries_) && (entries_[pos].begin < vadr)) {
+      ++pos;
+    }
+    if ((pos > 0U) && (entries_[pos - 1U].last >= vadr)) {
+      return false;
+    }
+    if ((pos < no_of_entries_) && (entries_[pos].begin <= last)) {
+      return false;
+    }
+    for (u32 i = no_of_entries_; i > pos; --i) {
+      entries_[i] = entries_[i - 1U];
+    }
+    entries_[pos] = Entry{peripheral, vadr, last, kNoWakeUp};
+    ++no_of_entries_;
+
+    lowest_adr_ = entries_[0U].begin;
+    highest_adr_ = entries_[no_of_entries_ - 1U].last;
+    return true;
+  }
+
+  /**
+   * @brief Finds the peripheral which contains the given address.
+   * @param vadr the virtual address
+   * @return index of the peripheral or kNotFound
+   */
+  inline i32 Find(me_adr_t vadr) const noexcept {
+    if ((no_of_entries_ == 0U) || (vadr < lowest_adr_) || (vadr > highest_adr_)) {
+      return kNotFound;
+    }
+    u32 lo = 0U;
+    u32 hi = no_of_entries_;
+    while (lo < hi) {
+      const u32 mid = (lo + hi) / 2U;
+      if (vadr < entries_[mid].begin) {
+        hi = mid;
+      } else if (vadr > entries_[mid].last) {
+        lo = mid + 1U;
+      } else {
+        return static_cast<i32>(mid);
+      }
+    }
+    return kNotFound;
+  }
+
+  /**
+   * @brief Gets the number of bytes from an address up to the next peripheral.
+   * @param vadr the virtual start address
+   * @param size the maximum number of bytes
+   * @return the number of bytes, at most size, which are not mapped by a peripheral
+   */
+  me_size_t GetUnmappedLen(me_adr_t vadr, me_size_t size) const noexcept {
+    for (u32 i = 0U; i < no_of_entries_; ++i) {
+      const auto &entry = entries_[i];
+      if ((vadr >= entry.begin) && (vadr <= entry.last)) {
+        return 0U;
+      }
+      const me_size_t distance = entry.begin - vadr;
+      if (distance < size) {
+        size = distance;
+      }
+    }
+    return size;
+  }
+
+  inline const Entry &GetEntry(i32 idx) const noexcept {
+    return entries_[static_cast<u32>(idx)];
+  }
+
+  inline u32 GetNoOfEntries() const noexcept { return no_of_entries_; }
+
+  inline u64 GetTime() const noexcept { return time_; }
+
+  /**
+   * @brief Advances the virtual time by one instruction.
+   * @return true if a wake-up is due
+   */
+  inline bool AdvanceTime() noexcept {
+    ++time_;
+    return time_ >= next_wake_up_;
+  }
+
+  /**
+   * @brief Sets the wake-up time of a peripheral.
+   * @param idx index of the peripheral
+   * @param time virtual time of the wake-up or kNoWakeUp
+   */
+  void ScheduleWakeUp(i32 idx, u64 time) noexcept {
+    entries_[static_cast<u32>(idx)].wake_up = time;
+    UpdateNextWakeUp();
+  }
+
+  /**
+   * @brief Resets the virtual time and all peripherals.
+   * @tparam TContext context type constructible from (registry, cpu accessor, index, args...)
+   * @param cpua the cpu accessor
+   * @param args further arguments handed to the context, e.g. the bus
+   */
+  template <typename TContext, typename TCpuAccessor, typename... TArgs>
+  void Reset(TCpuAccessor &cpua, TArgs &...args) noexcept {
+    time_ = 0U;
+    for (u32 i = 0U; i < no_of_entries_; ++i) {
+      entries_[i].wake_up = kNoWakeUp;
+    }
+    next_wake_up_ = kNoWakeUp;
+    for (u32 i = 0U; i < no_of_entries_; ++i) {
+      TContext ctx(*this, cpua, static_cast<i32>(i), args...);
+      entries_[i].peripheral->Reset(ctx);
+    }
+  }
+
+  /**
+   * @brief Calls the tick handler of every peripheral whose wake-up time is reached.
+   * @tparam TContext context type constructible from (registry, cpu accessor, index, args...)
+   * @param cpua the cpu accessor
+   * @param args further arguments handed to the context, e.g. the bus
+   * @return kSuccess or the first failing status code returned by a tick handler
+   */
+  template <typename TContext, typename TCpuAccessor, typename... TArgs>
+  StatusCode WakeUp(TCpuAccessor &cpua, TArgs &...args) noexcept {
+    for (u32 i = 0U; i < no_of_entries_; ++i) {
+      auto &entry = entries_[i];
+      if (entry.wake_up > time_) {
+        continue;
+      }
+      entry.wake_up = kNoWakeUp;
+      TContext ctx(*this, cpua, static_cast<i32>(i), args...);
+      const auto sc = entry.peripheral->Tick(ctx);
+      if (sc != StatusCode::kSuccess) {
+        UpdateNextWakeUp();
+        return sc;
+      }
+    }
+    UpdateNextWakeUp();
+    return StatusCode::kSuccess;
+  }
+
+private:
+  void UpdateNextWakeUp() noexcept {
+    next_wake_up_ = kNoWakeUp;
+    for (u32 i = 0U; i < no_of_entries_; ++i) {
+      if (entries_[i].wake_up < next_wake_up_) {
+        next_wake_up_ = entries_[i].wake_up;
+      }
+    }
+  }
+
+  std::array<Entry, kMaxPeripherals> entries_{};
+  u32 no_of_entries_{0U};
+  me_adr_t lowest_adr_{0U};
+  me_adr_t highest_adr_{0U};
+  u64 time_{0U};
+  u64 next_wake_up_{kNoWakeUp};
+};
+
+/**
+ * @brief Context which is handed to the handlers of a runtime peripheral.
+ * @tparam TCpuAccessor the cpu accessor
+ * @tparam TExceptionTrigger used to set interrupts pending
+ */
+template <typename TCpuAccessor, typename TExceptionTrigger>
+class PluginContext : public IPeripheralContext {
+public:
+  using ExcTrig = TExceptionTrigger;
+
+  PluginContext(PluginRegistry &registry, TCpuAccessor &cpua, i32 idx) noexcept
+      : registry_(registry), cpua_(cpua), idx_(idx) {}
+
+  u64 GetTime() const noexcept override { return registry_.GetTime(); }
+
+  void ScheduleWakeUp(u64 time) noexcept override { registry_.ScheduleWakeUp(idx_, time); }
+
+  StatusCode SetIrqPending(u32 irq) noexcept override {
+    if (irq >= kNoOfExternalIrqs) {
+      return StatusCode::kOutOfRange;
+    }
+    ExcTrig::SetPending(cpua_, static_cast<ExceptionType>(CountInternalExceptions() + irq));
+    return StatusCode::kSuccess;
+  }
+
+protected:
+  TCpuAccessor &GetCpuAccessor() const noexcept { return cpua_; }
+
+private:
+  PluginRegistry &registry_;
+  TCpuAccessor &cpua_;
+  i32 idx_;
+};
+
+/**
+ * @brief Context of the reset and tick handlers, which additionally accesses the guest memory.
+ *
+ * The handlers of the bus participant get a PluginContext without memory access, because the bus
+ * type depends on the participant.
+ * @tparam TCpuAccessor the cpu accessor
+ * @tparam TExceptionTrigger used to set interrupts pending
+ * @tparam TBus the memory bus
+ */
+template <typename TCpuAccessor, typename TExceptionTrigger, typename TBus>
+class PluginBusContext : public PluginContext<TCpuAccessor, TExceptionTrigger> {
+public:
+  using Base = PluginContext<TCpuAccessor, TExceptionTrigger>;
+
+  PluginBusContext(PluginRegistry &registry, TCpuAccessor &cpua, i32 idx, const TBus &bus) noexcept
+      : Base(registry, cpua, idx), bus_(bus) {}
+
+  StatusCode ReadValue(me_adr_t vadr, me_size_t size, u32 &value) noexcept override {
+    auto &cpua = Base::GetCpuAccessor();
+    switch (size) {
+    case 1U: {
+      return ToValue(bus_.template Read<u8>(cpua, vadr), value);
+    }
+    case 2U: {
+      return ToValue(bus_.template Read<u16>(cpua, vadr), value);
+    }
+    case 4U: {
+      return ToValue(bus_.template Read<u32>(cpua, vadr), value);
+    }
+    default: {
+      return StatusCode::kMemInaccesible;
+    }
+    }
+  }
+
+  StatusCode WriteValue(me_adr_t vadr, me_size_t size, u32 value) noexcept override {
+    auto &cpua = Base::GetCpuAccessor();
+    switch (size) {
+    case 1U: {
+      return bus_.template Write<u8>(cpua, vadr, static_cast<u8>(value)).status_code;
+    }
+    case 2U: {
+      return bus_.template Write<u16>(cpua, vadr, static_cast<u16>(value)).status_code;
+    }
+    case 4U: {
+      return bus_.template Write<u32>(cpua, vadr, value).status_code;
+    }
+    default: {
+      return StatusCode::kMemInaccesible;
+    }
+    }
+  }
+
+  StatusCode ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) noexcept override {
+    return bus_.ReadBlock(Base::GetCpuAccessor(), vadr, dst, size).status_code;
+  }
+
+  StatusCode WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) noexcept override {
+    return bus_.WriteBlock(Base::GetCpuAccessor(), vadr, src, size).status_code;
+  }
+
+private:
+  template <typename TResult> static StatusCode ToValue(const TResult &res, u32 &value) noexcept {
+    if (res.IsOk()) {
+      value = static_cast<u32>(res.content);
+    }
+    return res.status_code;
+  }
+
+  const TBus &bus_;
+};
+
+} // namespace libmicroemu::internal
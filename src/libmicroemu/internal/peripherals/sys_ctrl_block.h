@@ -4,28 +4,40 @@
 #include "libmicroemu/internal/logic/exceptions_ops.h"
 #include "libmicroemu/internal/utils/bit_manip.h"
 #include "libmicroemu/logger.h"
+#include "libmicroemu/register_details.h"
 #include "libmicroemu/types.h"
 
 namespace libmicroemu ::internal {
 
 enum class SysCtrlBlockAddressMap : me_adr_t {
-  kCpuId = 0xED00, // CPUID Base Register (RO)
-  kIcsr = 0xED04,  // Interrupt Control and State Register (RW)
-  kVtor = 0xED08,  // Vector Table Offset Register (RW)
-  kAircr = 0xED0C, // Application Interrupt and Reset Control Register (RW)
-  kr = 0xED10,     // System Control Register (RW)
-  kCcr = 0xED14,   // Configuration and Control Register (RW)
-  kShpr1 = 0xED18, // System Handler Priority Register 1 (RW)
-  kShpr2 = 0xED1C, // System Handler Priority Register 2 (RW)
-  kShpr3 = 0xED20, // System Handler Priority Register 3 (RW)
-  kShcsr = 0xED24, // System Handler Control and State Register (RW)
-  kCfsr = 0xED28,  // Configurable Fault Status Register (RW)
-  kHfsr = 0xED2C,  // HardFault Status Register (RW)
-  kDfsr = 0xED30,  // Debug Fault Status Register (RW)
-  kMmfar = 0xED34, // MemManage Fault Address Register (RW)
-  kBfar = 0xED38,  // BusFault Address Register (RW)
-  kAfsr = 0xED3C,  // Auxiliary Fault Status Register (RW)
-  kCpacr = 0xED88  // Coprocessor Access Control Register (RW)
+  kCpuId = 0xED00,     // CPUID Base Register (RO)
+  kIcsr = 0xED04,      // Interrupt Control and State Register (RW)
+  kVtor = 0xED08,      // Vector Table Offset Register (RW)
+  kAircr = 0xED0C,     // Application Interrupt and Reset Control Register (RW)
+  kr = 0xED10,         // System Control Register (RW)
+  kCcr = 0xED14,       // Configuration and Control Register (RW)
+  kShpr1 = 0xED18,     // System Handler Priority Register 1 (RW)
+  kShpr2 = 0xED1C,     // System Handler Priority Register 2 (RW)
+  kShpr3 = 0xED20,     // System Handler Priority Register 3 (RW)
+  kShcsr = 0xED24,     // System Handler Control and State Register (RW)
+  kCfsr = 0xED28,      // Configurable Fault Status Register (RW)
+  kHfsr = 0xED2C,      // HardFault Status Register (RW)
+  kDfsr = 0xED30,      // Debug Fault Status Register (RW)
+  kMmfar = 0xED34,     // MemManage Fault Address Register (RW)
+  kBfar = 0xED38,      // BusFault Address Register (RW)
+  kAfsr = 0xED3C,      // Auxiliary Fault Status Register (RW)
+  kCpacr = 0xED88,     // Coprocessor Access Control Register (RW)
+  kMpuType = 0xED90,   // MPU Type Register (RO)
+  kMpuCtrl = 0xED94,   // MPU Control Register (RW)
+  kMpuRnr = 0xED98,    // MPU Region Number Register (RW)
+  kMpuRbar = 0xED9C,   // MPU Region Base Address Register (RW)
+  kMpuRasr = 0xEDA0,   // MPU Region Attribute and Size Register (RW)
+  kMpuRbarA1 = 0xEDA4, // Alias 1 of MPU_RBAR (RW)
+  kMpuRasrA1 = 0xEDA8, // Alias 1 of MPU_RASR (RW)
+  kMpuRbarA2 = 0xEDAC, // Alias 2 of MPU_RBAR (RW)
+  kMpuRasrA2 = 0xEDB0, // Alias 2 of MPU_RASR (RW)
+  kMpuRbarA3 = 0xEDB4, // Alias 3 of MPU_RBAR (RW)
+  kMpuRasrA3 = 0xEDB8  // Alias 3 of MPU_RASR (RW)
 };
 
 template <typename TCpuAccessor, typename TLogger = NullLogger> class SysCtrlBlock {
@@ -91,12 +103,157 @@ public:
     }
   };
 
+  class RegisterAccessMmfar {
+  public:
+    static constexpr auto kAdr = SysCtrlBlockAddressMap::kMmfar;
+    static constexpr bool kUseReadModifyWrite = true; // Perform read before write
+    static constexpr bool kReadOnly = false;          // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      auto read_val = cpua.template ReadSpecialRegister<SpecialRegisterId::kMmfar>();
+      LOG_TRACE(TLogger, "READ MMFAR: 0x%X", read_val);
+      return read_val;
+    }
+
+    static void WriteRegister(TCpuAccessor &cpua, u32 value) {
+      LOG_TRACE(TLogger, "WRITE MMFAR: 0x%X", value);
+      cpua.template WriteSpecialRegister<SpecialRegisterId::kMmfar>(value);
+    }
+  };
+
+  class RegisterAccessMpuType {
+  public:
+    static constexpr auto kAdr = SysCtrlBlockAddressMap::kMpuType;
+    static constexpr bool kUseReadModifyWrite = false; // Perform read before write
+    static constexpr bool kReadOnly = true;            // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      auto read_val = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuType>();
+      LOG_TRACE(TLogger, "READ MPU_TYPE: 0x%X", read_val);
+      return read_val;
+    }
+  };
+
+  class RegisterAccessMpuCtrl {
+  public:
+    static constexpr auto kAdr = SysCtrlBlockAddressMap::kMpuCtrl;
+    static constexpr bool kUseReadModifyWrite = true; // Perform read before write
+    static constexpr bool kReadOnly = false;          // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      auto read_val = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuCtrl>();
+      LOG_TRACE(TLogger, "READ MPU_CTRL: 0x%X", read_val);
+      return read_val;
+    }
+
+    static void WriteRegister(TCpuAccessor &cpua, u32 value) {
+      LOG_TRACE(TLogger, "WRITE MPU_CTRL: 0x%X", value);
+      cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuCtrl>(value &
+                                                                      MpuRegister::kCtrlMsk);
+    }
+  };
+
+  class RegisterAccessMpuRnr {
+  public:
+    static constexpr auto kAdr = SysCtrlBlockAddressMap::kMpuRnr;
+    static constexpr bool kUseReadModifyWrite = true; // Perform read before write
+    static constexpr bool kReadOnly = false;          // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      auto read_val = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuRnr>();
+      LOG_TRACE(TLogger, "READ MPU_RNR: 0x%X", read_val);
+      return read_val;
+    }
+
+    static void WriteRegister(TCpuAccessor &cpua, u32 value) {
+      LOG_TRACE(TLogger, "WRITE MPU_RNR: 0x%X", value);
+      // Region numbers beyond the supported regions are UNPREDICTABLE, wrap them around
+      cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuRnr>(
+          value & (MpuRegister::kNoOfRegions - 1U));
+    }
+  };
+
+  /**
+   * @brief Access to the region base address register of the selected region.
+   * The register is reachable at its own address and at three aliases.
+   */
+  template <SysCtrlBlockAddressMap Adr> class RegisterAccessMpuRbar {
+  public:
+    static constexpr auto kAdr = Adr;
+    static constexpr bool kUseReadModifyWrite = true; // Perform read before write
+    static constexpr bool kReadOnly = false;          // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      const auto rnr = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuRnr>();
+      auto read_val = cpua.ReadSpecialRegister(ToRbarId(rnr)) | rnr;
+      LOG_TRACE(TLogger, "READ MPU_RBAR: 0x%X", read_val);
+      return read_val;
+    }
+
+    static void WriteRegister(TCpuAccessor &cpua, u32 value) {
+      LOG_TRACE(TLogger, "WRITE MPU_RBAR: 0x%X", value);
+      auto rnr = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuRnr>();
+      if ((value & MpuRegister::kRbarValidMsk) != 0U) {
+        // The region field selects the region and updates MPU_RNR
+        rnr = (value & MpuRegister::kRbarRegionMsk) & (MpuRegister::kNoOfRegions - 1U);
+        cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuRnr>(rnr);
+      }
+      cpua.WriteSpecialRegister(ToRbarId(rnr), value & MpuRegister::kRbarAddrMsk);
+    }
+
+  private:
+    static SpecialRegisterId ToRbarId(u32 rnr) {
+      return static_cast<SpecialRegisterId>(static_cast<u32>(SpecialRegisterId::kMpuRbar0) + rnr);
+    }
+  };
+
+  /**
+   * @brief Access to the region attribute and size register of the selected region.
+   * The register is reachable at its own address and at three aliases.
+   */
+  template <SysCtrlBlockAddressMap Adr> class RegisterAccessMpuRasr {
+  public:
+    static constexpr auto kAdr = Adr;
+    static constexpr bool kUseReadModifyWrite = true; // Perform read before write
+    static constexpr bool kReadOnly = false;          // Disable write operation
+
+    static u32 ReadRegister(TCpuAccessor &cpua) {
+      const auto rnr = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuRnr>();
+      auto read_val = cpua.ReadSpecialRegister(ToRasrId(rnr));
+      LOG_TRACE(TLogger, "READ MPU_RASR: 0x%X", read_val);
+      return read_val;
+    }
+
+    static void WriteRegister(TCpuAccessor &cpua, u32 value) {
+      LOG_TRACE(TLogger, "WRITE MPU_RASR: 0x%X", value);
+      const auto rnr = cpua.template ReadSpecialRegister<SpecialRegisterId::kMpuRnr>();
+      cpua.WriteSpecialRegister(ToRasrId(rnr), value & MpuRegister::kRasrMsk);
+    }
+
+  private:
+    static SpecialRegisterId ToRasrId(u32 rnr) {
+      return static_cast<SpecialRegisterId>(static_cast<u32>(SpecialRegisterId::kMpuRasr0) + rnr);
+    }
+  };
+
   static constexpr auto kRegisters =
       // clang-format off
       std::tuple<
         RegisterAccessCcr,
         RegisterAccessCfsr,
-        RegisterAccessBfar
+        RegisterAccessMmfar,
+        RegisterAccessBfar,
+        RegisterAccessMpuType,
+        RegisterAccessMpuCtrl,
+        RegisterAccessMpuRnr,
+        RegisterAccessMpuRbar<SysCtrlBlockAddressMap::kMpuRbar>,
+        RegisterAccessMpuRasr<SysCtrlBlockAddressMap::kMpuRasr>,
+        RegisterAccessMpuRbar<SysCtrlBlockAddressMap::kMpuRbarA1>,
+        RegisterAccessMpuRasr<SysCtrlBlockAddressMap::kMpuRasrA1>,
+        RegisterAccessMpuRbar<SysCtrlBlockAddressMap::kMpuRbarA2>,
+        RegisterAccessMpuRasr<SysCtrlBlockAddressMap::kMpuRasrA2>,
+        RegisterAccessMpuRbar<SysCtrlBlockAddressMap::kMpuRbarA3>,
+        RegisterAccessMpuRasr<SysCtrlBlockAddressMap::kMpuRasrA3>
       >();
   // clang-format on
 
@@ -111,6 +111,12 @@ public:
             (((raw_instr.flags & kRaw32BitMsk) == 0U) && ((instr.nop.flags & k32BitMsk) == 0U))));
 #endif
 
+    // A STREX of a Soc running on private RAM copies is executed after its arbitration
+    if ((instr.id == InstrId::kStrex) && !cpua.GetExclusiveMonitorStates().TakeGrant()) {
+      step_flags |= static_cast<StepFlagsSet>(StepFlags::kStepExclusiveStorePending);
+      return Ok<StepFlagsSet>(step_flags);
+    }
+
     // *** CALLBACK ***
     if (delegates.IsPreExecSet()) {
       const auto is_32bit = (raw_instr.flags & kRaw32BitMsk) == kRaw32BitMsk;
@@ -130,6 +136,9 @@ public:
       ErrorHandler(cpua, r_execute, bus);
       return Err<InstrExecResult, StepFlagsSet>(r_execute);
     }
+    if ((raw_instr.flags & kRaw32BitMsk) != 0U) {
+      step_flags |= static_cast<StepFlagsSet>(StepFlags::kStep32Bit);
+    }
 
     if (delegates.IsPostExecSet()) {
       const auto is_32bit = (raw_instr.flags & kRaw32BitMsk) == kRaw32BitMsk;
@@ -175,17 +184,25 @@ public:
 
   template <typename TResult>
   static void ErrorHandler(TCpuAccessor &cpua, const TResult &res, const TBus &bus) {
-    printf("ERROR: Emulator panic - StatusCode: %s(%i)\n", res.ToString().data(),
-           static_cast<u32>(res.status_code));
+    // Reported to the logger of the machine, never to stdout, so the panics of machines on
+    // different host threads stay apart
+    if constexpr (IS_LOGLEVEL_ERROR_ENABLED) {
+      LOG_ERROR(TLogger, "Emulator panic - StatusCode: %s(%i)", res.ToString().data(),
+                static_cast<u32>(res.status_code));
 
-    // error return
-    const me_adr_t pc = static_cast<me_adr_t>(cpua.template ReadRegister<RegisterId::kPc>());
-    me_adr_t pc_this_instr = static_cast<me_adr_t>(pc - 0x4U);
-    printf(" # System state:\n");
-    printf("   Actual PC: 0x%x\n\n", pc_this_instr);
-    printf(" # Memory dump from PC:\n");
-
-    MemoryViewer<TCpuAccessor, TBus>::Print(cpua, bus, pc_this_instr, 32U, 3U);
+      // error return
+      const me_adr_t pc = static_cast<me_adr_t>(cpua.template ReadRegister<RegisterId::kPc>());
+      me_adr_t pc_this_instr = static_cast<me_adr_t>(pc - 0x4U);
+      LOG_ERROR(TLogger, " # System state:");
+      LOG_ERROR(TLogger, "   Actual PC: 0x%x", pc_this_instr);
+      LOG_ERROR(TLogger, " # Memory dump from PC:");
+
+      MemoryViewer<TCpuAccessor, TBus, TLogger>::Print(cpua, bus, pc_this_instr, 32U, 3U);
+    } else {
+      static_cast<void>(cpua);
+      static_cast<void>(res);
+      static_cast<void>(bus);
+    }
   }
 
 private:
@@ -8,6 +8,8 @@ using StepFlagsSet = u8;
 enum class StepFlags : StepFlagsSet {
   kStepOk = 1U << 0U,
   kStepTerminationRequest = 1U << 1U,
+  kStep32Bit = 1U << 2U, // the executed instruction is 32 bits wide
+  kStepExclusiveStorePending = 1U << 3U, // a STREX waits for its arbitration, nothing executed
 };
 
 } // namespace libmicroemu::internal
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "libmicroemu/internal/utils/const_string_builder.h"
 #include "libmicroemu/internal/utils/memory_helpers.h"
 #include "libmicroemu/logger.h"
+#include "libmicroemu/machine.h"
 #include "libmicroemu/types.h"
 
 #include <string.h>
@@ -81,7 +82,7 @@ constexpr u32 kHandleStdout = 2U;
 constexpr u32 kHandleStderr = 3U;
 constexpr u32 kHandleSemihostFeatures = 4U;
 
-static char kFeatureData[] = {
+static constexpr char kFeatureData[] = {
     0x53U, // Magic Byte 0
     0x48U, // Magic Byte 1
     0x46U, // Magic Byte 2
@@ -94,8 +95,10 @@ class Semihosting : public IBreakpoint {
 public:
   /**
    * @brief Constructs a Semihosting object
+   * @param console receives the console output, printed to stdout if nullptr or empty
    */
-  Semihosting(TCpuAccessor &cpua, TBus bus) : bus_(bus), cpua_(cpua) {}
+  Semihosting(TCpuAccessor &cpua, TBus bus, const FConsoleCallback *console = nullptr)
+      : bus_(bus), cpua_(cpua), console_(console) {}
 
   template <u32 N> Result<std::array<u32, N>> ReadR1Words();
 
@@ -144,7 +147,7 @@ public:
       char buf[kBufferLen];
       // keep one char reserve for null-termination
       MemoryHelpers::CpyFromEmuMem(cpua_, bus_, buf, sizeof(buf) - 1, ptr, w_len);
-      buf[w_len] = '\0';
+      buf[(w_len < sizeof(buf) - 1U) ? w_len : (sizeof(buf) - 1U)] = '\0';
       LOG_DEBUG(TLogger, "kSysOpen(0x%0x) - 0x%0x 0x%0x 0x%0x - '%s'", r0, ptr, mode, w_len, buf);
       u32 result = -1U;
       if (strcmp(buf, ":tt") == 0) {
@@ -176,15 +179,25 @@ public:
         // currently only support Write to stdout and stderr
         return Err<SemihostResult>(StatusCode::kUnsuporrted);
       }
-      char buf[kBufferLen];
-      // keep one char reserve for null-termination
-      TRY(SemihostResult,
-          MemoryHelpers::CpyFromEmuMem(cpua_, bus_, buf, sizeof(buf) - 1, ptr, w_len));
-      buf[w_len] = '\0';
+      LOG_TRACE(TLogger, "kSysWrite(0x%0x)- 0x%0x 0x%0x 0x%0x", r0, fhandle, ptr, w_len);
 
-      LOG_TRACE(TLogger, "kSysWrite(0x%0x)- 0x%0x 0x%0x 0x%0x", r0, fhandle, ptr, w_len, buf);
-      LOG_INFO(TLogger, "stdout << '%s'", buf);
-      printf("%s", buf);
+      // Larger writes are passed on in chunks of the buffer size
+      char buf[kBufferLen];
+      constexpr u32 kMaxChunkLen = kBufferLen - 1U; // keep one char reserve for null-termination
+      for (u32 ofs = 0U; ofs < w_len;) {
+        const u32 chunk_len = (w_len - ofs < kMaxChunkLen) ? (w_len - ofs) : kMaxChunkLen;
+        TRY(SemihostResult,
+            MemoryHelpers::CpyFromEmuMem(cpua_, bus_, buf, sizeof(buf) - 1, ptr + ofs, chunk_len));
+        buf[chunk_len] = '\0';
+
+        LOG_INFO(TLogger, "stdout << '%s'", buf);
+        if ((console_ != nullptr) && *console_) {
+          (*console_)(buf, chunk_len);
+        } else {
+          printf("%s", buf);
+        }
+        ofs += chunk_len;
+      }
 
       // 0 indicates everything is ok
       sh_ret = 0U;
@@ -375,6 +388,7 @@ private:
 
   TBus bus_;
   TCpuAccessor &cpua_;
+  const FConsoleCallback *console_;
   u32 file_id_{0xa};
   i32 status_code_{0U};
   u32 semihost_features_position_{0U};
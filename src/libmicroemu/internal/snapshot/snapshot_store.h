@@ -0,0 +1,379 @@
+#pragma once
+
+#include "libmicroemu/cpu_states.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
+#include "libmicroemu/internal/result.h"
+#include "libmicroemu/types.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief A writable memory segment which takes part in snapshots.
+ */
+struct SnapshotSegment {
+  u8 *buf{nullptr};
+  PageFlagTable *page_flags{nullptr};
+};
+
+/**
+ * @brief Stores a chain of incremental machine snapshots.
+ *
+ * A snapshot consists of the cpu states and the content of all writable memory. The first
+ * snapshot of a chain copies every page. Every following snapshot only stores the pages which
+ * were flagged dirty since the previous snapshot. Restoring a snapshot only copies back the pages
+ * which were written since that snapshot was taken; for each of them the newest copy within the
+ * chain up to the restored snapshot is used.
+ *
+ * Pages of the sparse memory which did not exist when a snapshot was taken are decommitted when
+ * that snapshot is restored.
+ */
+class SnapshotStore {
+public:
+  static constexpr u32 kNoOfSegments = 2U;
+
+  /**
+   * @brief Constructor
+   */
+  SnapshotStore() noexcept = default;
+
+  /**
+   * @brief Destructor
+   */
+  ~SnapshotStore() noexcept = default;
+
+  /**
+   * @brief Copy constructor for SnapshotStore.
+   * @param r_src the object to be copied
+   */
+  SnapshotStore(const SnapshotStore &r_src) = delete;
+
+  /**
+   * @brief Copy assignment operator for SnapshotStore.
+   * @param r_src the object to be copied
+   */
+  SnapshotStore &operator=(const SnapshotStore &r_src) = delete;
+
+  /**
+   * @brief Move constructor for SnapshotStore.
+   * @param r_src the object to be moved
+   */
+  SnapshotStore(SnapshotStore &&r_src) = delete;
+
+  /**
+   * @brief Move assignment operator for SnapshotStore.
+   * @param r_src the object to be moved
+   */
+  SnapshotStore &operator=(SnapshotStore &&r_src) = delete;
+
+  /**
+   * @brief Takes a snapshot and clears all dirty flags.
+   * The pages are counted before the snapshot is allocated. If no host memory is available, the
+   * dirty flags and the stored snapshots are left unchanged.
+   * @param cpu_states the cpu states to store
+   * @param segments the writable memory segments
+   * @param sparse the sparse memory or nullptr if not present
+   * @return the id of the snapshot or kError if no host memory is available
+   */
+  Result<u32> Take(const CpuStates &cpu_states,
+                   const std::array<SnapshotSegment, kNoOfSegments> &segments,
+                   SparsePageStore *sparse) noexcept {
+    return Store(no_of_snapshots_, cpu_states, segments, sparse);
+  }
+
+  /**
+   * @brief Replaces the newest snapshot with a snapshot of the current state.
+   * The new snapshot stores the pages of the replaced one and the pages written since, so the
+   * number of stored snapshots does not grow when a snapshot is moved forward repeatedly.
+   * @param cpu_states the cpu states to store
+   * @param segments the writable memory segments
+   * @param sparse the sparse memory or nullptr if not present
+   * @return the id of the snapshot, kOutOfRange if there is no snapshot or kError if no host
+   * memory is available
+   */
+  Result<u32> ReplaceNewest(const CpuStates &cpu_states,
+                            const std::array<SnapshotSegment, kNoOfSegments> &segments,
+                            SparsePageStore *sparse) noexcept {
+    if (no_of_snapshots_ == 0U) {
+      return Err<u32>(StatusCode::kOutOfRange);
+    }
+    return Store(no_of_snapshots_ - 1U, cpu_states, segments, sparse);
+  }
+
+  /**
+   * @brief Restores a snapshot. All newer snapshots are discarded.
+   * @param snapshot_id id of the snapshot to restore
+   * @param cpu_states the cpu states to overwrite
+   * @param segments the writable memory segments
+   * @param sparse the sparse memory or nullptr if not present
+   * @return Ok on success, kOutOfRange if the snapshot does not exist
+   */
+  Result<void> Restore(u32 snapshot_id, CpuStates &cpu_states,
+                       const std::array<SnapshotSegment, kNoOfSegments> &segments,
+                       SparsePageStore *sparse) noexcept {
+    if (snapshot_id >= no_of_snapshots_) {
+      return Err(StatusCode::kOutOfRange);
+    }
+
+    // Pages written since the newest snapshot
+    for (u32 seg_id = 0U; seg_id < kNoOfSegments; ++seg_id) {
+      const auto &seg = segments[seg_id];
+      if ((seg.buf == nullptr) || (seg.page_flags == nullptr)) {
+        continue;
+      }
+      auto &page_flags = *seg.page_flags;
+      for (me_size_t page = 0U; page < page_flags.GetNoOfPages(); ++page) {
+        if (page_flags.IsSet(page, PageFlags::kDirty)) {
+          RestorePage(snapshot_id, ToKey(seg_id, page), segments, sparse);
+        }
+      }
+      page_flags.ClearAll(PageFlags::kDirty);
+    }
+
+    if (sparse != nullptr) {
+      // Restoring a page only copies it or decommits it, so the page tables stay valid while
+      // they are iterated
+      constexpr auto kDirtyMsk = static_cast<PageFlagsSet>(PageFlags::kDirty);
+      sparse->ForEachPage([&](me_adr_t page_vadr, u8 *, PageFlagsSet &flags) {
+        if ((flags & kDirtyMsk) != 0U) {
+          RestorePage(snapshot_id,
+                      ToKey(kSparseSegmentId, page_vadr >> SparsePageStore::kPageShift), segments,
+                      sparse);
+        }
+      });
+    }
+
+    // Pages written between the restored snapshot and the newest snapshot
+    for (auto i = snapshot_id + 1U; i < no_of_snapshots_; ++i) {
+      const auto &snapshot = snapshots_[i];
+      for (u32 entry_idx = 0U; entry_idx < snapshot.no_of_pages; ++entry_idx) {
+        RestorePage(snapshot_id, snapshot.pages[entry_idx].key, segments, sparse);
+      }
+    }
+    for (auto i = snapshot_id + 1U; i < no_of_snapshots_; ++i) {
+      snapshots_[i].Release();
+    }
+    no_of_snapshots_ = snapshot_id + 1U;
+
+    if (sparse != nullptr) {
+      sparse->ClearAll(PageFlags::kDirty);
+    }
+    cpu_states = snapshots_[snapshot_id].cpu_states;
+    return Ok();
+  }
+
+  /**
+   * @brief Gets the number of stored snapshots.
+   * @return number of snapshots
+   */
+  inline u32 GetNoOfSnapshots() const noexcept { return no_of_snapshots_; }
+
+private:
+  static constexpr u32 kSparseSegmentId = kNoOfSegments;
+
+  struct PageEntry {
+    u64 key;
+    std::size_t data_ofs;
+    me_size_t size;
+  };
+
+  struct Snapshot {
+    bool Allocate(u32 max_pages, std::size_t max_data_size) noexcept {
+      pages.reset(new (std::nothrow) PageEntry[max_pages]);
+      data.reset(new (std::nothrow) u8[max_data_size]);
+      no_of_pages = 0U;
+      data_size = 0U;
+      return (pages != nullptr) && (data != nullptr);
+    }
+
+    void Release() noexcept {
+      pages.reset();
+      data.reset();
+      no_of_pages = 0U;
+      data_size = 0U;
+    }
+
+    void Append(u64 key, const u8 *src, me_size_t size) noexcept {
+      // Pages are appended in ascending key order, which keeps the entries sorted
+      pages[no_of_pages++] = PageEntry{key, data_size, size};
+      std::memcpy(&data[data_size], src, size);
+      data_size += size;
+    }
+
+    const PageEntry *Find(u64 key) const noexcept {
+      const PageEntry *begin = pages.get();
+      const PageEntry *end = begin + no_of_pages;
+      auto it = std::lower_bound(begin, end, key,
+                                 [](const PageEntry &e, u64 k) { return e.key < k; });
+      if ((it == end) || (it->key != key)) {
+        return nullptr;
+      }
+      return it;
+    }
+
+    CpuStates cpu_states;
+    std::unique_ptr<PageEntry[]> pages;
+    u32 no_of_pages{0U};
+    std::unique_ptr<u8[]> data;
+    std::size_t data_size{0U};
+  };
+
+  static me_size_t GetPageSize(const PageFlagTable &page_flags, me_size_t page) noexcept {
+    const me_size_t ofs = page << PageFlagTable::kPageShift;
+    return std::min(PageFlagTable::kPageSize, page_flags.GetMemSize() - ofs);
+  }
+
+  /// Stores a new snapshot at the end of the chain or in place of the newest one. The new
+  /// snapshot is built in the unused slot behind the newest snapshot, so the replaced one stays
+  /// valid while its pages are looked up.
+  Result<u32> Store(u32 snapshot_id, const CpuStates &cpu_states,
+                    const std::array<SnapshotSegment, kNoOfSegments> &segments,
+                    SparsePageStore *sparse) noexcept {
+    // Reserve the slot of the new snapshot first, it may move the stored snapshots
+    if (!Reserve(no_of_snapshots_ + 1U)) {
+      return Err<u32>(StatusCode::kError);
+    }
+    const bool is_full = (snapshot_id == 0U);
+    const Snapshot *replaced =
+        (snapshot_id < no_of_snapshots_) ? &snapshots_[snapshot_id] : nullptr;
+    const auto is_stored = [replaced](u64 key) {
+      return (replaced != nullptr) && (replaced->Find(key) != nullptr);
+    };
+    constexpr auto kDirtyMsk = static_cast<PageFlagsSet>(PageFlags::kDirty);
+
+    // Count the pages to copy
+    u32 no_of_pages{0U};
+    std::size_t data_size{0U};
+    for (u32 seg_id = 0U; seg_id < kNoOfSegments; ++seg_id) {
+      const auto &seg = segments[seg_id];
+      if ((seg.buf == nullptr) || (seg.page_flags == nullptr)) {
+        continue;
+      }
+      const auto &page_flags = *seg.page_flags;
+      for (me_size_t page = 0U; page < page_flags.GetNoOfPages(); ++page) {
+        if (is_full || page_flags.IsSet(page, PageFlags::kDirty) ||
+            is_stored(ToKey(seg_id, page))) {
+          ++no_of_pages;
+          data_size += GetPageSize(page_flags, page);
+        }
+      }
+    }
+    if (sparse != nullptr) {
+      sparse->ForEachPage([&no_of_pages, &data_size, is_full, &is_stored](
+                              me_adr_t page_vadr, u8 *, PageFlagsSet &flags) {
+        if (is_full || ((flags & kDirtyMsk) != 0U) ||
+            is_stored(ToKey(kSparseSegmentId, page_vadr >> SparsePageStore::kPageShift))) {
+          ++no_of_pages;
+          data_size += SparsePageStore::kPageSize;
+        }
+      });
+    }
+
+    auto &snapshot = snapshots_[no_of_snapshots_];
+    if (!snapshot.Allocate(no_of_pages, data_size)) {
+      snapshot.Release();
+      return Err<u32>(StatusCode::kError);
+    }
+    snapshot.cpu_states = cpu_states;
+
+    for (u32 seg_id = 0U; seg_id < kNoOfSegments; ++seg_id) {
+      const auto &seg = segments[seg_id];
+      if ((seg.buf == nullptr) || (seg.page_flags == nullptr)) {
+        continue;
+      }
+      auto &page_flags = *seg.page_flags;
+      for (me_size_t page = 0U; page < page_flags.GetNoOfPages(); ++page) {
+        if (is_full || page_flags.IsSet(page, PageFlags::kDirty) ||
+            is_stored(ToKey(seg_id, page))) {
+          const me_size_t ofs = page << PageFlagTable::kPageShift;
+          snapshot.Append(ToKey(seg_id, page), &seg.buf[ofs], GetPageSize(page_flags, page));
+        }
+      }
+      page_flags.ClearAll(PageFlags::kDirty);
+    }
+
+    if (sparse != nullptr) {
+      sparse->ForEachPage([&snapshot, is_full, &is_stored](me_adr_t page_vadr, u8 *page,
+                                                          PageFlagsSet &flags) {
+        const auto key = ToKey(kSparseSegmentId, page_vadr >> SparsePageStore::kPageShift);
+        if (is_full || ((flags & kDirtyMsk) != 0U) || is_stored(key)) {
+          snapshot.Append(key, page, SparsePageStore::kPageSize);
+        }
+        flags &= static_cast<PageFlagsSet>(~kDirtyMsk);
+      });
+    }
+
+    if (replaced != nullptr) {
+      std::swap(snapshots_[snapshot_id], snapshot);
+      snapshot.Release();
+    } else {
+      ++no_of_snapshots_;
+    }
+    return Ok<u32>(snapshot_id);
+  }
+
+  /// Grows the snapshot array without exceptions
+  bool Reserve(u32 capacity) noexcept {
+    if (capacity <= capacity_) {
+      return true;
+    }
+    const u32 new_capacity = (capacity_ == 0U) ? 8U : capacity_ * 2U;
+    std::unique_ptr<Snapshot[]> snapshots(new (std::nothrow) Snapshot[new_capacity]);
+    if (!snapshots) {
+      return false;
+    }
+    for (u32 i = 0U; i < no_of_snapshots_; ++i) {
+      snapshots[i] = std::move(snapshots_[i]);
+    }
+    snapshots_ = std::move(snapshots);
+    capacity_ = new_capacity;
+    return true;
+  }
+
+  static constexpr u64 ToKey(u32 seg_id, me_size_t page) noexcept {
+    return (static_cast<u64>(seg_id) << 32U) | page;
+  }
+
+  void RestorePage(u32 snapshot_id, u64 key,
+                   const std::array<SnapshotSegment, kNoOfSegments> &segments,
+                   SparsePageStore *sparse) noexcept {
+    const auto seg_id = static_cast<u32>(key >> 32U);
+    const auto page = static_cast<me_size_t>(key);
+
+    // Search the newest copy of the page within the chain
+    for (auto i = static_cast<i64>(snapshot_id); i >= 0; --i) {
+      const auto &snapshot = snapshots_[static_cast<std::size_t>(i)];
+      const auto *entry = snapshot.Find(key);
+      if (entry == nullptr) {
+        continue;
+      }
+      if (seg_id == kSparseSegmentId) {
+        u8 *dst = sparse->CommitPage(page << SparsePageStore::kPageShift);
+        if (dst != nullptr) {
+          std::memcpy(dst, &snapshot.data[entry->data_ofs], entry->size);
+        }
+      } else {
+        u8 *dst = &segments[seg_id].buf[page << PageFlagTable::kPageShift];
+        std::memcpy(dst, &snapshot.data[entry->data_ofs], entry->size);
+      }
+      return;
+    }
+
+    // The first snapshot holds every page of the memory segments. A sparse page which is not
+    // part of the chain did not exist when the snapshot was taken.
+    if ((seg_id == kSparseSegmentId) && (sparse != nullptr)) {
+      sparse->DecommitPage(page << SparsePageStore::kPageShift);
+    }
+  }
+
+  std::unique_ptr<Snapshot[]> snapshots_;
+  u32 no_of_snapshots_{0U};
+  u32 capacity_{0U};
+};
+
+} // namespace libmicroemu::internal
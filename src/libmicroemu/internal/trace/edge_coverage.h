@@ -0,0 +1,47 @@
+#pragma once
+
+#include "libmicroemu/types.h"
+
+namespace libmicroemu::internal {
+
+/**
+ * @brief AFL-style edge coverage map.
+ *
+ * Every taken branch is recorded as the edge between the previous and the current branch target.
+ * The hit counter of an edge is the byte at hash(previous) ^ hash(current) in a bitmap owned by
+ * the host, e.g. the shared memory of an external fuzzer. The previous location is shifted by one
+ * bit, so A->B and B->A as well as A->A and B->B map to different bytes. The counters wrap around
+ * like the ones of AFL.
+ */
+class EdgeCoverage {
+public:
+  /**
+   * @brief Constructor
+   * @param bitmap the bitmap which receives the hit counters
+   * @param size size of the bitmap in bytes, a power of two
+   */
+  EdgeCoverage(u8 *bitmap, me_size_t size) noexcept : bitmap_(bitmap), mask_(size - 1U) {}
+
+  /**
+   * @brief Records the edge from the previous branch target to the given one.
+   * @param target the address the processor branched to
+   */
+  inline void AddEdge(me_adr_t target) noexcept {
+    // Same location hash as the QEMU mode of AFL
+    const u32 location = ((target >> 4U) ^ (target << 8U)) & mask_;
+    ++bitmap_[location ^ prev_location_];
+    prev_location_ = location >> 1U;
+  }
+
+  /**
+   * @brief Forgets the previous branch target, e.g. before a new fuzz input is run.
+   */
+  void ResetLocation() noexcept { prev_location_ = 0U; }
+
+private:
+  u8 *bitmap_;
+  u32 mask_;
+  u32 prev_location_{0U};
+};
+
+} // namespace libmicroemu::internal
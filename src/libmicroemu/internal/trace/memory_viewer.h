@@ -5,14 +5,17 @@
 #pragma once
 
 #include "libmicroemu/types.h"
-#include <ctype.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
 
 namespace libmicroemu::internal {
 
-template <typename TCpuAccessor, typename TBus> class MemoryViewer {
+template <typename TCpuAccessor, typename TBus, typename TLogger> class MemoryViewer {
 public:
   /**
-   * @brief Print memory content to the console.
+   * @brief Logs memory content line by line at error level.
    * @param cpua the processor states
    * @param mem the memory bus
    * @param vadr the virtual address to start printing from
@@ -22,20 +25,23 @@ public:
   static void Print(TCpuAccessor &cpua, const TBus &mem, const me_offset_t vadr,
                     const me_size_t size, const u32 indent = 0U) {
     const me_adr_t vadr_end = vadr + size;
-    const auto alignment = 16U;
 
-    const me_size_t no_filler_bytes = vadr % alignment;
-    const me_adr_t vadr_filler = vadr - no_filler_bytes;
-
-    // in case of addresses which do not fit into the alignment print
-    // out the address and filler spaces
-    if (no_filler_bytes > 0U) {
-
-      PrintSection(cpua, mem, vadr_filler, vadr_filler + no_filler_bytes, alignment, indent, true);
+    // Lines start at aligned addresses, bytes before vadr are filled with spaces
+    for (me_adr_t line_vadr = vadr - (vadr % kAlignment); line_vadr < vadr_end;
+         line_vadr += kAlignment) {
+      std::array<char, kMaxLineSize> line{};
+      std::size_t len = Append(line, 0U, "%*s%08x|", static_cast<int>(indent), "", line_vadr);
+      for (me_adr_t ivadr = line_vadr; (ivadr < line_vadr + kAlignment) && (ivadr < vadr_end);
+           ++ivadr) {
+        if (ivadr < vadr) {
+          len = Append(line, len, "   ");
+          continue;
+        }
+        auto res = mem.template Read<u8>(cpua, ivadr);
+        len = res.IsErr() ? Append(line, len, "xx ") : Append(line, len, "%02x ", res.content);
+      }
+      TLogger::Error("%s", line.data());
     }
-
-    PrintSection(cpua, mem, vadr, vadr_end, alignment, indent, false);
-    printf("\n");
   }
 
 private:
@@ -67,40 +73,21 @@ private:
    */
   MemoryViewer &operator=(MemoryViewer &&r_src) = delete;
 
-  static void PrintSection(TCpuAccessor &cpua, const TBus &mem, const me_adr_t vadr_begin,
-                           const me_adr_t vadr_end, const u32 alignment, u32 indent,
-                           bool skip_read) {
-
-    for (me_adr_t ivadr = vadr_begin; ivadr < vadr_end; ivadr++) {
-      // Print address first
-      if (ivadr % alignment == 0U) {
-        for (u32 spaces = 0U; spaces < indent; ++spaces) {
-          printf(" ");
-        }
-        printf("%08x|", ivadr);
-      }
-
-      // Then the byte
-      if (!skip_read) {
-        auto res = mem.template Read<u8>(cpua, ivadr);
-        if (res.IsErr()) {
-          printf("xx");
-        } else {
-          printf("%02x", res.content);
-        }
-      } else {
-        printf("  ");
-      }
-
-      // Following by an delimiter
-      printf(" ");
+  static constexpr me_adr_t kAlignment = 16U;
+  static constexpr std::size_t kMaxLineSize = 128U;
 
-      // After x bytes add a newline
-      // ... special condition do not add newline at the end
-      if ((ivadr % alignment == alignment - 1) && (ivadr != vadr_end - 1)) {
-        printf("\n");
-      }
+  /// Appends to the line, output which does not fit is cut off
+  template <typename... Args>
+  static std::size_t Append(std::array<char, kMaxLineSize> &line, std::size_t len,
+                            const char *format, Args... args) noexcept {
+    if (len >= line.size() - 1U) {
+      return len;
+    }
+    const int written = snprintf(&line[len], line.size() - len, format, args...);
+    if (written < 0) {
+      return len;
     }
+    return std::min(len + static_cast<std::size_t>(written), line.size() - 1U);
   }
 };
 
@@ -33,35 +33,19 @@ public:
   static Result<void> CpyFromEmuMem(TCpuStates &cpua, TBus &bus, char *dest_ptr,
                                     std::size_t dest_len, me_adr_t src_ptr, me_size_t src_len) {
     auto res_len = src_len <= dest_len ? src_len : dest_len;
-
-    for (u32 i = 0U; i < res_len; ++i) {
-      auto r_ch = bus.template Read<u8>(cpua, src_ptr);
-      if (r_ch.IsErr()) {
-        return Err<u8, void>(r_ch);
-      };
-      const auto &ch = r_ch.content;
-      dest_ptr[i] = ch;
-      src_ptr++;
-    }
-
+    TRY(void, bus.ReadBlock(cpua, src_ptr, reinterpret_cast<u8 *>(dest_ptr),
+                            static_cast<me_size_t>(res_len)));
     return Ok();
   }
 
   // @brief Copies data from an local array to an memory address used by the emulator.
   template <typename TCpuStates, typename TBus>
   static Result<u32> CpyToEmuMem(TCpuStates &cpua, TBus &bus, me_adr_t dest_ptr, me_size_t dest_len,
-                                 char *src_ptr, std::size_t src_len) {
+                                 const char *src_ptr, std::size_t src_len) {
     auto res_len = dest_len <= src_len ? dest_len : src_len;
-
-    for (u32 i = 0U; i < res_len; ++i) {
-      auto r_ch = bus.template Write<u8>(cpua, dest_ptr, src_ptr[i]);
-      if (r_ch.IsErr()) {
-        return Err<void, u32>(r_ch);
-      };
-      dest_ptr++;
-    }
-
-    return Ok<u32>(res_len);
+    TRY(u32, bus.WriteBlock(cpua, dest_ptr, reinterpret_cast<const u8 *>(src_ptr),
+                            static_cast<me_size_t>(res_len)));
+    return Ok<u32>(static_cast<u32>(res_len));
   }
 
 private:
@@ -2,4 +2,5 @@
 #include "libmicroemu/logger.h"
 using namespace libmicroemu;
 
-void (*StaticLogger::callback_)(libmicroemu::LogLevel level, const char *, ...) noexcept;
+thread_local FLoggerCallback StaticLogger::callback_{nullptr};
+thread_local void *StaticLogger::user_data_{nullptr};
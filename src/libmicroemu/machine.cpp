@@ -1,33 +1,108 @@
 #include "libmicroemu/machine.h"
+#include "libmicroemu/internal/bus/access_monitor.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
 #include "libmicroemu/internal/elf/elf_reader.h"
 #include "libmicroemu/internal/emulator.h"
+#include "libmicroemu/internal/peripherals/irq_injector.h"
+#include "libmicroemu/internal/peripherals/plugin_registry.h"
+#include "libmicroemu/internal/snapshot/snapshot_store.h"
+#include "libmicroemu/internal/trace/edge_coverage.h"
 #include "libmicroemu/internal/trace/intstr_to_mnemonic.h"
 #include "libmicroemu/version.h"
+#include <atomic>
 #include <ctype.h>
 #include <fstream>
 #include <iostream>
+#include <new>
 #include <utility>
+#include <vector>
 
 namespace libmicroemu {
 
 using namespace internal;
 
+static std::atomic<FLoggerCallback> default_logger_callback{nullptr};
+static std::atomic<void *> default_logger_user_data{nullptr};
+
+static StatusCode LoadSegmentToSparseMemory(ElfReader &reader, const Elf32_Phdr &phdr,
+                                            SparsePageStore &sparse) noexcept {
+  if (phdr.p_filesz == 0U) {
+    return StatusCode::kSuccess;
+  }
+  auto segment = std::vector<u8>(phdr.p_filesz);
+  auto res = reader.GetSegmentData(phdr, segment.data(), phdr.p_filesz, 0x0, 0x0);
+  if (res.IsErr()) {
+    return res.status_code;
+  }
+  if (!sparse.Store(static_cast<me_adr_t>(phdr.p_vaddr), segment.data(), phdr.p_filesz)) {
+    return StatusCode::kError;
+  }
+  return StatusCode::kSuccess;
+}
+
 Emulator<CpuStates> Machine::BuildEmulator() {
   auto emu = Emulator<CpuStates>(cpu_states_);
 
   emu.SetFlashSegment(flash_, flash_size_, flash_vadr_);
-  emu.SetRam1Segment(ram1_, ram1_size_, ram1_vadr_);
-  emu.SetRam2Segment(ram2_, ram2_size_, ram2_vadr_);
+  emu.SetRam1Segment(ram1_, ram1_size_, ram1_vadr_,
+                     ram1_page_flags_ ? ram1_page_flags_->GetRaw() : nullptr);
+  emu.SetRam2Segment(ram2_, ram2_size_, ram2_vadr_,
+                     ram2_page_flags_ ? ram2_page_flags_->GetRaw() : nullptr);
+  emu.SetSparseMemory(sparse_.get());
+  emu.SetPluginRegistry(plugins_.get());
+  emu.SetAccessMonitor(monitor_.get());
+  emu.SetBusStatistics(&bus_stats_);
+  emu.SetConsoleCallback(&console_callback_);
+  emu.SetStopRequest(&is_stop_requested_);
+  emu.SetEdgeCoverage(coverage_.get());
+  emu.SetIrqInjector(irqs_.get());
   return emu;
 }
 
 Machine::Machine() noexcept {};
 Machine::~Machine() noexcept {};
 
-StatusCode Machine::Load(const char *elf_file, bool set_entry_point) noexcept {
+void Machine::PrepareLoad() noexcept {
+  DiscardSnapshots();
+  ReleasePageFlags();
+  ResetBusStatistics();
+
+  if (!lazy_ram_fill_ || (PrepareLazyRamFill() != StatusCode::kSuccess)) {
+    // Fall back to filling the whole RAM if the page flags cannot be allocated
+    ReleasePageFlags();
+    if (!is_ram1_external_) {
+      std::fill(ram1_, ram1_ + ram1_size_, kUninitializedPattern);
+    }
+    if (!is_ram2_external_) {
+      std::fill(ram2_, ram2_ + ram2_size_, kUninitializedPattern);
+    }
+  }
+  if (sparse_) {
+    sparse_->Release();
+  }
+}
+
+StatusCode Machine::FinishLoad(u32 entry_point, bool set_entry_point) noexcept {
+  auto sc_reset = Reset();
+  if (sc_reset != StatusCode::kSuccess) {
+    return sc_reset;
+  }
+
+  if (set_entry_point) {
+    auto emu = BuildEmulator();
+    emu.SetEntryPoint(entry_point);
+  }
+  return StatusCode::kSuccess;
+}
 
-  std::fill(ram1_, ram1_ + ram1_size_, 0xFFU);
-  std::fill(ram2_, ram2_ + ram2_size_, 0xFFU);
+StatusCode Machine::Load(const char *elf_file, bool set_entry_point) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
+  if ((flash_ != nullptr) && (writable_flash_ == nullptr)) {
+    // The flash of a firmware image is shared with other machines and must not be overwritten
+    return StatusCode::kUnsuporrted;
+  }
+  PrepareLoad();
 
   u32 entry_point{0U};
   {
@@ -51,10 +126,17 @@ StatusCode Machine::Load(const char *elf_file, bool set_entry_point) noexcept {
       if (((flags & PF_X) != 0U) && ((flags & PF_R) != 0U) && ((flags & PF_W) == 0U)) {
         if ((phdr.p_vaddr < flash_vadr_) ||
             (phdr.p_vaddr + phdr.p_filesz >= flash_vadr_ + flash_size_)) {
+          if (sparse_) {
+            auto sc_sparse = LoadSegmentToSparseMemory(reader, phdr, *sparse_);
+            if (sc_sparse != StatusCode::kSuccess) {
+              return sc_sparse;
+            }
+            continue;
+          }
           // size of buffer is not big enough
           return StatusCode::kBufferTooSmall;
         }
-        auto res = reader.GetSegmentData(phdr, flash_, phdr.p_filesz, 0x0, 0x0);
+        auto res = reader.GetSegmentData(phdr, writable_flash_, phdr.p_filesz, 0x0, 0x0);
         if (res.IsErr()) {
           return res.status_code;
         }
@@ -64,10 +146,21 @@ StatusCode Machine::Load(const char *elf_file, bool set_entry_point) noexcept {
       if (((flags & PF_X) == 0U) && ((flags & PF_R) != 0U) && ((flags & PF_W) != 0U)) {
         if ((phdr.p_vaddr < ram1_vadr_) ||
             (phdr.p_vaddr + phdr.p_filesz >= ram1_vadr_ + ram1_size_)) {
+          if (sparse_) {
+            auto sc_sparse = LoadSegmentToSparseMemory(reader, phdr, *sparse_);
+            if (sc_sparse != StatusCode::kSuccess) {
+              return sc_sparse;
+            }
+            continue;
+          }
           // size of buffer is not big enough
           return StatusCode::kBufferTooSmall;
         }
         auto data_seg_vadr = static_cast<me_adr_t>(phdr.p_vaddr);
+        if (ram1_page_flags_ && (phdr.p_filesz > 0U)) {
+          PageFlagTable::FillUnfilled(ram1_page_flags_->GetRaw(), ram1_, ram1_size_,
+                                      data_seg_vadr - ram1_vadr_, phdr.p_filesz);
+        }
 
         auto res = reader.GetSegmentData(phdr, ram1_, phdr.p_filesz, ram1_vadr_, data_seg_vadr);
         if (res.IsErr()) {
@@ -80,37 +173,365 @@ StatusCode Machine::Load(const char *elf_file, bool set_entry_point) noexcept {
     entry_point = reader.GetEntryPoint();
   }
 
-  auto sc_reset = Reset();
-  if (sc_reset != StatusCode::kSuccess) {
-    return sc_reset;
+  return FinishLoad(entry_point, set_entry_point);
+}
+
+StatusCode Machine::Load(const FirmwareImage &image, bool set_entry_point) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
+  if (!image.IsLoaded()) {
+    return StatusCode::kUnsuporrted;
   }
+  // The flash is borrowed from the image, the bus only reads it
+  flash_ = image.GetFlash();
+  writable_flash_ = nullptr;
+  flash_size_ = image.GetFlashSize();
+  flash_vadr_ = image.GetFlashVadr();
+  PrepareLoad();
 
-  if (set_entry_point) {
-    auto emu = BuildEmulator();
-    emu.SetEntryPoint(entry_point);
+  for (u32 i = 0U; i < image.no_of_segments_; ++i) {
+    const auto &segment = image.segments_[i];
+    const auto size = segment.size;
+    if (!segment.is_code && (segment.vadr >= ram1_vadr_) &&
+        (segment.vadr + size < ram1_vadr_ + ram1_size_)) {
+      if (ram1_page_flags_ && (size > 0U)) {
+        PageFlagTable::FillUnfilled(ram1_page_flags_->GetRaw(), ram1_, ram1_size_,
+                                    segment.vadr - ram1_vadr_, size);
+      }
+      std::copy(segment.data.get(), segment.data.get() + size, ram1_ + (segment.vadr - ram1_vadr_));
+      continue;
+    }
+    if (!sparse_) {
+      // size of buffer is not big enough
+      return StatusCode::kBufferTooSmall;
+    }
+    if ((size > 0U) && !sparse_->Store(segment.vadr, segment.data.get(), size)) {
+      return StatusCode::kError;
+    }
   }
-  return StatusCode::kSuccess;
+
+  return FinishLoad(image.GetEntryPoint(), set_entry_point);
 }
 
 void Machine::SetFlashSegment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept {
   flash_ = seg_ptr;
+  writable_flash_ = seg_ptr;
   flash_size_ = seg_size;
   flash_vadr_ = seg_vadr;
 }
 
-void Machine::SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+void Machine::SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                             bool is_external) noexcept {
+  DiscardSnapshots();
+  ReleasePageFlags();
   ram1_ = seg_ptr;
   ram1_size_ = seg_size;
   ram1_vadr_ = seg_vadr;
+  is_ram1_external_ = is_external;
 }
 
-void Machine::SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+void Machine::SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                             bool is_external) noexcept {
+  DiscardSnapshots();
+  ReleasePageFlags();
   ram2_ = seg_ptr;
   ram2_size_ = seg_size;
   ram2_vadr_ = seg_vadr;
+  is_ram2_external_ = is_external;
+}
+
+StatusCode Machine::EnableSparseMemory() noexcept {
+  if (sparse_) {
+    return StatusCode::kSuccess;
+  }
+  DiscardSnapshots();
+  sparse_.reset(new (std::nothrow) SparsePageStore());
+  if (!sparse_) {
+    return StatusCode::kError;
+  }
+  return StatusCode::kSuccess;
+}
+
+void Machine::SetLazyRamFill(bool enable) noexcept { lazy_ram_fill_ = enable; }
+
+StatusCode Machine::PrepareLazyRamFill() noexcept {
+  ram1_page_flags_.reset(new (std::nothrow) PageFlagTable());
+  ram2_page_flags_.reset(new (std::nothrow) PageFlagTable());
+  if (!ram1_page_flags_ || !ram2_page_flags_ || !ram1_page_flags_->Allocate(ram1_size_) ||
+      !ram2_page_flags_->Allocate(ram2_size_)) {
+    return StatusCode::kError;
+  }
+  // External segments keep the content of the host, their pages are never filled
+  if (!is_ram1_external_) {
+    ram1_page_flags_->SetAll(PageFlags::kUnfilled);
+  }
+  if (!is_ram2_external_) {
+    ram2_page_flags_->SetAll(PageFlags::kUnfilled);
+  }
+  has_lazy_ram_ = true;
+  return StatusCode::kSuccess;
+}
+
+void Machine::ReleasePageFlags() noexcept {
+  has_lazy_ram_ = false;
+  ram1_page_flags_.reset();
+  ram2_page_flags_.reset();
+}
+
+void Machine::DisableSparseMemory() noexcept {
+  DiscardSnapshots();
+  sparse_.reset();
+}
+
+StatusCode Machine::AddUnmappedRegion(me_adr_t vadr, me_size_t size) noexcept {
+  if (!sparse_) {
+    return StatusCode::kUnsuporrted;
+  }
+  if (!sparse_->AddFaultRegion(vadr, size)) {
+    return StatusCode::kOutOfRange;
+  }
+  return StatusCode::kSuccess;
+}
+
+u64 Machine::GetSparseMemoryFootprint() const noexcept {
+  if (!sparse_) {
+    return 0U;
+  }
+  return sparse_->GetCommittedBytes();
+}
+
+StatusCode Machine::AttachPeripheral(IPeripheral *peripheral, me_adr_t vadr,
+                                     me_size_t size) noexcept {
+  if (!plugins_) {
+    plugins_.reset(new (std::nothrow) PluginRegistry());
+    if (!plugins_) {
+      return StatusCode::kError;
+    }
+  }
+  if (!plugins_->Add(peripheral, vadr, size)) {
+    return StatusCode::kOutOfRange;
+  }
+  return StatusCode::kSuccess;
+}
+
+void Machine::DetachPeripherals() noexcept {
+  plugins_.reset();
+  if (irqs_) {
+    // Keeps the virtual time of the injected interrupts running
+    plugins_.reset(new (std::nothrow) PluginRegistry());
+  }
+}
+
+u64 Machine::GetVirtualTime() const noexcept {
+  if (!plugins_) {
+    return 0U;
+  }
+  return plugins_->GetTime();
+}
+
+StatusCode Machine::EnableIrqInjection() noexcept {
+  if (irqs_) {
+    return StatusCode::kSuccess;
+  }
+  // The registry owns the virtual time of timed injections
+  if (!plugins_) {
+    plugins_.reset(new (std::nothrow) PluginRegistry());
+    if (!plugins_) {
+      return StatusCode::kError;
+    }
+  }
+  irqs_.reset(new (std::nothrow) IrqInjector());
+  if (!irqs_) {
+    return StatusCode::kError;
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::InjectIrq(u32 irq) noexcept {
+  if (!irqs_) {
+    return StatusCode::kUnsuporrted;
+  }
+  if (irq >= kNoOfExternalIrqs) {
+    return StatusCode::kOutOfRange;
+  }
+  irqs_->Inject(irq);
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::InjectIrqAt(u32 irq, u64 time) noexcept {
+  if (!irqs_) {
+    return StatusCode::kUnsuporrted;
+  }
+  if (irq >= kNoOfExternalIrqs) {
+    return StatusCode::kOutOfRange;
+  }
+  if (!irqs_->InjectAt(irq, time)) {
+    return StatusCode::kBufferTooSmall;
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::PrepareAccessMonitor() noexcept {
+  if (!monitor_) {
+    monitor_.reset(new (std::nothrow) AccessMonitor());
+    if (!monitor_) {
+      return StatusCode::kError;
+    }
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::AddWatchpoint(me_adr_t vadr, me_size_t size, WatchFlagsSet flags, u32 &id,
+                                  u32 match_value) noexcept {
+  const auto sc = PrepareAccessMonitor();
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  return monitor_->AddWatchpoint(vadr, size, flags, match_value, id);
+}
+
+StatusCode Machine::RemoveWatchpoint(u32 id) noexcept {
+  if (!monitor_) {
+    return StatusCode::kOutOfRange;
+  }
+  return monitor_->RemoveWatchpoint(id);
+}
+
+void Machine::ClearWatchpoints() noexcept {
+  if (monitor_) {
+    monitor_->ClearWatchpoints();
+  }
+}
+
+StatusCode Machine::SetWatchpointCallback(FWatchpointCallback cb) noexcept {
+  const auto sc = PrepareAccessMonitor();
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  monitor_->SetWatchpointCallback(std::move(cb));
+  return StatusCode::kSuccess;
+}
+
+bool Machine::GetLastWatchpointHit(WatchpointHit &hit) const noexcept {
+  if (!monitor_) {
+    return false;
+  }
+  return monitor_->GetLastWatchpointHit(hit);
+}
+
+StatusCode Machine::EnableMpu() noexcept {
+  const auto sc = PrepareAccessMonitor();
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  auto &cpua = static_cast<Emulator<CpuStates>::CpuAccessor &>(cpu_states_);
+  cpua.template WriteSpecialRegister<SpecialRegisterId::kMpuType>(
+      MpuRegister::kNoOfRegions << MpuRegister::kTypeDRegionPos);
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::SetStackGuard(StackGuardId id, me_adr_t stack_limit,
+                                  me_size_t size) noexcept {
+  const auto sc = PrepareAccessMonitor();
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  return monitor_->SetStackGuard(id, stack_limit, size);
+}
+
+void Machine::ClearStackGuards() noexcept {
+  if (monitor_) {
+    monitor_->ClearStackGuards();
+  }
+}
+
+StatusCode Machine::SetStackGuardAction(StackGuardAction action) noexcept {
+  const auto sc = PrepareAccessMonitor();
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  monitor_->SetStackGuardAction(action);
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::TakeSnapshot(u32 &snapshot_id) noexcept {
+  if (!snapshots_) {
+    // Start tracking written pages with the first snapshot
+    snapshots_.reset(new (std::nothrow) SnapshotStore());
+    if (!snapshots_) {
+      return StatusCode::kError;
+    }
+    if (has_lazy_ram_) {
+      // Restored pages must not be overwritten by a late fill
+      ram1_page_flags_->FillAllUnfilled(ram1_);
+      ram2_page_flags_->FillAllUnfilled(ram2_);
+    } else {
+      ram1_page_flags_.reset(new (std::nothrow) PageFlagTable());
+      ram2_page_flags_.reset(new (std::nothrow) PageFlagTable());
+      if (!ram1_page_flags_ || !ram2_page_flags_ || !ram1_page_flags_->Allocate(ram1_size_) ||
+          !ram2_page_flags_->Allocate(ram2_size_)) {
+        DiscardSnapshots();
+        return StatusCode::kError;
+      }
+    }
+  }
+
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{
+      SnapshotSegment{ram1_, ram1_page_flags_.get()},
+      SnapshotSegment{ram2_, ram2_page_flags_.get()}};
+  const auto res = snapshots_->Take(cpu_states_, segments, sparse_.get());
+  if (res.IsErr()) {
+    return res.status_code;
+  }
+  snapshot_id = res.content;
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::ReplaceNewestSnapshot(u32 &snapshot_id) noexcept {
+  if (!snapshots_ || (snapshots_->GetNoOfSnapshots() == 0U)) {
+    return StatusCode::kOutOfRange;
+  }
+  if (has_golden_state_ && (golden_snapshot_id_ + 1U == snapshots_->GetNoOfSnapshots())) {
+    return StatusCode::kUnsuporrted;
+  }
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{
+      SnapshotSegment{ram1_, ram1_page_flags_.get()},
+      SnapshotSegment{ram2_, ram2_page_flags_.get()}};
+  const auto res = snapshots_->ReplaceNewest(cpu_states_, segments, sparse_.get());
+  if (res.IsErr()) {
+    return res.status_code;
+  }
+  snapshot_id = res.content;
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::RestoreSnapshot(u32 snapshot_id) noexcept {
+  if (!snapshots_) {
+    return StatusCode::kOutOfRange;
+  }
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{
+      SnapshotSegment{ram1_, ram1_page_flags_.get()},
+      SnapshotSegment{ram2_, ram2_page_flags_.get()}};
+  const auto res = snapshots_->Restore(snapshot_id, cpu_states_, segments, sparse_.get());
+  if (res.IsErr()) {
+    return res.status_code;
+  }
+  return StatusCode::kSuccess;
+}
+
+void Machine::DiscardSnapshots() noexcept {
+  has_golden_state_ = false;
+  snapshots_.reset();
+  if (has_lazy_ram_) {
+    // The page flags still track the pages which are not yet filled
+    ram1_page_flags_->ClearAll(PageFlags::kDirty);
+    ram2_page_flags_->ClearAll(PageFlags::kDirty);
+  } else {
+    ReleasePageFlags();
+  }
 }
 
 StatusCode Machine::Reset() noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
   auto emu = BuildEmulator();
   const auto res_reset = emu.Reset();
 
@@ -120,15 +541,97 @@ StatusCode Machine::Reset() noexcept {
   return StatusCode::kSuccess;
 }
 
+StatusCode Machine::SetVectorTable(me_adr_t vadr) noexcept {
+  if ((vadr & 0x7FU) != 0U) {
+    return StatusCode::kOutOfRange;
+  }
+  auto &cpua = static_cast<Emulator<CpuStates>::CpuAccessor &>(cpu_states_);
+  cpua.template WriteSpecialRegister<SpecialRegisterId::kVtor>(vadr >> 7U);
+  return StatusCode::kSuccess;
+}
+
 ExecResult Machine::Exec(i64 instr_limit, FPreExecStepCallback cb_pre_exec,
                          FPostExecStepCallback cb_post_exec) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
   auto emu = BuildEmulator();
+  if (coverage_) {
+    return emu.Exec<false, true>(instr_limit, cb_pre_exec, cb_post_exec);
+  }
   auto res = emu.Exec(instr_limit, cb_pre_exec, cb_post_exec);
   return res;
 }
 
-void Machine::EvaluateState(FStateCallback cb) noexcept {
+ExecResult Machine::ExecUntil(me_adr_t stop_adr, i64 instr_limit, FPreExecStepCallback cb_pre_exec,
+                              FPostExecStepCallback cb_post_exec) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
+  // Function addresses of the symbol table have the thumb bit set
+  stop_adr &= ~0x1U;
+  auto emu = BuildEmulator();
+  if (coverage_) {
+    return emu.Exec<true, true>(instr_limit, cb_pre_exec, cb_post_exec, stop_adr);
+  }
+  auto res = emu.Exec<true>(instr_limit, cb_pre_exec, cb_post_exec, stop_adr);
+  return res;
+}
+
+StatusCode Machine::SetCoverageMap(u8 *bitmap, me_size_t size) noexcept {
+  if (bitmap == nullptr) {
+    coverage_.reset();
+    return StatusCode::kSuccess;
+  }
+  if ((size == 0U) || ((size & (size - 1U)) != 0U)) {
+    return StatusCode::kOutOfRange;
+  }
+  coverage_.reset(new (std::nothrow) EdgeCoverage(bitmap, size));
+  if (!coverage_) {
+    return StatusCode::kError;
+  }
+  return StatusCode::kSuccess;
+}
+
+void Machine::ResetCoverageLocation() noexcept {
+  if (coverage_) {
+    coverage_->ResetLocation();
+  }
+}
 
+StatusCode Machine::CaptureGoldenState() noexcept {
+  // The golden state always starts a new snapshot chain
+  DiscardSnapshots();
+
+  u32 snapshot_id{0U};
+  const auto sc = TakeSnapshot(snapshot_id);
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  golden_snapshot_id_ = snapshot_id;
+  has_golden_state_ = true;
+  return StatusCode::kSuccess;
+}
+
+StatusCode Machine::CaptureGoldenStateAt(me_adr_t stop_adr, i64 max_instructions) noexcept {
+  const auto exec_res = ExecUntil(stop_adr, max_instructions);
+  if (exec_res.IsOk()) {
+    // The program terminated before the address was reached
+    return StatusCode::kOutOfRange;
+  }
+  if (!exec_res.IsStopAddressReached()) {
+    return exec_res.GetStatusCode();
+  }
+  return CaptureGoldenState();
+}
+
+StatusCode Machine::ResetToGoldenState() noexcept {
+  if (!has_golden_state_) {
+    return StatusCode::kUnsuporrted;
+  }
+  return RestoreSnapshot(golden_snapshot_id_);
+}
+
+bool Machine::HasGoldenState() const noexcept { return has_golden_state_; }
+
+void Machine::EvaluateState(FStateCallback cb) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
   auto emu = BuildEmulator();
   using TCpuAccessor = decltype(emu)::CpuAccessor;
   auto &CpuAccessor = static_cast<TCpuAccessor &>(cpu_states_);
@@ -138,9 +641,29 @@ void Machine::EvaluateState(FStateCallback cb) noexcept {
   cb(reg_access, spec_reg_access);
 }
 
-void Machine::RegisterLoggerCallback(void (*callback)(libmicroemu::LogLevel level, const char *,
-                                                      ...) noexcept) noexcept {
-  StaticLogger::RegisterLoggerCallback(callback);
+StatusCode Machine::ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
+  auto emu = BuildEmulator();
+  return emu.ReadMemory(vadr, dst, size).status_code;
+}
+
+StatusCode Machine::WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) noexcept {
+  const StaticLoggerScope log_scope(GetLoggerCallback(), GetLoggerUserData());
+  auto emu = BuildEmulator();
+  return emu.WriteMemory(vadr, src, size).status_code;
+}
+
+void Machine::RegisterLoggerCallback(FLoggerCallback callback, void *user_data) noexcept {
+  default_logger_user_data.store(user_data);
+  default_logger_callback.store(callback);
+}
+
+FLoggerCallback Machine::GetLoggerCallback() const noexcept {
+  return (logger_callback_ != nullptr) ? logger_callback_ : default_logger_callback.load();
+}
+
+void *Machine::GetLoggerUserData() const noexcept {
+  return (logger_callback_ != nullptr) ? logger_user_data_ : default_logger_user_data.load();
 }
 
 std::string_view Machine::GetVersion() noexcept { return kLibmicroemuVersion; }
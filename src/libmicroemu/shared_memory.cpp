@@ -0,0 +1,179 @@
+#include "libmicroemu/shared_memory.h"
+#include <new>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LIBMICROEMU_HAS_POSIX_SHM 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define LIBMICROEMU_HAS_POSIX_SHM 0
+#endif
+
+namespace libmicroemu {
+
+SharedMemory::~SharedMemory() noexcept { Close(); }
+
+StatusCode SharedMemory::Create(const std::string &name, me_size_t size) noexcept {
+#if LIBMICROEMU_HAS_POSIX_SHM
+  Close();
+  // The channel follows the RAM bytes and has to be word aligned
+  if ((size == 0U) || ((size % sizeof(u32)) != 0U)) {
+    return StatusCode::kOutOfRange;
+  }
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    return StatusCode::kOpenFileFailed;
+  }
+  const auto total_size = static_cast<off_t>(size) + static_cast<off_t>(sizeof(DoorbellChannel));
+  if (ftruncate(fd, total_size) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    return StatusCode::kOpenFileFailed;
+  }
+  const auto sc = Map(fd, size);
+  close(fd); // the mapping keeps the object alive
+  if (sc != StatusCode::kSuccess) {
+    shm_unlink(name.c_str());
+    return sc;
+  }
+  created_name_ = name;
+
+  // A new object is zero filled, so the channel words start out cleared
+  new (GetChannel()) DoorbellChannel();
+  return StatusCode::kSuccess;
+#else
+  static_cast<void>(name);
+  static_cast<void>(size);
+  return StatusCode::kUnsuporrted;
+#endif
+}
+
+StatusCode SharedMemory::Open(const std::string &name) noexcept {
+#if LIBMICROEMU_HAS_POSIX_SHM
+  Close();
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return StatusCode::kOpenFileFailed;
+  }
+  struct stat st{};
+  if ((fstat(fd, &st) != 0) || (st.st_size <= static_cast<off_t>(sizeof(DoorbellChannel))) ||
+      ((st.st_size % static_cast<off_t>(sizeof(u32))) != 0)) {
+    close(fd);
+    return StatusCode::kOpenFileFailed;
+  }
+  const auto size =
+      static_cast<me_size_t>(st.st_size - static_cast<off_t>(sizeof(DoorbellChannel)));
+  const auto sc = Map(fd, size);
+  close(fd);
+  return sc;
+#else
+  static_cast<void>(name);
+  return StatusCode::kUnsuporrted;
+#endif
+}
+
+void SharedMemory::Close() noexcept {
+#if LIBMICROEMU_HAS_POSIX_SHM
+  if (data_ != nullptr) {
+    munmap(data_, static_cast<size_t>(size_) + sizeof(DoorbellChannel));
+  }
+  if (!created_name_.empty()) {
+    shm_unlink(created_name_.c_str());
+    created_name_.clear();
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0U;
+}
+
+DoorbellChannel *SharedMemory::GetChannel() const noexcept {
+  if (data_ == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<DoorbellChannel *>(data_ + size_);
+}
+
+StatusCode SharedMemory::Map(int fd, me_size_t size) noexcept {
+#if LIBMICROEMU_HAS_POSIX_SHM
+  void *ptr = mmap(nullptr, static_cast<size_t>(size) + sizeof(DoorbellChannel),
+                   PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    return StatusCode::kOpenFileFailed;
+  }
+  data_ = static_cast<u8 *>(ptr);
+  size_ = size;
+  return StatusCode::kSuccess;
+#else
+  static_cast<void>(fd);
+  static_cast<void>(size);
+  return StatusCode::kUnsuporrted;
+#endif
+}
+
+Doorbell::Doorbell(DoorbellChannel &channel, u32 irq, u64 poll_period,
+                   FDoorbellCallback cb) noexcept
+    : channel_(channel), irq_(irq), poll_period_(poll_period > 0U ? poll_period : 1U),
+      cb_(std::move(cb)) {}
+
+void Doorbell::Reset(IPeripheralContext &ctx) noexcept {
+  ctx.ScheduleWakeUp(ctx.GetTime() + poll_period_);
+}
+
+StatusCode Doorbell::Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                          u32 &value) noexcept {
+  static_cast<void>(ctx);
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  switch (offset) {
+  case kToHostOffset: {
+    value = channel_.to_host.load(std::memory_order_acquire);
+    return StatusCode::kSuccess;
+  }
+  case kToGuestOffset: {
+    value = channel_.to_guest.load(std::memory_order_acquire);
+    return StatusCode::kSuccess;
+  }
+  default: {
+    return StatusCode::kMemInaccesible;
+  }
+  }
+}
+
+StatusCode Doorbell::Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                           u32 value) noexcept {
+  static_cast<void>(ctx);
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  switch (offset) {
+  case kToHostOffset: {
+    channel_.to_host.fetch_or(value, std::memory_order_release);
+    if (cb_ != nullptr) {
+      cb_(value);
+    }
+    return StatusCode::kSuccess;
+  }
+  case kToGuestOffset: {
+    channel_.to_guest.fetch_and(~value, std::memory_order_acq_rel);
+    return StatusCode::kSuccess;
+  }
+  default: {
+    return StatusCode::kMemInaccesible;
+  }
+  }
+}
+
+StatusCode Doorbell::Tick(IPeripheralContext &ctx) noexcept {
+  StatusCode sc{StatusCode::kSuccess};
+  if (channel_.to_guest.load(std::memory_order_acquire) != 0U) {
+    sc = ctx.SetIrqPending(irq_);
+  }
+  ctx.ScheduleWakeUp(ctx.GetTime() + poll_period_);
+  return sc;
+}
+
+} // namespace libmicroemu
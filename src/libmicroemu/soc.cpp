@@ -0,0 +1,546 @@
+#include "libmicroemu/soc.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace libmicroemu {
+
+using internal::PageFlags;
+using internal::PageFlagTable;
+
+namespace {
+/// Blocks the threads of the cores until all of them arrived
+class QuantumBarrier {
+public:
+  explicit QuantumBarrier(u32 no_of_threads) noexcept : no_of_threads_(no_of_threads) {}
+
+  void ArriveAndWait() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const u64 generation = generation_;
+    if (++no_of_arrived_ == no_of_threads_) {
+      no_of_arrived_ = 0U;
+      ++generation_;
+      cv_.notify_all();
+      return;
+    }
+    cv_.wait(lock, [this, generation]() { return generation_ != generation; });
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  u32 no_of_threads_;
+  u32 no_of_arrived_{0U};
+  u64 generation_{0U};
+};
+
+/// Allocates a copy of a RAM segment, an empty segment needs no copy
+bool CopySegment(std::unique_ptr<u8[]> &copy, const u8 *seg_ptr, me_size_t seg_size) noexcept {
+  copy.reset();
+  if (seg_size == 0U) {
+    return true;
+  }
+  copy.reset(new (std::nothrow) u8[seg_size]);
+  if (!copy) {
+    return false;
+  }
+  std::memcpy(copy.get(), seg_ptr, seg_size);
+  return true;
+}
+} // namespace
+
+Soc::Soc(u32 no_of_cores) noexcept
+    : no_of_cores_((no_of_cores == 0U) ? 1U : (no_of_cores < kMaxCores ? no_of_cores : kMaxCores)) {
+}
+
+void Soc::SetFlashSegment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr) noexcept {
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].SetFlashSegment(seg_ptr, seg_size, seg_vadr);
+  }
+}
+
+void Soc::SetRam1Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                         bool is_external) noexcept {
+  ram1_ = seg_ptr;
+  ram1_size_ = seg_size;
+  ram1_vadr_ = seg_vadr;
+  is_ram1_external_ = is_external;
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].SetRam1Segment(seg_ptr, seg_size, seg_vadr, is_external);
+  }
+}
+
+void Soc::SetRam2Segment(u8 *seg_ptr, me_size_t seg_size, me_adr_t seg_vadr,
+                         bool is_external) noexcept {
+  ram2_ = seg_ptr;
+  ram2_size_ = seg_size;
+  ram2_vadr_ = seg_vadr;
+  is_ram2_external_ = is_external;
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].SetRam2Segment(seg_ptr, seg_size, seg_vadr, is_external);
+  }
+}
+
+StatusCode Soc::SetVectorTable(u32 core, me_adr_t vadr) noexcept {
+  if (core >= no_of_cores_) {
+    return StatusCode::kOutOfRange;
+  }
+  return cores_[core].SetVectorTable(vadr);
+}
+
+StatusCode Soc::Load(const char *elf_file) noexcept {
+  auto &core0 = cores_[0U];
+  const auto sc = core0.Load(elf_file);
+  if (sc != StatusCode::kSuccess) {
+    return sc;
+  }
+  if (core0.has_lazy_ram_) {
+    // Only core 0 tracks the unfilled pages of the shared RAM. A late fill would overwrite the
+    // stores of the other cores, so the RAM is filled completely.
+    core0.ram1_page_flags_->FillAllUnfilled(core0.ram1_);
+    core0.ram2_page_flags_->FillAllUnfilled(core0.ram2_);
+    core0.ReleasePageFlags();
+  }
+  for (u32 core = 1U; core < no_of_cores_; ++core) {
+    const auto sc_reset = cores_[core].Reset();
+    if (sc_reset != StatusCode::kSuccess) {
+      return sc_reset;
+    }
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode Soc::Reset() noexcept {
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    const auto sc = cores_[core].Reset();
+    if (sc != StatusCode::kSuccess) {
+      return sc;
+    }
+  }
+  return StatusCode::kSuccess;
+}
+
+void Soc::SetSlice(i64 no_of_instructions) noexcept {
+  slice_ = (no_of_instructions > 0) ? no_of_instructions : kDefaultSlice;
+}
+
+void Soc::SetQuantum(i64 no_of_instructions) noexcept {
+  quantum_ = (no_of_instructions > 0) ? no_of_instructions : 0;
+}
+
+StatusCode Soc::AttachMailbox(InterCoreMailbox &mailbox, me_adr_t vadr) noexcept {
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    const auto sc =
+        cores_[core].AttachPeripheral(&mailbox.GetEndpoint(core), vadr, InterCoreMailbox::kSize);
+    if (sc != StatusCode::kSuccess) {
+      return sc;
+    }
+  }
+  mailbox_ = &mailbox;
+  return StatusCode::kSuccess;
+}
+
+ExecResult Soc::Exec(i64 max_instructions) noexcept {
+  if (quantum_ > 0) {
+    return ExecQuanta(max_instructions);
+  }
+  return ExecUnsynchronized(max_instructions);
+}
+
+namespace {
+struct CoreResult {
+  StatusCode status_code{StatusCode::kMaxInstructionsReached};
+  int exit_code{EXIT_SUCCESS};
+  u64 instructions{0U};
+  bool is_ended{false};
+  bool is_store_pending{false}; // waits at a STREX for the arbitration, quantum mode only
+};
+} // namespace
+
+ExecResult Soc::ExecUnsynchronized(i64 max_instructions) noexcept {
+  std::array<CoreResult, kMaxCores> results{};
+  std::atomic<bool> is_stopped{false};
+  std::atomic<u32> ending_core{kMaxCores};
+
+  auto run_core = [&](u32 core) {
+    auto &result = results[core];
+    while (!is_stopped.load(std::memory_order_acquire)) {
+      i64 slice = slice_;
+      if (max_instructions > 0) {
+        const i64 remaining = max_instructions - static_cast<i64>(result.instructions);
+        if (remaining <= 0) {
+          return;
+        }
+        slice = (remaining < slice) ? remaining : slice;
+      }
+
+      const auto exec_res = cores_[core].Exec(slice);
+      result.instructions += exec_res.GetNoOfInstructions();
+      if (!exec_res.IsMaxInstructionsReached()) {
+        result.status_code = exec_res.GetStatusCode();
+        result.exit_code = static_cast<int>(exec_res.GetProgramExitCode());
+        u32 no_core = kMaxCores;
+        ending_core.compare_exchange_strong(no_core, core, std::memory_order_acq_rel);
+        is_stopped.store(true, std::memory_order_release);
+        return;
+      }
+    }
+  };
+
+  std::array<std::thread, kMaxCores> threads{};
+  for (u32 core = 1U; core < no_of_cores_; ++core) {
+    threads[core] = std::thread(run_core, core);
+  }
+  run_core(0U);
+  for (u32 core = 1U; core < no_of_cores_; ++core) {
+    threads[core].join();
+  }
+
+  u64 instructions{0U};
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    instructions += results[core].instructions;
+  }
+  const u32 core = ending_core.load(std::memory_order_acquire);
+  if (core == kMaxCores) {
+    return ExecResult(StatusCode::kMaxInstructionsReached, EXIT_SUCCESS, instructions);
+  }
+  return ExecResult(results[core].status_code, results[core].exit_code, instructions);
+}
+
+ExecResult Soc::ExecQuanta(i64 max_instructions) noexcept {
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    if (cores_[core].snapshots_) {
+      // Switching the RAM segments would silently discard them
+      return ExecResult(StatusCode::kUnsuporrted, EXIT_FAILURE);
+    }
+  }
+  const auto sc = AttachPrivateRam();
+  if (sc != StatusCode::kSuccess) {
+    DetachPrivateRam();
+    return ExecResult(sc, EXIT_FAILURE);
+  }
+  if (mailbox_ != nullptr) {
+    mailbox_->is_deferred_ = true;
+  }
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].cpu_states_.GetExclusiveMonitorStates().SetArbitrated(true);
+  }
+
+  std::array<CoreResult, kMaxCores> results{};
+  bool is_stopped{false};
+  QuantumBarrier barrier(no_of_cores_);
+
+  // The barrier orders all accesses to the results, so they need no atomics
+  auto run_core = [&](u32 core) {
+    auto &result = results[core];
+    while (true) {
+      i64 quantum = quantum_;
+      if (max_instructions > 0) {
+        const i64 remaining = max_instructions - static_cast<i64>(result.instructions);
+        quantum = (remaining < quantum) ? remaining : quantum;
+      }
+      result.is_store_pending = false;
+      if (!result.is_ended && (quantum > 0)) {
+        const auto exec_res = cores_[core].Exec(quantum);
+        result.instructions += exec_res.GetNoOfInstructions();
+        // A core which waits for the arbitration of a STREX ends its quantum early
+        result.is_store_pending = exec_res.GetStatusCode() == StatusCode::kExclusiveStorePending;
+        if (!exec_res.IsMaxInstructionsReached() && !result.is_store_pending) {
+          result.status_code = exec_res.GetStatusCode();
+          result.exit_code = static_cast<int>(exec_res.GetProgramExitCode());
+          result.is_ended = true;
+        }
+      }
+
+      barrier.ArriveAndWait();
+      if (core == 0U) {
+        u32 pending_msk{0U};
+        for (u32 i = 0U; i < no_of_cores_; ++i) {
+          pending_msk |= results[i].is_store_pending ? (1U << i) : 0U;
+        }
+        ArbitrateExclusives(pending_msk);
+        MergeQuantum();
+        bool is_limit_reached = max_instructions > 0;
+        for (u32 i = 0U; i < no_of_cores_; ++i) {
+          is_stopped = is_stopped || results[i].is_ended;
+          is_limit_reached = is_limit_reached &&
+                             (static_cast<i64>(results[i].instructions) >= max_instructions);
+        }
+        is_stopped = is_stopped || is_limit_reached;
+      }
+      barrier.ArriveAndWait();
+      if (is_stopped) {
+        return;
+      }
+    }
+  };
+
+  std::array<std::thread, kMaxCores> threads{};
+  for (u32 core = 1U; core < no_of_cores_; ++core) {
+    threads[core] = std::thread(run_core, core);
+  }
+  run_core(0U);
+  for (u32 core = 1U; core < no_of_cores_; ++core) {
+    threads[core].join();
+  }
+
+  if (mailbox_ != nullptr) {
+    mailbox_->is_deferred_ = false;
+  }
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].cpu_states_.GetExclusiveMonitorStates().SetArbitrated(false);
+  }
+  DetachPrivateRam();
+
+  u64 instructions{0U};
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    instructions += results[core].instructions;
+  }
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    if (results[core].is_ended) {
+      return ExecResult(results[core].status_code, results[core].exit_code, instructions);
+    }
+  }
+  return ExecResult(StatusCode::kMaxInstructionsReached, EXIT_SUCCESS, instructions);
+}
+
+StatusCode Soc::AttachPrivateRam() noexcept {
+  // Pages which were not filled yet are filled in the shared RAM before it is copied
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    auto &machine = cores_[core];
+    if (machine.ram1_page_flags_) {
+      machine.ram1_page_flags_->FillAllUnfilled(machine.ram1_);
+    }
+    if (machine.ram2_page_flags_) {
+      machine.ram2_page_flags_->FillAllUnfilled(machine.ram2_);
+    }
+  }
+
+  if (!CopySegment(base_ram_.ram1, ram1_, ram1_size_) ||
+      !CopySegment(base_ram_.ram2, ram2_, ram2_size_)) {
+    return StatusCode::kError;
+  }
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    auto &machine = cores_[core];
+    auto &copy = private_ram_[core];
+    if (!CopySegment(copy.ram1, ram1_, ram1_size_) ||
+        !CopySegment(copy.ram2, ram2_, ram2_size_)) {
+      return StatusCode::kError;
+    }
+    // Switching the segments releases the page flags of the core, it has no snapshots
+    machine.SetRam1Segment(copy.ram1.get(), ram1_size_, ram1_vadr_);
+    machine.SetRam2Segment(copy.ram2.get(), ram2_size_, ram2_vadr_);
+    machine.ram1_page_flags_.reset(new (std::nothrow) PageFlagTable());
+    machine.ram2_page_flags_.reset(new (std::nothrow) PageFlagTable());
+    if (!machine.ram1_page_flags_ || !machine.ram2_page_flags_ ||
+        !machine.ram1_page_flags_->Allocate(ram1_size_) ||
+        !machine.ram2_page_flags_->Allocate(ram2_size_)) {
+      return StatusCode::kError;
+    }
+  }
+  return StatusCode::kSuccess;
+}
+
+void Soc::DetachPrivateRam() noexcept {
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    cores_[core].SetRam1Segment(ram1_, ram1_size_, ram1_vadr_, is_ram1_external_);
+    cores_[core].SetRam2Segment(ram2_, ram2_size_, ram2_vadr_, is_ram2_external_);
+    private_ram_[core] = PrivateRam{};
+  }
+  base_ram_ = PrivateRam{};
+}
+
+bool Soc::IsWrittenByOtherCore(u32 core, me_adr_t vadr) const noexcept {
+  auto is_written = [this, core](me_adr_t ofs, const u8 *base, auto get_copy) {
+    for (u32 other = 0U; other < no_of_cores_; ++other) {
+      if ((other != core) && (std::memcmp(&get_copy(other)[ofs], &base[ofs], sizeof(u32)) != 0)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // The tagged word is aligned, LDREX of an unaligned address raises a UsageFault
+  if ((vadr - ram1_vadr_ < ram1_size_) && (ram1_size_ - (vadr - ram1_vadr_) >= sizeof(u32))) {
+    return is_written(vadr - ram1_vadr_, base_ram_.ram1.get(),
+                      [this](u32 other) { return private_ram_[other].ram1.get(); });
+  }
+  if ((vadr - ram2_vadr_ < ram2_size_) && (ram2_size_ - (vadr - ram2_vadr_) >= sizeof(u32))) {
+    return is_written(vadr - ram2_vadr_, base_ram_.ram2.get(),
+                      [this](u32 other) { return private_ram_[other].ram2.get(); });
+  }
+  return false; // other memory is not copied, the global monitor sees its stores
+}
+
+void Soc::ArbitrateExclusives(u32 pending_msk) noexcept {
+  // A reservation is lost if another core wrote the word in this quantum
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    auto &monitor = cores_[core].cpu_states_.GetExclusiveMonitorStates();
+    if (monitor.IsExclusive() && IsWrittenByOtherCore(core, monitor.GetAddress())) {
+      monitor.ClearExclusive();
+    }
+  }
+
+  // The lowest core waiting at a STREX wins the word, all other reservations of it are lost
+  std::array<bool, kMaxCores> is_winner{};
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    const auto &monitor = cores_[core].cpu_states_.GetExclusiveMonitorStates();
+    is_winner[core] = ((pending_msk & (1U << core)) != 0U) && monitor.IsExclusive();
+    for (u32 winner = 0U; winner < core; ++winner) {
+      is_winner[core] = is_winner[core] && !(is_winner[winner] && IsSameExclusive(winner, core));
+    }
+  }
+  for (u32 core = 0U; core < no_of_cores_; ++core) {
+    auto &monitor = cores_[core].cpu_states_.GetExclusiveMonitorStates();
+    if (is_winner[core]) {
+      monitor.Grant();
+      continue;
+    }
+    for (u32 winner = 0U; winner < no_of_cores_; ++winner) {
+      if (is_winner[winner] && IsSameExclusive(winner, core)) {
+        monitor.ClearExclusive();
+      }
+    }
+  }
+}
+
+bool Soc::IsSameExclusive(u32 core, u32 other) const noexcept {
+  const auto &monitor = cores_[core].cpu_states_.GetExclusiveMonitorStates();
+  const auto &other_monitor = cores_[other].cpu_states_.GetExclusiveMonitorStates();
+  return monitor.IsExclusive() && other_monitor.IsExclusive() &&
+         (monitor.GetAddress() == other_monitor.GetAddress());
+}
+
+void Soc::MergeQuantum() noexcept {
+  auto merge_segment = [this](u8 *shared, u8 *base, me_size_t size, auto get_copy,
+                              auto get_flags) {
+    if (size == 0U) {
+      return;
+    }
+    const me_size_t no_of_pages = PageFlagTable::CalcNoOfPages(size);
+    for (me_size_t page = 0U; page < no_of_pages; ++page) {
+      const me_size_t begin = page * PageFlagTable::kPageSize;
+      const me_size_t end =
+          (begin + PageFlagTable::kPageSize < size) ? begin + PageFlagTable::kPageSize : size;
+      bool is_written{false};
+
+      // Bytes changed by several cores take the value of the highest core
+      for (u32 core = 0U; core < no_of_cores_; ++core) {
+        PageFlagTable &flags = get_flags(core);
+        if (!flags.IsSet(page, PageFlags::kDirty)) {
+          continue;
+        }
+        flags.Clear(page, PageFlags::kDirty);
+        is_written = true;
+        const u8 *copy = get_copy(core);
+        for (me_size_t i = begin; i < end; ++i) {
+          if (copy[i] != base[i]) {
+            shared[i] = copy[i];
+          }
+        }
+      }
+      if (!is_written) {
+        continue;
+      }
+      std::memcpy(&base[begin], &shared[begin], end - begin);
+      for (u32 core = 0U; core < no_of_cores_; ++core) {
+        std::memcpy(&get_copy(core)[begin], &shared[begin], end - begin);
+      }
+    }
+  };
+
+  merge_segment(
+      ram1_, base_ram_.ram1.get(), ram1_size_,
+      [this](u32 core) { return private_ram_[core].ram1.get(); },
+      [this](u32 core) -> PageFlagTable & { return *cores_[core].ram1_page_flags_; });
+  merge_segment(
+      ram2_, base_ram_.ram2.get(), ram2_size_,
+      [this](u32 core) { return private_ram_[core].ram2.get(); },
+      [this](u32 core) -> PageFlagTable & { return *cores_[core].ram2_page_flags_; });
+
+  if (mailbox_ != nullptr) {
+    mailbox_->Publish();
+  }
+}
+
+InterCoreMailbox::InterCoreMailbox(u32 irq, u64 poll_period) noexcept
+    : irq_(irq), poll_period_(poll_period > 0U ? poll_period : 1U) {
+  for (u32 core = 0U; core < Soc::kMaxCores; ++core) {
+    endpoints_[core].mailbox_ = this;
+    endpoints_[core].core_ = core;
+  }
+}
+
+void InterCoreMailbox::Endpoint::Reset(IPeripheralContext &ctx) noexcept {
+  mailbox_->flags_[core_].store(0U, std::memory_order_release);
+  ctx.ScheduleWakeUp(ctx.GetTime() + mailbox_->poll_period_);
+}
+
+StatusCode InterCoreMailbox::Endpoint::Read(IPeripheralContext &ctx, me_offset_t offset,
+                                            me_size_t size, u32 &value) noexcept {
+  static_cast<void>(ctx);
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  if (offset == kFlagsOffset) {
+    value = mailbox_->flags_[core_].load(std::memory_order_acquire);
+  } else if (offset == kCoreIdOffset) {
+    value = core_;
+  } else if ((offset >= kRaiseOffset) && (offset < kSize)) {
+    value = 0U; // write-only
+  } else {
+    return StatusCode::kMemInaccesible;
+  }
+  return StatusCode::kSuccess;
+}
+
+StatusCode InterCoreMailbox::Endpoint::Write(IPeripheralContext &ctx, me_offset_t offset,
+                                             me_size_t size, u32 value) noexcept {
+  if (size != sizeof(u32)) {
+    return StatusCode::kMemInaccesible;
+  }
+  if (offset == kFlagsOffset) {
+    mailbox_->flags_[core_].fetch_and(~value, std::memory_order_acq_rel);
+    return StatusCode::kSuccess;
+  }
+  if (offset == kCoreIdOffset) {
+    return StatusCode::kSuccess; // read-only
+  }
+  if ((offset < kRaiseOffset) || (offset >= kSize)) {
+    return StatusCode::kMemInaccesible;
+  }
+  const u32 target = (offset - kRaiseOffset) / sizeof(u32);
+  if ((target != core_) && mailbox_->is_deferred_) {
+    // Delivered at the next barrier of the Soc
+    mailbox_->deferred_flags_[target].fetch_or(value, std::memory_order_relaxed);
+    return StatusCode::kSuccess;
+  }
+  mailbox_->flags_[target].fetch_or(value, std::memory_order_release);
+  if ((target == core_) && (value != 0U)) {
+    // The interrupt of another core is set pending at its next poll
+    return ctx.SetIrqPending(mailbox_->irq_);
+  }
+  return StatusCode::kSuccess;
+}
+
+void InterCoreMailbox::Publish() noexcept {
+  for (u32 core = 0U; core < Soc::kMaxCores; ++core) {
+    const u32 bits = deferred_flags_[core].exchange(0U, std::memory_order_relaxed);
+    flags_[core].fetch_or(bits, std::memory_order_release);
+  }
+}
+
+StatusCode InterCoreMailbox::Endpoint::Tick(IPeripheralContext &ctx) noexcept {
+  StatusCode sc{StatusCode::kSuccess};
+  if (mailbox_->flags_[core_].load(std::memory_order_acquire) != 0U) {
+    sc = ctx.SetIrqPending(mailbox_->irq_);
+  }
+  ctx.ScheduleWakeUp(ctx.GetTime() + mailbox_->poll_period_);
+  return sc;
+}
+
+} // namespace libmicroemu
@@ -0,0 +1,315 @@
+#include "batch_runner.h"
+#include "libmicroemu/machine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fmt/core.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+namespace {
+
+struct BatchResult {
+  libmicroemu::StatusCode status_code{libmicroemu::StatusCode::kError};
+  uint32_t exit_code{EXIT_FAILURE};
+  uint64_t instructions{0U};
+  double seconds{0.0};
+  bool is_passed{false};
+  std::string console; // guest output, kept for failed jobs only
+};
+
+// Firmware image of one ELF file and memory configuration, loaded by the first thread which
+// needs it and then shared by all threads
+struct BatchImage {
+  std::once_flag once;
+  libmicroemu::FirmwareImage image;
+  libmicroemu::StatusCode status_code{libmicroemu::StatusCode::kError};
+};
+
+// Guest output of a job which is kept at most
+constexpr size_t kMaxConsoleSize = 0x10000U;
+
+// A machine and its RAM, reused for all jobs a thread takes
+struct BatchWorker {
+  BatchWorker() {
+    // The guest output of all threads must not mix with the summary on stdout
+    machine.SetConsoleCallback([this](const char *buf, libmicroemu::me_size_t len) {
+      console.append(buf, std::min(static_cast<size_t>(len), kMaxConsoleSize - console.size()));
+    });
+  }
+
+  libmicroemu::Machine machine;
+  std::vector<uint8_t> ram1_seg;
+  std::vector<uint8_t> ram2_seg;
+  const BatchJob *loaded_job{nullptr}; // job whose ELF file is loaded as golden state
+  std::string console;                 // guest output of the current job
+};
+
+bool IsSameImage(const BatchJob &a, const BatchJob &b) {
+  return (a.elf_file == b.elf_file) && (a.memory_config == b.memory_config);
+}
+
+std::string Trim(const std::string &str) {
+  const auto first = str.find_first_not_of(" \t\r");
+  if (first == std::string::npos) {
+    return "";
+  }
+  const auto last = str.find_last_not_of(" \t\r");
+  return str.substr(first, last - first + 1U);
+}
+
+bool ParseManifest(const std::string &manifest_file, std::vector<BatchJob> &jobs) {
+  std::ifstream file(manifest_file);
+  if (!file.is_open()) {
+    fmt::print(stderr, "ERROR: Failed to open manifest '{}'\n", manifest_file);
+    return false;
+  }
+
+  std::string line;
+  uint32_t line_no{0U};
+  while (std::getline(file, line)) {
+    ++line_no;
+    line = Trim(line);
+    if (line.empty() || (line[0U] == '#')) {
+      continue;
+    }
+
+    std::vector<std::string> fields;
+    std::istringstream iss(line);
+    std::string field;
+    while (std::getline(iss, field, ',')) {
+      fields.push_back(Trim(field));
+    }
+
+    BatchJob job;
+    job.elf_file = fields[0U];
+    job.memory_config = ((fields.size() > 1U) && !fields[1U].empty()) ? fields[1U] : "MINIMAL";
+    MemoryLayout layout;
+    char *end{nullptr};
+    bool is_valid = (fields.size() <= 4U) && !job.elf_file.empty() &&
+                    GetMemoryLayout(job.memory_config, layout);
+    if (is_valid && (fields.size() > 2U) && !fields[2U].empty()) {
+      job.instr_limit = std::strtoll(fields[2U].c_str(), &end, 0);
+      is_valid = (*end == '\0') && (job.instr_limit >= -1);
+    }
+    if (is_valid && (fields.size() > 3U) && !fields[3U].empty()) {
+      job.expected_exit_code = static_cast<uint32_t>(std::strtoul(fields[3U].c_str(), &end, 0));
+      is_valid = (*end == '\0');
+    }
+    if (!is_valid) {
+      fmt::print(stderr, "ERROR: Invalid job in manifest '{}' line {}: {}\n", manifest_file,
+                 line_no, line);
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  return true;
+}
+
+// Loads the image of the job or resets the machine if it is already loaded
+libmicroemu::StatusCode PrepareJob(BatchWorker &worker, const BatchJob &job, BatchImage &image,
+                                   const BatchOptions &options) {
+  auto &machine = worker.machine;
+  if ((worker.loaded_job != nullptr) && IsSameImage(*worker.loaded_job, job)) {
+    return machine.ResetToGoldenState();
+  }
+  worker.loaded_job = nullptr;
+
+  MemoryLayout layout;
+  static_cast<void>(GetMemoryLayout(job.memory_config, layout));
+  std::call_once(image.once, [&image, &job, &layout]() {
+    image.status_code =
+        image.image.Load(job.elf_file.c_str(), layout.flash_size, layout.flash_vadr);
+  });
+  if (image.status_code != libmicroemu::StatusCode::kSuccess) {
+    return image.status_code;
+  }
+
+  worker.ram1_seg.resize(layout.ram1_size);
+  worker.ram2_seg.resize(layout.ram2_size);
+  machine.SetRam1Segment(worker.ram1_seg.data(), layout.ram1_size, layout.ram1_vadr);
+  machine.SetRam2Segment(worker.ram2_seg.data(), layout.ram2_size, layout.ram2_vadr);
+  machine.SetLazyRamFill(options.is_lazy_ram);
+
+  const auto sc = machine.Load(image.image, options.is_elf_entry_point);
+  if (sc != libmicroemu::StatusCode::kSuccess) {
+    return sc;
+  }
+  // Without a golden state the next job of this ELF file loads it again
+  if (machine.CaptureGoldenState() == libmicroemu::StatusCode::kSuccess) {
+    worker.loaded_job = &job;
+  }
+  return libmicroemu::StatusCode::kSuccess;
+}
+
+BatchResult RunJob(BatchWorker &worker, const BatchJob &job, BatchImage &image,
+                   const BatchOptions &options) {
+  BatchResult result;
+  worker.console.clear();
+  result.status_code = PrepareJob(worker, job, image, options);
+  if (result.status_code != libmicroemu::StatusCode::kSuccess) {
+    return result;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto exec_result = worker.machine.Exec(job.instr_limit);
+  const auto stop = std::chrono::steady_clock::now();
+
+  result.status_code = exec_result.GetStatusCode();
+  result.exit_code = exec_result.GetProgramExitCode();
+  result.instructions = exec_result.GetNoOfInstructions();
+  result.seconds = std::chrono::duration<double>(stop - start).count();
+  // A job which runs until its instruction limit did not terminate and fails
+  result.is_passed = exec_result.IsOk() && (result.exit_code == job.expected_exit_code);
+  if (!result.is_passed) {
+    result.console = std::move(worker.console);
+  }
+  return result;
+}
+
+double GetMips(const BatchResult &result) {
+  return (result.seconds > 0.0) ? static_cast<double>(result.instructions) / result.seconds / 1e6
+                                : 0.0;
+}
+
+std::string EscapeJson(const std::string &str) {
+  std::string escaped;
+  for (const char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void PrintCsv(std::FILE *out, const std::vector<BatchJob> &jobs,
+              const std::vector<BatchResult> &results) {
+  fmt::print(out, "elf_file,memory_config,instr_limit,expected_exit_code,exit_code,status,passed,"
+                  "instructions,seconds,mips\n");
+  for (size_t i = 0U; i < jobs.size(); ++i) {
+    const auto &job = jobs[i];
+    const auto &result = results[i];
+    fmt::print(out, "{},{},{},{},{},{},{},{},{:.6f},{:.3f}\n", job.elf_file, job.memory_config,
+               job.instr_limit, job.expected_exit_code, result.exit_code,
+               libmicroemu::StatusCodeToString(result.status_code), result.is_passed ? 1 : 0,
+               result.instructions, result.seconds, GetMips(result));
+  }
+}
+
+void PrintJson(std::FILE *out, const std::vector<BatchJob> &jobs,
+               const std::vector<BatchResult> &results, double seconds) {
+  const auto no_of_passed = std::count_if(results.begin(), results.end(),
+                                          [](const BatchResult &r) { return r.is_passed; });
+  const auto instructions =
+      std::accumulate(results.begin(), results.end(), uint64_t{0U},
+                      [](uint64_t sum, const BatchResult &r) { return sum + r.instructions; });
+  fmt::print(out, "{{\n  \"jobs\": [");
+  for (size_t i = 0U; i < jobs.size(); ++i) {
+    const auto &job = jobs[i];
+    const auto &result = results[i];
+    fmt::print(out,
+               "{}\n    {{\"elf_file\": \"{}\", \"memory_config\": \"{}\", \"instr_limit\": {}, "
+               "\"expected_exit_code\": {}, \"exit_code\": {}, \"status\": \"{}\", "
+               "\"passed\": {}, \"instructions\": {}, \"seconds\": {:.6f}, \"mips\": {:.3f}}}",
+               (i == 0U) ? "" : ",", EscapeJson(job.elf_file), job.memory_config,
+               job.instr_limit, job.expected_exit_code, result.exit_code,
+               libmicroemu::StatusCodeToString(result.status_code),
+               result.is_passed ? "true" : "false", result.instructions, result.seconds,
+               GetMips(result));
+  }
+  fmt::print(out,
+             "\n  ],\n  \"passed\": {},\n  \"failed\": {},\n  \"instructions\": {},\n"
+             "  \"seconds\": {:.6f}\n}}\n",
+             no_of_passed, jobs.size() - static_cast<size_t>(no_of_passed), instructions,
+             seconds);
+}
+
+} // namespace
+
+int RunBatch(const std::string &manifest_file, const BatchOptions &options) {
+  std::vector<BatchJob> jobs;
+  if (!ParseManifest(manifest_file, jobs)) {
+    return EXIT_FAILURE;
+  }
+
+  // Jobs of the same ELF file follow each other, so a thread can often reuse its loaded image
+  std::vector<size_t> order(jobs.size());
+  std::iota(order.begin(), order.end(), 0U);
+  std::stable_sort(order.begin(), order.end(), [&jobs](size_t a, size_t b) {
+    return std::tie(jobs[a].elf_file, jobs[a].memory_config) <
+           std::tie(jobs[b].elf_file, jobs[b].memory_config);
+  });
+
+  // One shared image per ELF file and memory configuration
+  std::vector<std::unique_ptr<BatchImage>> images;
+  std::vector<size_t> image_of_job(jobs.size());
+  for (size_t i = 0U; i < order.size(); ++i) {
+    if ((i == 0U) || !IsSameImage(jobs[order[i - 1U]], jobs[order[i]])) {
+      images.push_back(std::make_unique<BatchImage>());
+    }
+    image_of_job[order[i]] = images.size() - 1U;
+  }
+
+  uint32_t no_of_threads = options.no_of_threads;
+  if (no_of_threads == 0U) {
+    no_of_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  no_of_threads = std::min(no_of_threads, static_cast<uint32_t>(std::max(jobs.size(), size_t{1U})));
+
+  std::vector<BatchResult> results(jobs.size());
+  std::atomic<size_t> next_job{0U};
+  auto work = [&]() {
+    BatchWorker worker;
+    for (size_t i = next_job++; i < order.size(); i = next_job++) {
+      const auto job_idx = order[i];
+      results[job_idx] = RunJob(worker, jobs[job_idx], *images[image_of_job[job_idx]], options);
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1U; i < no_of_threads; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(stop - start).count();
+
+  for (size_t i = 0U; i < jobs.size(); ++i) {
+    if (!results[i].console.empty()) {
+      fmt::print(stderr, "--- Output of failed job {} ({}) ---\n{}\n", i, jobs[i].elf_file,
+                 results[i].console);
+    }
+  }
+
+  std::FILE *out = stdout;
+  if (!options.output_file.empty()) {
+    out = std::fopen(options.output_file.c_str(), "w");
+    if (out == nullptr) {
+      fmt::print(stderr, "ERROR: Failed to open output file '{}'\n", options.output_file);
+      return EXIT_FAILURE;
+    }
+  }
+  if (options.is_csv) {
+    PrintCsv(out, jobs, results);
+  } else {
+    PrintJson(out, jobs, results, seconds);
+  }
+  if (out != stdout) {
+    std::fclose(out);
+  }
+
+  const bool is_all_passed = std::all_of(results.begin(), results.end(),
+                                         [](const BatchResult &r) { return r.is_passed; });
+  return is_all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
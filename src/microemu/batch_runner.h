@@ -0,0 +1,45 @@
+#pragma once
+
+#include "memory_layout.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// A single entry of a batch manifest
+struct BatchJob {
+  std::string elf_file;
+  std::string memory_config;
+  int64_t instr_limit{-1};
+  uint32_t expected_exit_code{0U};
+};
+
+/// Options which apply to all jobs of a batch
+struct BatchOptions {
+  bool is_elf_entry_point{false};
+  bool is_lazy_ram{false};
+  uint32_t no_of_threads{0U}; // 0 uses all host threads
+  bool is_csv{false};         // JSON otherwise
+  std::string output_file;    // empty for stdout
+};
+
+/**
+ * Runs the jobs of a manifest on a pool of host threads.
+ *
+ * The manifest contains one job per line: <elf_file>,<memory_config>,<instr_limit>,<exit_code>.
+ * Only the ELF file is required; the memory configuration defaults to MINIMAL, the instruction
+ * limit to -1 (infinite) and the expected exit code to 0. Empty lines and lines starting with #
+ * are ignored.
+ *
+ * Every thread keeps one machine. Jobs are sorted by ELF file and memory configuration and then
+ * taken by the idle threads one at a time. Every ELF file is read once into a firmware image whose
+ * flash is shared by all threads, only the RAM is private to a thread. When a thread takes a job
+ * for the image it already has loaded, it resets its machine to the golden state captured after
+ * the load, so RAM is not loaded again.
+ *
+ * The guest output of a job is buffered. It is written to stderr after all jobs ran, only for the
+ * jobs which failed, so stdout only holds the summary.
+ *
+ * Returns EXIT_SUCCESS if all jobs terminated with their expected exit code. A job which reaches
+ * its instruction limit fails.
+ */
+int RunBatch(const std::string &manifest_file, const BatchOptions &options);
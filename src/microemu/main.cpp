@@ -1,12 +1,15 @@
+#include "batch_runner.h"
 #include "libmicroemu/logger.h"
 #include "libmicroemu/machine.h"
 #include "reg_printer.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include <algorithm>
+#include <array>
 #include <cxxopts.hpp>
 #include <fmt/core.h>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <spdlog/spdlog.h>
 #include <stdarg.h>
 #include <vector>
@@ -27,7 +30,9 @@ std::string CreateCommaSeparatedString(const std::vector<std::string> &input_set
   return oss.str();
 }
 
-void LoggingCallback(libmicroemu::LogLevel level, const char *format, ...) noexcept {
+void LoggingCallback(libmicroemu::LogLevel level, void *user_data, const char *format,
+                     ...) noexcept {
+  static_cast<void>(user_data);
   // Initialize variadic argument list
   va_list args;
   va_start(args, format);
@@ -73,6 +78,20 @@ void LoggingCallback(libmicroemu::LogLevel level, const char *format, ...) noexc
   va_end(args);
 }
 
+void PrintBusStatistics(const libmicroemu::BusStatistics &stats) {
+  static const std::array<const char *, libmicroemu::kNoOfBusRegions> kRegionNames = {
+      "FLASH", "RAM1", "RAM2", "SYS_PERIPH", "PLUGINS", "BIT_BAND", "SPARSE"};
+  fmt::print(stderr, "{:<10} {:>12} {:>12} {:>12} {:>14} {:>14} {:>14}\n", "REGION", "FETCHES",
+             "READS", "WRITES", "FETCHED_BYTES", "READ_BYTES", "WRITTEN_BYTES");
+  for (uint32_t i = 0U; i < libmicroemu::kNoOfBusRegions; ++i) {
+    const auto &region = stats.regions[i];
+    fmt::print(stderr, "{:<10} {:>12} {:>12} {:>12} {:>14} {:>14} {:>14}\n", kRegionNames[i],
+               region.fetches.GetAccesses(), region.reads.GetAccesses(),
+               region.writes.GetAccesses(), region.fetches.bytes, region.reads.bytes,
+               region.writes.bytes);
+  }
+}
+
 int main(int argc, const char *argv[]) {
   // Parse command line options
   cxxopts::Options options("libmicroemu", "Armv7-m  emulator");
@@ -115,7 +134,24 @@ int main(int argc, const char *argv[]) {
     ("ram2-size", "Override the RAM2 segment size (in bytes).", 
         cxxopts::value<uint32_t>())
     ("ram2-vaddr", "Override the RAM2 segment virtual address.", 
-        cxxopts::value<uint32_t>());
+        cxxopts::value<uint32_t>())
+    ("sparse", 
+        "Back all addresses outside of the memory segments with lazily allocated memory.")
+    ("sparse-unmapped", 
+        "Comma separated list of <vaddr>:<size> ranges which fault when sparse memory is used.", 
+        cxxopts::value<std::string>())
+    ("bus-stats", "Print the access counters of the memory bus to stderr after the execution.")
+    ("lazy-ram", "Fill the RAM segments page by page on first access instead of on load.")
+    ("mpu", "Add a memory protection unit (PMSAv7, 8 regions) to the processor.")
+    ("batch", "Run the jobs of a manifest (<elf_file>,<memory-config>,<instr_limit>,<exit_code> "
+        "per line) in parallel and print a summary.",
+        cxxopts::value<std::string>())
+    ("batch-format", "Format of the batch summary (JSON, CSV).",
+        cxxopts::value<std::string>()->default_value("JSON"))
+    ("batch-output", "Write the batch summary to a file instead of stdout.",
+        cxxopts::value<std::string>())
+    ("j,jobs", "Number of host threads used in batch mode (0: all host threads).",
+        cxxopts::value<uint32_t>()->default_value("0"));
   ;
   // clang-format on
 
@@ -151,6 +187,63 @@ int main(int argc, const char *argv[]) {
   // Checking command line options
   // =====================================
 
+  // Check defined log levels
+  std::string log_level = result["log-level"].as<std::string>();
+  if (std::find(kValidLogLevels.begin(), kValidLogLevels.end(), log_level) ==
+      kValidLogLevels.end()) {
+    fmt::print(stderr, "Error: Invalid log level '{}'. Valid log levels are: {}\n", log_level,
+               CreateCommaSeparatedString(kValidLogLevels));
+    return EXIT_FAILURE;
+  }
+
+  if (result.count("log")) {
+    if (result.count("log-file")) {
+      std::string log_file = result["log-file"].as<std::string>();
+      // Create a file sink for the global logger and point it to a specific file
+      auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file, true);
+
+      // Set the default logger to use the file sink
+      spdlog::set_default_logger(std::make_shared<spdlog::logger>("global_logger", file_sink));
+    }
+
+    spdlog::set_pattern("[%H:%M:%S,%f] [%^%l%$] %v");
+
+    if (log_level == "TRACE") {
+      spdlog::set_level(spdlog::level::trace);
+    } else if (log_level == "DEBUG") {
+      spdlog::set_level(spdlog::level::debug);
+    } else if (log_level == "INFO") {
+      spdlog::set_level(spdlog::level::info);
+    } else if (log_level == "ERROR") {
+      spdlog::set_level(spdlog::level::err);
+    } else if (log_level == "WARNING") {
+      spdlog::set_level(spdlog::level::warn);
+    } else if (log_level == "CRITICAL") {
+      spdlog::set_level(spdlog::level::critical);
+    }
+
+    libmicroemu::Machine::RegisterLoggerCallback(&LoggingCallback);
+  }
+
+  // Run a batch of jobs instead of a single ELF file
+  if (result.count("batch")) {
+    BatchOptions batch_options;
+    batch_options.is_elf_entry_point = result.count("elf_ep") > 0U;
+    batch_options.is_lazy_ram = result.count("lazy-ram") > 0U;
+    batch_options.no_of_threads = result["jobs"].as<uint32_t>();
+    const auto batch_format = result["batch-format"].as<std::string>();
+    if ((batch_format != "JSON") && (batch_format != "CSV")) {
+      fmt::print(stderr, "Error: Invalid batch-format '{}'. Valid formats are: JSON, CSV\n",
+                 batch_format);
+      return EXIT_FAILURE;
+    }
+    batch_options.is_csv = batch_format == "CSV";
+    if (result.count("batch-output")) {
+      batch_options.output_file = result["batch-output"].as<std::string>();
+    }
+    return RunBatch(result["batch"].as<std::string>(), batch_options);
+  }
+
   // Check if the elf_file argument is present
   if (!result.count("elf_file")) {
     fmt::print(stderr, "libmicroemu: Missing required positional argument <elf_file>\n");
@@ -170,15 +263,6 @@ int main(int argc, const char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  // Check defined log levels
-  std::string log_level = result["log-level"].as<std::string>();
-  if (std::find(kValidLogLevels.begin(), kValidLogLevels.end(), log_level) ==
-      kValidLogLevels.end()) {
-    fmt::print(stderr, "Error: Invalid log level '{}'. Valid log levels are: {}\n", log_level,
-               CreateCommaSeparatedString(kValidLogLevels));
-    return EXIT_FAILURE;
-  }
-
   // Check defined memory-configs
   std::string memory_config = result["memory-config"].as<std::string>();
   if (std::find(kValidMemoryConfigs.begin(), kValidMemoryConfigs.end(), memory_config) ==
@@ -188,8 +272,9 @@ int main(int argc, const char *argv[]) {
     return EXIT_FAILURE;
   }
 
+  int64_t instr_limit = -1; // <0 means infinite
   if (result.count("instr_limit")) {
-    auto instr_limit = result["instr_limit"].as<int>();
+    instr_limit = result["instr_limit"].as<int64_t>();
 
     if (instr_limit < -1) {
       fmt::print(stderr, "libmicroemu: instr_limit must be greater than or equal to -1\n");
@@ -217,66 +302,15 @@ int main(int argc, const char *argv[]) {
   uint32_t ram2_seg_size{0x0U};
   uint32_t ram2_seg_vadr{0x0U};
 
-  int64_t instr_limit = -1; // <0 means infinite
-
-  if (result.count("instr_limit")) {
-    auto instr_limit = result["instr_limit"].as<int>();
-  }
-
-  if (result.count("log")) {
-    if (result.count("log-file")) {
-      std::string log_file = result["log-file"].as<std::string>();
-      // Create a file sink for the global logger and point it to a specific file
-      auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file, true);
-
-      // Set the default logger to use the file sink
-      spdlog::set_default_logger(std::make_shared<spdlog::logger>("global_logger", file_sink));
-    }
-
-    spdlog::set_pattern("[%H:%M:%S,%f] [%^%l%$] %v");
-
-    if (log_level == "TRACE") {
-      spdlog::set_level(spdlog::level::trace);
-    } else if (log_level == "DEBUG") {
-      spdlog::set_level(spdlog::level::debug);
-    } else if (log_level == "INFO") {
-      spdlog::set_level(spdlog::level::info);
-    } else if (log_level == "ERROR") {
-      spdlog::set_level(spdlog::level::err);
-    } else if (log_level == "WARNING") {
-      spdlog::set_level(spdlog::level::warn);
-    } else if (log_level == "CRITICAL") {
-      spdlog::set_level(spdlog::level::critical);
-    }
-
-    libmicroemu::Machine::RegisterLoggerCallback(&LoggingCallback);
-  }
-
   // Memory configuration
-  if (memory_config == "STDLIB") {
-    flash_seg_vadr = 0x0U;
-    flash_seg_size = 0x10000U;
-
-    ram1_seg_vadr = 0x10000U;
-    ram1_seg_size = 0x20000U;
-
-    ram2_seg_vadr = 0x70000U;
-    ram2_seg_size = 0x10000U;
-
-  } else if (memory_config == "MINIMAL") {
-    flash_seg_vadr = 0x0U;
-    flash_seg_size = 0x20000U;
-
-    ram1_seg_vadr = 0x20000000U;
-    ram1_seg_size = 0x40000U;
-
-    // No RAM2 segment
-    ram2_seg_vadr = 0x0U;
-    ram2_seg_size = 0x0U;
-  } else {
-    // default or NONE
-    // Do nothing
-  }
+  MemoryLayout layout;
+  static_cast<void>(GetMemoryLayout(memory_config, layout));
+  flash_seg_size = layout.flash_size;
+  flash_seg_vadr = layout.flash_vadr;
+  ram1_seg_size = layout.ram1_size;
+  ram1_seg_vadr = layout.ram1_vadr;
+  ram2_seg_size = layout.ram2_size;
+  ram2_seg_vadr = layout.ram2_vadr;
 
   // Override memory configuration if command line options are present
   if (result.count("flash-size")) {
@@ -307,6 +341,51 @@ int main(int argc, const char *argv[]) {
   machine.SetFlashSegment(flash_seg.data(), flash_seg_size, flash_seg_vadr);
   machine.SetRam1Segment(ram1_seg.data(), ram1_seg_size, ram1_seg_vadr);
   machine.SetRam2Segment(ram2_seg.data(), ram2_seg_size, ram2_seg_vadr);
+  machine.SetLazyRamFill(result.count("lazy-ram") > 0U);
+
+  // Enable the sparse memory backend if requested
+  if (result.count("sparse")) {
+    const auto sc_sparse = machine.EnableSparseMemory();
+    if (sc_sparse != libmicroemu::StatusCode::kSuccess) {
+      fmt::print(stderr, "ERROR: Failed to enable sparse memory: {}\n",
+                 libmicroemu::StatusCodeToString(sc_sparse));
+      return EXIT_FAILURE;
+    }
+
+    if (result.count("sparse-unmapped")) {
+      const auto ranges = result["sparse-unmapped"].as<std::string>();
+      std::istringstream iss(ranges);
+      std::string range;
+      while (std::getline(iss, range, ',')) {
+        const auto sep = range.find(':');
+        if (sep == std::string::npos) {
+          fmt::print(stderr, "Error: Invalid unmapped range '{}'. Expected <vaddr>:<size>\n",
+                     range);
+          return EXIT_FAILURE;
+        }
+        const auto vadr =
+            static_cast<uint32_t>(std::strtoul(range.substr(0, sep).c_str(), nullptr, 0));
+        const auto size =
+            static_cast<uint32_t>(std::strtoul(range.substr(sep + 1).c_str(), nullptr, 0));
+        const auto sc_region = machine.AddUnmappedRegion(vadr, size);
+        if (sc_region != libmicroemu::StatusCode::kSuccess) {
+          fmt::print(stderr, "ERROR: Failed to add unmapped range '{}': {}\n", range,
+                     libmicroemu::StatusCodeToString(sc_region));
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // Add the memory protection unit if requested
+  if (result.count("mpu")) {
+    const auto sc_mpu = machine.EnableMpu();
+    if (sc_mpu != libmicroemu::StatusCode::kSuccess) {
+      fmt::print(stderr, "ERROR: Failed to enable the MPU: {}\n",
+                 libmicroemu::StatusCodeToString(sc_mpu));
+      return EXIT_FAILURE;
+    }
+  }
 
   // Check if the entry point should be set from the ELF file
   // If not set, the entry point is set through the vector tabledoc:
@@ -406,6 +485,9 @@ int main(int argc, const char *argv[]) {
 
   // Execute the arm code
   const auto exec_result = machine.Exec(instr_limit, pre_instr, post_instr);
+  if (result.count("bus-stats")) {
+    PrintBusStatistics(machine.GetBusStatistics());
+  }
   if (exec_result.IsErr()) {
     // Is Max instructions reached error?
     if (exec_result.IsMaxInstructionsReached()) {
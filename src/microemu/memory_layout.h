@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/// Memory segments of a memory configuration
+struct MemoryLayout {
+  uint32_t flash_size{0x0U};
+  uint32_t flash_vadr{0x0U};
+  uint32_t ram1_size{0x0U};
+  uint32_t ram1_vadr{0x0U};
+  uint32_t ram2_size{0x0U};
+  uint32_t ram2_vadr{0x0U};
+};
+
+// Gets the segments of a memory configuration. Returns false if the configuration is unknown.
+inline bool GetMemoryLayout(const std::string &memory_config, MemoryLayout &layout) {
+  layout = MemoryLayout{};
+  if (memory_config == "STDLIB") {
+    layout.flash_vadr = 0x0U;
+    layout.flash_size = 0x10000U;
+
+    layout.ram1_vadr = 0x10000U;
+    layout.ram1_size = 0x20000U;
+
+    layout.ram2_vadr = 0x70000U;
+    layout.ram2_size = 0x10000U;
+  } else if (memory_config == "MINIMAL") {
+    layout.flash_vadr = 0x0U;
+    layout.flash_size = 0x20000U;
+
+    layout.ram1_vadr = 0x20000000U;
+    layout.ram1_size = 0x40000U;
+
+    // No RAM2 segment
+  } else if (memory_config != "NONE") {
+    return false;
+  }
+  return true;
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "libmicroemu/emu_context.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <string>
 
 static constexpr uint8_t kRegCount = 18U;
 static constexpr uint8_t kRegsPerRow = 5U;
@@ -50,29 +53,28 @@ public:
   }
 
   static void PrintRegs(const SampledRegs &sampled_regs) {
-    auto count = 0U;
-    for (uint8_t reg_id = 0x0U; reg_id < kRegCount; ++reg_id) {
-      count += 1U;
-
-      if ((count % kRegsPerRow) != 1U) {
-        printf(" | ");
-      }
-
-      const auto &name = sampled_regs.names[reg_id];
-      const auto &value = sampled_regs.values[reg_id];
-      printf("%6s = %08x", name, value);
-      if ((count % kRegsPerRow) == 0) {
-        printf("\n");
-      }
-    }
-    // Print a newline if the last register was not printed
-    if ((count % kRegsPerRow) != 0) {
-      printf("\n");
-    }
+    std::string out;
+    FormatRegs(sampled_regs, out);
+    fputs(out.c_str(), stdout);
   }
 
   static void PrintRegDiffs(const SampledRegs &sampled_regs,
                             const SampledRegs &regs_from_last_step) {
+    std::string out;
+    FormatRegDiffs(sampled_regs, regs_from_last_step, out);
+    fputs(out.c_str(), stdout);
+  }
+
+  // Appends the lines of all registers to the string
+  static void FormatRegs(const SampledRegs &sampled_regs, std::string &out) {
+    bool print[kRegCount];
+    std::fill(print, print + kRegCount, true);
+    FormatSelectedRegs(sampled_regs, print, out);
+  }
+
+  // Appends the lines of the registers which changed since the last step to the string
+  static void FormatRegDiffs(const SampledRegs &sampled_regs,
+                             const SampledRegs &regs_from_last_step, std::string &out) {
     bool print[kRegCount];
     std::fill(print, print + kRegCount, true);
 
@@ -82,7 +84,13 @@ public:
         print[reg_id] = false;
       }
     }
+    FormatSelectedRegs(sampled_regs, print, out);
+  }
 
+private:
+  static void FormatSelectedRegs(const SampledRegs &sampled_regs, const bool (&print)[kRegCount],
+                                 std::string &out) {
+    char buf[32];
     auto count = 0U;
     for (uint8_t reg_id = 0x0U; reg_id < kRegCount; ++reg_id) {
       if (!print[reg_id]) {
@@ -91,23 +99,23 @@ public:
       count += 1U;
 
       if ((count % kRegsPerRow) != 1U) {
-        printf(" | ");
+        out += " | ";
       }
 
       const auto &name = sampled_regs.names[reg_id];
       const auto &value = sampled_regs.values[reg_id];
-      printf("%6s = %08x", name, value);
+      std::snprintf(buf, sizeof(buf), "%6s = %08x", name, value);
+      out += buf;
       if ((count % kRegsPerRow) == 0) {
-        printf("\n");
+        out += '\n';
       }
     }
     // Print a newline if the last register was not printed
     if ((count % kRegsPerRow) != 0) {
-      printf("\n");
+      out += '\n';
     }
   }
 
-private:
   /**
    * @brief Constructs a RegPrinter object
    */
@@ -0,0 +1,136 @@
+#include "fuzz/fuzz_target.h"
+#include "../microemu/test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+using namespace libmicroemu;
+using test::WriteCode;
+using test::WriteVectorTable;
+
+namespace {
+constexpr uint32_t kInputAdr = 0x20000100U;
+
+// Calls the harness at 0xC0 and spins after it returned. The first input byte selects whether
+// the harness returns (0), spins (1), exits with a failure (2) or exits successfully (3).
+StatusCode LoadProgram(Machine &machine, uint8_t *flash_seg) {
+  WriteVectorTable(flash_seg, 0x20001000U, 0x80U);
+  WriteCode(flash_seg, 0x80U,
+            {
+                0x24C1U, // 0x80: movs r4, #0xC1
+                0x47A0U, // 0x82: blx r4
+                0xE7FEU, // 0x84: b .
+            });
+  WriteCode(flash_seg, 0xC0U,
+            {
+                0x7802U, // 0xC0: ldrb r2, [r0]
+                0x2A01U, // 0xC2: cmp r2, #1
+                0xD004U, // 0xC4: beq 0xD0
+                0x2A02U, // 0xC6: cmp r2, #2
+                0xD003U, // 0xC8: beq 0xD2
+                0x2A03U, // 0xCA: cmp r2, #3
+                0xD004U, // 0xCC: beq 0xD8
+                0x4770U, // 0xCE: bx lr
+                0xE7FEU, // 0xD0: b .
+                0x2018U, // 0xD2: movs r0, #0x18 (SYS_EXIT)
+                0x2100U, // 0xD4: movs r1, #0
+                0xBEABU, // 0xD6: bkpt 0xab
+                0x2018U, // 0xD8: movs r0, #0x18 (SYS_EXIT)
+                0x2102U, // 0xDA: movs r1, #2
+                0x0409U, // 0xDC: lsls r1, r1, #16
+                0x3126U, // 0xDE: adds r1, #0x26 (ADP_Stopped_ApplicationExit)
+                0xBEABU, // 0xE0: bkpt 0xab
+            });
+  return machine.Reset();
+}
+
+void SetEnv(const char *name, const char *value) {
+  if (value == nullptr) {
+    unsetenv(name);
+  } else {
+    setenv(name, value, 1);
+  }
+}
+} // namespace
+
+/// \test FuzzTargetTest
+/// \test_verifies
+/// \test_item Boot, RunOne
+/// \test_scenario boot to a harness whose address has the thumb bit set and run inputs which
+/// return, spin, exit with a failure and exit successfully
+/// \test_expected_behaviour The outcomes are kReturned, kTimeout, kCrash and kReturned. Every run
+/// starts from the state at the harness
+TEST(FuzzTargetTest, RunOne_Inputs_OutcomeClassified) {
+  FuzzConfig config;
+  config.harness_pc = 0xC1U;
+  config.input_adr = kInputAdr;
+  config.input_size = 4U;
+  config.boot_limit = 10;
+  config.instr_limit = 100;
+  FuzzTarget target;
+  ASSERT_EQ(target.Boot(config, LoadProgram), StatusCode::kSuccess);
+
+  const uint8_t returned[] = {0U};
+  const uint8_t timeout[] = {1U};
+  const uint8_t crash[] = {2U};
+  const uint8_t exited[] = {3U, 0xAAU, 0xBBU, 0xCCU, 0xDDU};
+  for (u32 run = 0U; run < 2U; ++run) {
+    ASSERT_EQ(target.RunOne(returned, sizeof(returned)), FuzzOutcome::kReturned);
+    ASSERT_EQ(target.GetLastStatusCode(), StatusCode::kStopAddressReached);
+    ASSERT_EQ(target.RunOne(timeout, sizeof(timeout)), FuzzOutcome::kTimeout);
+    ASSERT_EQ(target.RunOne(crash, sizeof(crash)), FuzzOutcome::kCrash);
+    ASSERT_NE(target.GetLastExitCode(), static_cast<uint32_t>(EXIT_SUCCESS));
+    ASSERT_EQ(target.RunOne(exited, sizeof(exited)), FuzzOutcome::kReturned);
+    ASSERT_EQ(target.GetLastStatusCode(), StatusCode::kSuccess);
+  }
+
+  // Longer inputs are truncated to the guest buffer
+  u8 buf[5U]{};
+  ASSERT_EQ(target.GetMachine().ReadMemory(kInputAdr, buf, sizeof(buf)), StatusCode::kSuccess);
+  ASSERT_EQ(buf[3U], 0xCCU);
+  ASSERT_NE(buf[4U], 0xDDU);
+}
+
+/// \test FuzzTargetTest
+/// \test_verifies
+/// \test_item ReadFuzzConfigFromEnv
+/// \test_scenario read the configuration with missing, invalid, hexadecimal and decimal values
+/// \test_expected_behaviour Missing required or invalid values are rejected, valid values are
+/// parsed and optional values keep their defaults
+TEST(FuzzTargetTest, ReadFuzzConfigFromEnv_Values_Parsed) {
+  SetEnv("MICROEMU_FUZZ_ELF", nullptr);
+  SetEnv("MICROEMU_FUZZ_MEMORY_CONFIG", nullptr);
+  SetEnv("MICROEMU_FUZZ_HARNESS_PC", "0x8001");
+  SetEnv("MICROEMU_FUZZ_INPUT_ADR", "0x20000100");
+  SetEnv("MICROEMU_FUZZ_INPUT_SIZE", "256");
+  SetEnv("MICROEMU_FUZZ_INSTR_LIMIT", nullptr);
+  FuzzConfig config;
+  ASSERT_FALSE(ReadFuzzConfigFromEnv(config));
+
+  SetEnv("MICROEMU_FUZZ_ELF", "firmware.elf");
+  ASSERT_TRUE(ReadFuzzConfigFromEnv(config));
+  ASSERT_EQ(config.elf_file, "firmware.elf");
+  ASSERT_EQ(config.memory_config, "MINIMAL");
+  ASSERT_EQ(config.harness_pc, 0x8001U);
+  ASSERT_EQ(config.input_adr, 0x20000100U);
+  ASSERT_EQ(config.input_size, 256U);
+  ASSERT_EQ(config.instr_limit, FuzzConfig{}.instr_limit);
+
+  SetEnv("MICROEMU_FUZZ_MEMORY_CONFIG", "STDLIB");
+  SetEnv("MICROEMU_FUZZ_INSTR_LIMIT", "5000");
+  ASSERT_TRUE(ReadFuzzConfigFromEnv(config));
+  ASSERT_EQ(config.memory_config, "STDLIB");
+  ASSERT_EQ(config.instr_limit, 5000);
+
+  SetEnv("MICROEMU_FUZZ_INPUT_SIZE", "12k");
+  ASSERT_FALSE(ReadFuzzConfigFromEnv(config));
+  SetEnv("MICROEMU_FUZZ_INPUT_SIZE", nullptr);
+  ASSERT_FALSE(ReadFuzzConfigFromEnv(config));
+
+  for (const char *name : {"MICROEMU_FUZZ_ELF", "MICROEMU_FUZZ_MEMORY_CONFIG",
+                           "MICROEMU_FUZZ_HARNESS_PC", "MICROEMU_FUZZ_INPUT_ADR",
+                           "MICROEMU_FUZZ_INSTR_LIMIT"}) {
+    SetEnv(name, nullptr);
+  }
+}
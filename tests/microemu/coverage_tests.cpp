@@ -0,0 +1,68 @@
+#include "libmicroemu/machine.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace libmicroemu;
+using test::MakeFlashImage;
+
+/// \test CoverageTest
+/// \test_verifies
+/// \test_item SetCoverageMap
+/// \test_scenario a program executes one instruction without a branch and then spins in a loop
+/// \test_expected_behaviour Only the taken branches are counted. The first edge starts at the
+/// reset location, all further edges are the same loop edge
+TEST(CoverageTest, Exec_SpinningLoop_EdgesCounted) {
+  auto flash = MakeFlashImage(0x20001000U, 0x8U, {0x2000U, 0xE7FEU}); // movs r0, #0; b .
+  std::vector<u8> ram(0x1000U);
+
+  Machine machine;
+  machine.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  machine.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  std::vector<u8> bitmap(0x1000U);
+  ASSERT_EQ(machine.SetCoverageMap(bitmap.data(), 0x1001U), StatusCode::kOutOfRange);
+  ASSERT_EQ(machine.SetCoverageMap(bitmap.data(), bitmap.size()), StatusCode::kSuccess);
+  ASSERT_EQ(machine.Reset(), StatusCode::kSuccess);
+
+  ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+  ASSERT_EQ(std::accumulate(bitmap.begin(), bitmap.end(), 0U), 9U);
+  ASSERT_EQ(std::count_if(bitmap.begin(), bitmap.end(), [](u8 hits) { return hits != 0U; }), 2);
+  ASSERT_EQ(*std::max_element(bitmap.begin(), bitmap.end()), 8U);
+
+  ASSERT_EQ(machine.SetCoverageMap(nullptr, 0U), StatusCode::kSuccess);
+  ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+  ASSERT_EQ(std::accumulate(bitmap.begin(), bitmap.end(), 0U), 9U);
+}
+
+/// \test CoverageTest
+/// \test_verifies
+/// \test_item SetCoverageMap
+/// \test_scenario a 32-bit instruction is executed, then a short forward branch skips one 16-bit
+/// instruction. Both advance the pc by 4
+/// \test_expected_behaviour Only the branch and the loop after it are counted as edges
+TEST(CoverageTest, Exec_ShortForwardBranch_EdgeCounted) {
+  auto flash = MakeFlashImage(0x20001000U, 0x8U,
+                              {
+                                  0x2000U,          // 0x08: movs r0, #0
+                                  0xF04FU, 0x0101U, // 0x0A: mov.w r1, #1
+                                  0xE000U,          // 0x0E: b 0x12
+                                  0x2001U,          // 0x10: movs r0, #1
+                                  0xE7FEU,          // 0x12: b .
+                              });
+  std::vector<u8> ram(0x1000U);
+
+  Machine machine;
+  machine.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  machine.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  std::vector<u8> bitmap(0x1000U);
+  ASSERT_EQ(machine.SetCoverageMap(bitmap.data(), bitmap.size()), StatusCode::kSuccess);
+  ASSERT_EQ(machine.Reset(), StatusCode::kSuccess);
+
+  ASSERT_TRUE(machine.Exec(4).IsMaxInstructionsReached());
+  ASSERT_EQ(std::accumulate(bitmap.begin(), bitmap.end(), 0U), 2U);
+  ASSERT_EQ(std::count_if(bitmap.begin(), bitmap.end(), [](u8 hits) { return hits != 0U; }), 2);
+}
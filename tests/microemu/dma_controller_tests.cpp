@@ -0,0 +1,227 @@
+#include "libmicroemu/dma_controller.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace libmicroemu;
+
+namespace {
+constexpr me_adr_t kRamVadr = 0x20000000U;
+constexpr me_adr_t kDataRegVadr = 0x40001000U;
+
+class FakeDmaContext : public test::FakePeripheralContext {
+public:
+  StatusCode ReadValue(me_adr_t vadr, me_size_t size, u32 &value) noexcept override {
+    value = 0U;
+    return ReadMemory(vadr, reinterpret_cast<u8 *>(&value), size);
+  }
+
+  StatusCode WriteValue(me_adr_t vadr, me_size_t size, u32 value) noexcept override {
+    if (vadr == kDataRegVadr) {
+      data_reg_writes.push_back(value);
+      return StatusCode::kSuccess;
+    }
+    return WriteMemory(vadr, reinterpret_cast<const u8 *>(&value), size);
+  }
+
+  StatusCode ReadMemory(me_adr_t vadr, u8 *dst, me_size_t size) noexcept override {
+    if ((vadr < kRamVadr) || (vadr - kRamVadr + size > ram.size())) {
+      return StatusCode::kMemInaccesible;
+    }
+    std::memcpy(dst, &ram[vadr - kRamVadr], size);
+    return StatusCode::kSuccess;
+  }
+
+  StatusCode WriteMemory(me_adr_t vadr, const u8 *src, me_size_t size) noexcept override {
+    if ((vadr < kRamVadr) || (vadr - kRamVadr + size > ram.size())) {
+      return StatusCode::kMemInaccesible;
+    }
+    std::memcpy(&ram[vadr - kRamVadr], src, size);
+    return StatusCode::kSuccess;
+  }
+
+  std::array<u8, 0x2000U> ram{};
+  std::vector<u32> data_reg_writes;
+};
+
+constexpr me_offset_t ChannelReg(u32 ch, me_offset_t reg) {
+  return DmaController::kChannelOffset + ch * DmaController::kChannelStride + reg;
+}
+} // namespace
+
+/// \test DmaControllerTest
+/// \test_verifies
+/// \test_item DmaController
+/// \test_scenario start a memory-to-memory transfer of words on channel 1
+/// \test_expected_behaviour The first half of the block is copied at half the modelled duration
+/// and HTIF is set, the rest at the completion time. Then TCIF is set and the transfer complete
+/// interrupt of the channel is set pending
+TEST(DmaControllerTest, Mem2Mem_Words_CopiedAtCompletion) {
+  DmaController dma(2U, 10U, 2U);
+  FakeDmaContext ctx;
+  for (me_size_t i = 0U; i < 0x1000U; ++i) {
+    ctx.ram[i] = static_cast<u8>(i * 3U);
+  }
+  dma.Reset(ctx);
+
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(1U, DmaController::kCndtrOffset), 4U, 0x400U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(1U, DmaController::kCparOffset), 4U, kRamVadr),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(1U, DmaController::kCmarOffset), 4U, kRamVadr + 0x1000U),
+            StatusCode::kSuccess);
+  const u32 ccr = DmaController::kCcrEnMsk | DmaController::kCcrTcieMsk |
+                  DmaController::kCcrPincMsk | DmaController::kCcrMincMsk |
+                  DmaController::kCcrMem2MemMsk | (2U << DmaController::kCcrPsizePos) |
+                  (2U << DmaController::kCcrMsizePos);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(1U, DmaController::kCcrOffset), 4U, ccr),
+            StatusCode::kSuccess);
+  ASSERT_EQ(ctx.wake_up, 0x400U);
+  ASSERT_EQ(ctx.ram[0x1001U], 0x0U);
+
+  ctx.time = 0x400U;
+  ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(std::memcmp(&ctx.ram[0x0U], &ctx.ram[0x1000U], 0x800U), 0);
+  ASSERT_EQ(ctx.ram[0x1801U], 0x0U);
+  ASSERT_EQ(ctx.pending_irq, -1); // half transfer interrupt not enabled
+  ASSERT_EQ(ctx.wake_up, 0x800U);
+  u32 value{0U};
+  ASSERT_EQ(dma.Read(ctx, DmaController::kIsrOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, (DmaController::kGifMsk | DmaController::kHtifMsk) << 4U);
+  ASSERT_EQ(dma.Read(ctx, ChannelReg(1U, DmaController::kCndtrOffset), 4U, value),
+            StatusCode::kSuccess);
+  ASSERT_EQ(value, 0x200U);
+
+  ctx.time = 0x800U;
+  ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(std::memcmp(&ctx.ram[0x0U], &ctx.ram[0x1000U], 0x1000U), 0);
+  ASSERT_EQ(ctx.pending_irq, 11);
+  ASSERT_EQ(ctx.wake_up, kNoWakeUp);
+
+  ASSERT_EQ(dma.Read(ctx, DmaController::kIsrOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, (DmaController::kGifMsk | DmaController::kTcifMsk | DmaController::kHtifMsk)
+                       << 4U);
+  ASSERT_EQ(dma.Read(ctx, ChannelReg(1U, DmaController::kCndtrOffset), 4U, value),
+            StatusCode::kSuccess);
+  ASSERT_EQ(value, 0U);
+  ASSERT_EQ(dma.Write(ctx, DmaController::kIfcrOffset, 4U, DmaController::kGifMsk << 4U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Read(ctx, DmaController::kIsrOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, 0U);
+}
+
+/// \test DmaControllerTest
+/// \test_verifies
+/// \test_item DmaController
+/// \test_scenario transfer bytes from memory to a fixed data register, then from an unmapped
+/// address
+/// \test_expected_behaviour The bytes are written one by one to the register, one per half of
+/// the transfer. The faulty transfer sets the error flag and disables the channel
+TEST(DmaControllerTest, Mem2Periph_FixedRegister_ElementWise) {
+  DmaController dma(1U, 3U);
+  FakeDmaContext ctx;
+  ctx.ram[0x0U] = 'o';
+  ctx.ram[0x1U] = 'k';
+  dma.Reset(ctx);
+
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCndtrOffset), 4U, 2U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCparOffset), 4U, kDataRegVadr),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCmarOffset), 4U, kRamVadr),
+            StatusCode::kSuccess);
+  const u32 ccr = DmaController::kCcrEnMsk | DmaController::kCcrTeieMsk |
+                  DmaController::kCcrDirMsk | DmaController::kCcrMincMsk;
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCcrOffset), 4U, ccr),
+            StatusCode::kSuccess);
+  ctx.time = ctx.wake_up;
+  ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(ctx.data_reg_writes, (std::vector<u32>{'o'}));
+  ctx.time = ctx.wake_up;
+  ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(ctx.data_reg_writes, (std::vector<u32>{'o', 'k'}));
+  ASSERT_EQ(ctx.pending_irq, -1); // transfer complete interrupt not enabled
+
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCcrOffset), 4U, 0U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCndtrOffset), 4U, 1U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCmarOffset), 4U, 0x0U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCcrOffset), 4U, ccr),
+            StatusCode::kSuccess);
+  ctx.time = ctx.wake_up;
+  ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(ctx.pending_irq, 3);
+  u32 value{0U};
+  ASSERT_EQ(dma.Read(ctx, DmaController::kIsrOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_NE(value & DmaController::kTeifMsk, 0U);
+  ASSERT_EQ(dma.Read(ctx, ChannelReg(0U, DmaController::kCcrOffset), 4U, value),
+            StatusCode::kSuccess);
+  ASSERT_EQ(value & DmaController::kCcrEnMsk, 0U);
+}
+
+/// \test DmaControllerTest
+/// \test_verifies
+/// \test_item DmaController
+/// \test_scenario transfer four bytes from memory to a fixed data register in circular mode with
+/// the half transfer and the transfer complete interrupt enabled. The flags are cleared after
+/// every interrupt
+/// \test_expected_behaviour Each round raises the half transfer interrupt after two bytes and the
+/// transfer complete interrupt after four bytes. CNDTR counts the remaining bytes and is reloaded
+/// for the next round
+TEST(DmaControllerTest, Mem2Periph_Circular_HalfTransferBeforeComplete) {
+  DmaController dma(1U, 7U, 10U);
+  FakeDmaContext ctx;
+  for (u8 i = 0U; i < 4U; ++i) {
+    ctx.ram[i] = static_cast<u8>('a' + i);
+  }
+  dma.Reset(ctx);
+
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCndtrOffset), 4U, 4U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCparOffset), 4U, kDataRegVadr),
+            StatusCode::kSuccess);
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCmarOffset), 4U, kRamVadr),
+            StatusCode::kSuccess);
+  const u32 ccr = DmaController::kCcrEnMsk | DmaController::kCcrTcieMsk |
+                  DmaController::kCcrHtieMsk | DmaController::kCcrDirMsk |
+                  DmaController::kCcrCircMsk | DmaController::kCcrMincMsk;
+  ASSERT_EQ(dma.Write(ctx, ChannelReg(0U, DmaController::kCcrOffset), 4U, ccr),
+            StatusCode::kSuccess);
+
+  struct Event {
+    u64 time;
+    u32 flags;
+    u32 cndtr;
+    std::size_t no_of_writes;
+  };
+  const std::array<Event, 4U> events{{
+      {20U, DmaController::kGifMsk | DmaController::kHtifMsk, 2U, 2U},
+      {40U, DmaController::kGifMsk | DmaController::kTcifMsk, 4U, 4U},
+      {60U, DmaController::kGifMsk | DmaController::kHtifMsk, 2U, 6U},
+      {80U, DmaController::kGifMsk | DmaController::kTcifMsk, 4U, 8U},
+  }};
+  for (const auto &event : events) {
+    ASSERT_EQ(ctx.wake_up, event.time);
+    ctx.time = event.time;
+    ctx.pending_irq = -1;
+    ASSERT_EQ(dma.Tick(ctx), StatusCode::kSuccess);
+    ASSERT_EQ(ctx.pending_irq, 7);
+    ASSERT_EQ(ctx.data_reg_writes.size(), event.no_of_writes);
+
+    u32 value{0U};
+    ASSERT_EQ(dma.Read(ctx, DmaController::kIsrOffset, 4U, value), StatusCode::kSuccess);
+    ASSERT_EQ(value, event.flags);
+    ASSERT_EQ(dma.Read(ctx, ChannelReg(0U, DmaController::kCndtrOffset), 4U, value),
+              StatusCode::kSuccess);
+    ASSERT_EQ(value, event.cndtr);
+    ASSERT_EQ(dma.Write(ctx, DmaController::kIfcrOffset, 4U, DmaController::kGifMsk),
+              StatusCode::kSuccess);
+  }
+  ASSERT_EQ(ctx.data_reg_writes, (std::vector<u32>{'a', 'b', 'c', 'd', 'a', 'b', 'c', 'd'}));
+}
@@ -0,0 +1,151 @@
+#include "libmicroemu/fault_campaign.h"
+#include "libmicroemu/machine.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace libmicroemu;
+using test::WriteCode;
+using test::WriteVectorTable;
+
+namespace {
+constexpr me_adr_t kRamVadr = 0x20000000U;
+constexpr me_adr_t kErrorLoopAdr = 0x1EU;
+
+// Stores 5 to RAM, branches to an endless error loop if r2 != 5 and exits through semihosting
+StatusCode SetupProgram(Machine &machine, u8 *flash_seg) {
+  WriteVectorTable(flash_seg, 0x20001000U, 0x8U);
+  WriteCode(flash_seg, 0x8U,
+            {
+                0x2205U, // movs r2, #5
+                0x2301U, // movs r3, #1
+                0x075BU, // lsls r3, r3, #29
+                0x601AU, // str r2, [r3]
+                0x2A05U, // cmp r2, #5
+                0xD104U, // bne 0x1e
+                0x2018U, // movs r0, #0x18 (SYS_EXIT)
+                0x2102U, // movs r1, #2
+                0x0409U, // lsls r1, r1, #16
+                0x3126U, // adds r1, #0x26 (ADP_Stopped_ApplicationExit)
+                0xBEABU, // bkpt 0xab
+                0xE7FEU, // 0x1e: b .
+            });
+  return machine.Reset();
+}
+
+Fault RegisterFault(u64 instruction, RegisterId reg_id, u8 bit) {
+  Fault fault;
+  fault.instruction = instruction;
+  fault.location = FaultLocation::kRegister;
+  fault.reg_id = reg_id;
+  fault.bit = bit;
+  return fault;
+}
+
+Fault MemoryFault(u64 instruction, me_adr_t adr, u8 bit) {
+  Fault fault;
+  fault.instruction = instruction;
+  fault.location = FaultLocation::kMemory;
+  fault.adr = adr;
+  fault.bit = bit;
+  return fault;
+}
+} // namespace
+
+/// \test FaultCampaignTest
+/// \test_verifies
+/// \test_item FaultCampaign::Run
+/// \test_scenario single bits of registers and flash are flipped at different instructions of a
+/// program which stores a value, checks it and exits
+/// \test_expected_behaviour Every fault is classified by the outcome of its own run, independent
+/// of the order of the faults and the thread which runs it
+TEST(FaultCampaignTest, Run_RegisterAndFlashFaults_OutcomesClassified) {
+  FaultCampaign campaign;
+  campaign.SetFlashSegment(0x100U, 0x0U);
+  campaign.SetRam1Segment(0x1000U, kRamVadr);
+  campaign.SetSetupCallback(SetupProgram);
+  ASSERT_EQ(campaign.RunGolden(), StatusCode::kSuccess);
+  ASSERT_EQ(campaign.GetGoldenExitCode(), 0U);
+  const u64 golden_instructions = campaign.GetGoldenInstructions();
+  ASSERT_GT(golden_instructions, 9U);
+
+  const std::array<Fault, 5U> faults = {
+      RegisterFault(9U, RegisterId::kR1, 1U), // wrong reason code
+      RegisterFault(4U, RegisterId::kR2, 1U), // compared value differs
+      RegisterFault(3U, RegisterId::kR3, 2U), // stored to another address
+      RegisterFault(0U, RegisterId::kR0, 5U), // overwritten before use
+      MemoryFault(2U, 0x0U, 4U),              // initial stack pointer, already loaded
+  };
+  std::array<FaultResult, faults.size()> results{};
+  ASSERT_EQ(campaign.Run(faults.data(), faults.size(), results.data(), 2U), StatusCode::kSuccess);
+
+  EXPECT_EQ(results[0U].outcome, FaultOutcome::kDetected);
+  EXPECT_EQ(results[1U].outcome, FaultOutcome::kHang);
+  EXPECT_EQ(results[1U].instructions, 2U * golden_instructions);
+  EXPECT_EQ(results[2U].outcome, FaultOutcome::kSilentCorruption);
+  EXPECT_EQ(results[3U].outcome, FaultOutcome::kMasked);
+  EXPECT_EQ(results[3U].instructions, golden_instructions);
+  EXPECT_EQ(results[4U].outcome, FaultOutcome::kMasked);
+
+  const auto late_fault = RegisterFault(golden_instructions, RegisterId::kR0, 0U);
+  ASSERT_EQ(campaign.Run(&late_fault, 1U, results.data()), StatusCode::kOutOfRange);
+}
+
+/// \test FaultCampaignTest
+/// \test_verifies
+/// \test_item FaultCampaign::Run
+/// \test_scenario a bit of the stored RAM value is flipped, followed by later faults which do
+/// not change the result. All faults run on one thread
+/// \test_expected_behaviour The RAM fault is a silent corruption. The flipped RAM bit is undone
+/// before the next run, so the later faults are masked
+TEST(FaultCampaignTest, Run_RamFault_UndoneBetweenRuns) {
+  FaultCampaign campaign;
+  campaign.SetFlashSegment(0x100U, 0x0U);
+  campaign.SetRam1Segment(0x1000U, kRamVadr);
+  campaign.SetSetupCallback(SetupProgram);
+  ASSERT_EQ(campaign.RunGolden(), StatusCode::kSuccess);
+
+  const std::array<Fault, 4U> faults = {
+      MemoryFault(4U, kRamVadr, 0U),          // stored value, not read again
+      RegisterFault(5U, RegisterId::kR0, 5U), // overwritten before use
+      RegisterFault(6U, RegisterId::kR0, 5U), // overwritten before use
+      MemoryFault(2U, kRamVadr, 0U),          // overwritten by the store
+  };
+  std::array<FaultResult, faults.size()> results{};
+  ASSERT_EQ(campaign.Run(faults.data(), faults.size(), results.data(), 1U), StatusCode::kSuccess);
+
+  EXPECT_EQ(results[0U].outcome, FaultOutcome::kSilentCorruption);
+  EXPECT_EQ(results[1U].outcome, FaultOutcome::kMasked);
+  EXPECT_EQ(results[2U].outcome, FaultOutcome::kMasked);
+  EXPECT_EQ(results[3U].outcome, FaultOutcome::kMasked);
+}
+
+/// \test FaultCampaignTest
+/// \test_verifies
+/// \test_item FaultCampaign::SetDetectionAddress
+/// \test_scenario the error loop of the program is set as detection address with the thumb bit
+/// set. A fault branches to the loop, another one does not change the result
+/// \test_expected_behaviour The run which reaches the error loop is detected when it enters the
+/// loop instead of hanging, the other run is masked
+TEST(FaultCampaignTest, Run_DetectionAddressReached_Detected) {
+  FaultCampaign campaign;
+  campaign.SetFlashSegment(0x100U, 0x0U);
+  campaign.SetRam1Segment(0x1000U, kRamVadr);
+  campaign.SetSetupCallback(SetupProgram);
+  campaign.SetDetectionAddress(kErrorLoopAdr | 0x1U);
+  ASSERT_EQ(campaign.RunGolden(), StatusCode::kSuccess);
+
+  const std::array<Fault, 2U> faults = {
+      RegisterFault(4U, RegisterId::kR2, 1U), // compared value differs
+      RegisterFault(0U, RegisterId::kR0, 5U), // overwritten before use
+  };
+  std::array<FaultResult, faults.size()> results{};
+  ASSERT_EQ(campaign.Run(faults.data(), faults.size(), results.data()), StatusCode::kSuccess);
+
+  EXPECT_EQ(results[0U].outcome, FaultOutcome::kDetected);
+  EXPECT_EQ(results[0U].status_code, StatusCode::kStopAddressReached);
+  EXPECT_EQ(results[0U].instructions, 6U);
+  EXPECT_EQ(results[1U].outcome, FaultOutcome::kMasked);
+}
@@ -0,0 +1,175 @@
+#include "libmicroemu/firmware_image.h"
+#include "libmicroemu/machine.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libmicroemu;
+
+namespace {
+constexpr me_size_t kFlashSize = 0x20000U;
+constexpr me_adr_t kFlashVadr = 0x0U;
+constexpr me_size_t kRamSize = 0x40000U;
+constexpr me_adr_t kRamVadr = 0x20000000U;
+constexpr const char *kElfFile = SYSTEST_INPUT_DIR "printf_rdimon/prebuilt/bin/printf_rdimon.elf";
+
+// A machine with its own RAM and console output
+struct ImageMachine {
+  explicit ImageMachine(const FirmwareImage &image) {
+    machine.SetRam1Segment(ram.data(), ram.size(), kRamVadr);
+    machine.SetConsoleCallback(
+        [this](const char *buf, me_size_t len) { console.append(buf, len); });
+    load_status = machine.Load(image, true);
+  }
+
+  std::vector<u8> ram = std::vector<u8>(kRamSize);
+  std::string console;
+  Machine machine;
+  StatusCode load_status{StatusCode::kError};
+};
+} // namespace
+
+/// \test FirmwareImageTest
+/// \test_verifies
+/// \test_item FirmwareImage::Load, Machine::Load(const FirmwareImage &)
+/// \test_scenario an ELF file which does not exist is loaded into an image, which is then loaded
+/// into a machine
+/// \test_expected_behaviour The image reports the open error and is not loaded. The machine
+/// rejects it
+TEST(FirmwareImageTest, Load_MissingFile_NotLoaded) {
+  FirmwareImage image;
+  ASSERT_EQ(image.Load("does_not_exist.elf", kFlashSize, kFlashVadr),
+            StatusCode::kOpenFileFailed);
+  ASSERT_FALSE(image.IsLoaded());
+
+  Machine machine;
+  ASSERT_EQ(machine.Load(image), StatusCode::kUnsuporrted);
+}
+
+/// \test FirmwareImageTest
+/// \test_verifies
+/// \test_item FirmwareImage::Load
+/// \test_scenario the file size of the data segment of an ELF file is corrupted to almost 4 GiB
+/// \test_expected_behaviour Load returns an error instead of aborting the process
+TEST(FirmwareImageTest, Load_CorruptSegmentSize_ErrorReturned) {
+  std::ifstream in(kElfFile, std::ios::binary);
+  ASSERT_TRUE(in.is_open());
+  std::vector<char> elf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  // Program header table of the little endian ELF32 file
+  const auto read_u32 = [&elf](std::size_t ofs) {
+    u32 value{0U};
+    std::memcpy(&value, &elf[ofs], sizeof(value));
+    return value;
+  };
+  const u32 phoff = read_u32(0x1CU);
+  const u32 phnum = read_u32(0x2CU) & 0xFFFFU;
+  bool is_corrupted{false};
+  for (u32 i = 0U; i < phnum; ++i) {
+    const std::size_t phdr = phoff + i * 0x20U;
+    constexpr u32 kRw = 0x6U; // PF_R | PF_W
+    if ((read_u32(phdr + 0x18U) & 0x7U) == kRw) {
+      const u32 filesz = 0xFFFFFF00U;
+      std::memcpy(&elf[phdr + 0x10U], &filesz, sizeof(filesz));
+      is_corrupted = true;
+    }
+  }
+  ASSERT_TRUE(is_corrupted);
+
+  const std::string corrupt_file = testing::TempDir() + "firmware_image_corrupt.elf";
+  std::ofstream out(corrupt_file, std::ios::binary);
+  out.write(elf.data(), static_cast<std::streamsize>(elf.size()));
+  out.close();
+
+  FirmwareImage image;
+  ASSERT_NE(image.Load(corrupt_file.c_str(), kFlashSize, kFlashVadr), StatusCode::kSuccess);
+  ASSERT_FALSE(image.IsLoaded());
+  std::remove(corrupt_file.c_str());
+}
+
+/// \test FirmwareImageTest
+/// \test_verifies
+/// \test_item FirmwareImage::Load, Machine::Load(const FirmwareImage &)
+/// \test_scenario one image is loaded into two machines. The first machine runs the program to
+/// its end on a host thread while the second one executes only a part of it. The second machine
+/// then runs to its end
+/// \test_expected_behaviour Both machines share the flash buffer of the image and terminate with
+/// the same output and RAM content. The partial run is not affected by the other machine and the
+/// flash buffer of the image is never written
+TEST(FirmwareImageTest, LoadIntoTwoMachines_RunIndependently_ImageUnchanged) {
+  FirmwareImage image;
+  ASSERT_EQ(image.Load(kElfFile, kFlashSize, kFlashVadr), StatusCode::kSuccess);
+  ASSERT_TRUE(image.IsLoaded());
+  ASSERT_EQ(image.GetFlashSize(), kFlashSize);
+  ASSERT_EQ(image.GetFlashVadr(), kFlashVadr);
+  const std::vector<u8> flash(image.GetFlash(), image.GetFlash() + image.GetFlashSize());
+
+  ImageMachine first(image);
+  ImageMachine second(image);
+  ASSERT_EQ(first.load_status, StatusCode::kSuccess);
+  ASSERT_EQ(second.load_status, StatusCode::kSuccess);
+  ASSERT_EQ(first.ram, second.ram);
+
+  StatusCode first_status{StatusCode::kError};
+  u32 first_exit_code{EXIT_FAILURE};
+  u64 first_instructions{0U};
+  std::thread host([&]() {
+    const auto res = first.machine.Exec(1000000);
+    first_status = res.GetStatusCode();
+    first_exit_code = res.GetProgramExitCode();
+    first_instructions = res.GetNoOfInstructions();
+  });
+  const auto partial_res = second.machine.Exec(100);
+  host.join();
+
+  ASSERT_EQ(first_status, StatusCode::kSuccess);
+  ASSERT_EQ(first_exit_code, 0U);
+  ASSERT_FALSE(first.console.empty());
+  ASSERT_TRUE(partial_res.IsMaxInstructionsReached());
+  ASSERT_LT(second.console.size(), first.console.size());
+
+  const auto second_res = second.machine.Exec(1000000);
+  ASSERT_EQ(second_res.GetStatusCode(), StatusCode::kSuccess);
+  ASSERT_EQ(second_res.GetProgramExitCode(), 0U);
+  ASSERT_EQ(partial_res.GetNoOfInstructions() + second_res.GetNoOfInstructions(),
+            first_instructions);
+  ASSERT_EQ(second.console, first.console);
+  ASSERT_EQ(second.ram, first.ram);
+
+  ASSERT_EQ(std::vector<u8>(image.GetFlash(), image.GetFlash() + image.GetFlashSize()), flash);
+}
+
+/// \test FirmwareImageTest
+/// \test_verifies
+/// \test_item Machine::Load(const char *, bool)
+/// \test_scenario an ELF file is loaded into a machine which borrows the flash of an image, then
+/// again after the machine got a flash segment of its own
+/// \test_expected_behaviour The first load is rejected and the image is not written. The second
+/// load writes to the flash segment of the machine
+TEST(FirmwareImageTest, LoadFileAfterImage_FlashBorrowed_ImageNotWritten) {
+  FirmwareImage image;
+  ASSERT_EQ(image.Load(kElfFile, kFlashSize, kFlashVadr), StatusCode::kSuccess);
+  ImageMachine image_machine(image);
+  ASSERT_EQ(image_machine.load_status, StatusCode::kSuccess);
+
+  // A byte of the own flash segment differs until the ELF file is loaded into it
+  std::vector<u8> flash(image.GetFlash(), image.GetFlash() + image.GetFlashSize());
+  const std::vector<u8> image_flash = flash;
+  flash[0x100U] ^= 0xFFU;
+
+  ASSERT_EQ(image_machine.machine.Load(kElfFile, true), StatusCode::kUnsuporrted);
+  ASSERT_EQ(std::vector<u8>(image.GetFlash(), image.GetFlash() + image.GetFlashSize()),
+            image_flash);
+
+  image_machine.machine.SetFlashSegment(flash.data(), flash.size(), kFlashVadr);
+  ASSERT_EQ(image_machine.machine.Load(kElfFile, true), StatusCode::kSuccess);
+  ASSERT_EQ(flash, image_flash);
+}
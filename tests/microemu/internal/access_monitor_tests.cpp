@@ -0,0 +1,81 @@
+#include "libmicroemu/internal/bus/access_monitor.h"
+
+#include <gtest/gtest.h>
+
+using namespace libmicroemu;
+using internal::AccessMonitor;
+
+/// \test AccessMonitorTest
+/// \test_verifies
+/// \test_item AddWatchpoint, OnWrite
+/// \test_scenario add a value-match write watchpoint and write different values into its range
+/// \test_expected_behaviour Only the matching write requests a stop
+TEST(AccessMonitorTest, OnWrite_ValueMatch_StopOnMatchingValue) {
+  AccessMonitor monitor;
+  u32 id{0U};
+  const auto flags = static_cast<WatchFlagsSet>(WatchFlags::kWrite) |
+                     static_cast<WatchFlagsSet>(WatchFlags::kValueMatch);
+  ASSERT_EQ(monitor.AddWatchpoint(0x20000100U, 4U, flags, 0xABU, id), StatusCode::kSuccess);
+
+  ASSERT_TRUE(monitor.IsMonitored(0x20000000U, 4U));
+  ASSERT_FALSE(monitor.IsMonitored(0x20000400U, 4U));
+
+  monitor.OnWrite(0x20000100U, 1U, 0x12U);
+  monitor.OnWrite(0x200000FCU, 4U, 0xABU);
+  ASSERT_FALSE(monitor.IsStopRequested());
+
+  monitor.OnWrite(0x20000102U, 1U, 0x1ABU);
+  ASSERT_TRUE(monitor.IsStopRequested());
+  ASSERT_EQ(monitor.TakeStopStatus(), StatusCode::kWatchpointHit);
+  ASSERT_FALSE(monitor.IsStopRequested());
+
+  WatchpointHit hit{};
+  ASSERT_TRUE(monitor.GetLastWatchpointHit(hit));
+  ASSERT_EQ(hit.vadr, 0x20000102U);
+  ASSERT_EQ(hit.value, 0xABU);
+  ASSERT_TRUE(hit.is_write);
+}
+
+/// \test AccessMonitorTest
+/// \test_verifies
+/// \test_item RemoveWatchpoint
+/// \test_scenario remove the only watchpoint of a page
+/// \test_expected_behaviour The page is no longer monitored
+TEST(AccessMonitorTest, RemoveWatchpoint_LastOfPage_PageNotMonitored) {
+  AccessMonitor monitor;
+  u32 id{0U};
+  ASSERT_EQ(monitor.AddWatchpoint(0x20000100U, 4U, static_cast<WatchFlagsSet>(WatchFlags::kRead),
+                                  0U, id),
+            StatusCode::kSuccess);
+  ASSERT_TRUE(monitor.IsMonitored(0x20000100U, 4U));
+
+  ASSERT_EQ(monitor.RemoveWatchpoint(id), StatusCode::kSuccess);
+  ASSERT_FALSE(monitor.IsMonitored(0x20000100U, 4U));
+  ASSERT_EQ(monitor.RemoveWatchpoint(id), StatusCode::kOutOfRange);
+}
+
+/// \test AccessMonitorTest
+/// \test_verifies
+/// \test_item SetStackGuard, OnWrite
+/// \test_scenario set a guard below the main stack and write below, into and above the guard
+/// \test_expected_behaviour Only the write into the guard is denied and requests a stop
+TEST(AccessMonitorTest, OnWrite_StackGuard_DenyAndStopInGuard) {
+  AccessMonitor monitor;
+  ASSERT_EQ(monitor.SetStackGuard(StackGuardId::kMain, 0x20001000U, 0x100U),
+            StatusCode::kSuccess);
+
+  ASSERT_EQ(monitor.OnWrite(0x20000EFCU, 4U, 0U), internal::AccessAction::kAllow);
+  ASSERT_EQ(monitor.OnWrite(0x20001000U, 4U, 0U), internal::AccessAction::kAllow);
+  ASSERT_FALSE(monitor.IsStopRequested());
+
+  ASSERT_EQ(monitor.OnWrite(0x20000FFCU, 4U, 0U), internal::AccessAction::kDeny);
+  ASSERT_TRUE(monitor.IsStopRequested());
+  ASSERT_EQ(monitor.TakeStopStatus(), StatusCode::kStackOverflow);
+
+  monitor.SetStackGuardAction(StackGuardAction::kFault);
+  ASSERT_EQ(monitor.OnWrite(0x20000F00U, 1U, 0U), internal::AccessAction::kDeny);
+  ASSERT_FALSE(monitor.IsStopRequested());
+
+  monitor.ClearStackGuards();
+  ASSERT_FALSE(monitor.IsMonitored(0x20000F00U, 4U));
+}
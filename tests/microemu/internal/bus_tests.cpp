@@ -0,0 +1,205 @@
+#include "libmicroemu/internal/bus/bus.h"
+#include "libmicroemu/internal/bus/endianess_converters.h"
+#include "libmicroemu/internal/bus/mem/mem_bit_band.h"
+#include "libmicroemu/internal/bus/mem/mem_rw.h"
+#include "libmicroemu/internal/bus/mem/mem_sparse.h"
+#include "libmicroemu/internal/bus/mem/page_flags.h"
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace libmicroemu;
+using internal::Bus;
+using internal::LittleToLittleEndianConverter;
+using internal::MemBitBand;
+using internal::MemRw;
+using internal::MemSparse;
+using internal::PageFlags;
+using internal::PageFlagsSet;
+using internal::PageFlagTable;
+using internal::SparsePageStore;
+
+namespace {
+struct FakeCpuAccessor {};
+
+using Ram0 = MemRw<0U, FakeCpuAccessor, LittleToLittleEndianConverter>;
+using Ram1 = MemRw<1U, FakeCpuAccessor, LittleToLittleEndianConverter>;
+using BitBand = MemBitBand<2U, FakeCpuAccessor>;
+using FakeBus = Bus<FakeCpuAccessor, void, NullLogger, Ram0, Ram1, BitBand>;
+using Sparse = MemSparse<3U, FakeCpuAccessor, LittleToLittleEndianConverter>;
+using SparseBus = Bus<FakeCpuAccessor, void, NullLogger, Ram0, BitBand, Sparse>;
+
+constexpr me_adr_t kRam0Vadr = 0x20000000U;
+constexpr me_size_t kRamSize = 0x2000U;
+constexpr me_adr_t kRam1Vadr = kRam0Vadr + kRamSize;
+} // namespace
+
+/// \test BusTest
+/// \test_verifies
+/// \test_item ReadBlock, WriteBlock
+/// \test_scenario copy a block which spans two adjacent RAM participants
+/// \test_expected_behaviour The block is split at the participant boundary and all touched pages
+/// are flagged dirty
+TEST(BusTest, WriteBlock_AcrossParticipants_CopiedAndDirty) {
+  std::array<u8, kRamSize> ram0{};
+  std::array<u8, kRamSize> ram1{};
+  std::array<PageFlagsSet, kRamSize / PageFlagTable::kPageSize> flags0{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram0(ram0.data(), ram0.size(), kRam0Vadr, flags0.data()),
+              Ram1(ram1.data(), ram1.size(), kRam1Vadr), BitBand());
+
+  std::array<u8, 0x1800U> src{};
+  for (me_size_t i = 0U; i < src.size(); ++i) {
+    src[i] = static_cast<u8>(i * 7U);
+  }
+  const me_adr_t vadr = kRam1Vadr - 0x1000U;
+  ASSERT_TRUE(bus.WriteBlock(cpua, vadr, src.data(), src.size()).IsOk());
+  ASSERT_EQ(ram0[0x1000U], src[0U]);
+  ASSERT_EQ(ram0[0x1FFFU], src[0xFFFU]);
+  ASSERT_EQ(ram1[0x0U], src[0x1000U]);
+  ASSERT_EQ(ram1[0x7FFU], src[0x17FFU]);
+  constexpr auto kDirtyMsk = static_cast<PageFlagsSet>(PageFlags::kDirty);
+  for (me_size_t page = 0x1000U / PageFlagTable::kPageSize; page < flags0.size(); ++page) {
+    ASSERT_EQ(flags0[page] & kDirtyMsk, kDirtyMsk);
+  }
+
+  std::array<u8, 0x1800U> dst{};
+  ASSERT_TRUE(bus.ReadBlock(cpua, vadr, dst.data(), dst.size()).IsOk());
+  ASSERT_EQ(dst, src);
+}
+
+/// \test BusTest
+/// \test_verifies
+/// \test_item ReadBlock
+/// \test_scenario read a block from a participant which is not backed by host memory and a block
+/// which runs into unmapped memory
+/// \test_expected_behaviour The alias region is read byte by byte, the unmapped byte fails
+TEST(BusTest, ReadBlock_AliasAndUnmapped_BytewiseAndError) {
+  std::array<u8, kRamSize> ram0{};
+  std::array<u8, kRamSize> ram1{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram0(ram0.data(), ram0.size(), kRam0Vadr),
+              Ram1(ram1.data(), ram1.size(), kRam1Vadr), BitBand());
+
+  ram0[0x0U] = 0x01U; // bit 0 set, bit 1 cleared
+  std::array<u8, 8U> bits{};
+  ASSERT_TRUE(bus.ReadBlock(cpua, 0x22000000U, bits.data(), bits.size()).IsOk());
+  // Every byte of an alias word reads the bit it maps to
+  const std::array<u8, 8U> expected{0x1U, 0x1U, 0x1U, 0x1U, 0x0U, 0x0U, 0x0U, 0x0U};
+  ASSERT_EQ(bits, expected);
+
+  std::array<u8, 0x10U> dst{};
+  ASSERT_EQ(bus.ReadBlock(cpua, kRam1Vadr + kRamSize - 0x8U, dst.data(), dst.size()).status_code,
+            StatusCode::kMemInaccesible);
+}
+
+/// \test BusTest
+/// \test_verifies
+/// \test_item ReadBlock, WriteBlock
+/// \test_scenario write a block across two sparse pages, then read a block which starts on an
+/// untouched sparse page and runs into RAM. Read a block which runs into a fault region
+/// \test_expected_behaviour The written pages are committed and keep the block. Untouched pages
+/// read as the fill value without being committed, the RAM part is read from the RAM. The fault
+/// region fails the read
+TEST(BusTest, SparseBlock_CommittedUntouchedAndRam_CopiedPerPage) {
+  std::array<u8, kRamSize> ram0{};
+  ram0[0x0U] = 0x5AU;
+  SparsePageStore store;
+  FakeCpuAccessor cpua;
+  SparseBus bus(Ram0(ram0.data(), ram0.size(), kRam0Vadr), BitBand(), Sparse(&store));
+
+  std::array<u8, 0x100U> src{};
+  for (me_size_t i = 0U; i < src.size(); ++i) {
+    src[i] = static_cast<u8>(i + 1U);
+  }
+  const me_adr_t src_vadr = kRam0Vadr - 0x1080U;
+  ASSERT_TRUE(bus.WriteBlock(cpua, src_vadr, src.data(), src.size()).IsOk());
+  ASSERT_EQ(store.GetNoOfCommittedPages(), 2U);
+
+  const me_adr_t vadr = kRam0Vadr - 0x3000U;
+  std::array<u8, 0x3010U> dst{};
+  ASSERT_TRUE(bus.ReadBlock(cpua, vadr, dst.data(), dst.size()).IsOk());
+  ASSERT_EQ(store.GetNoOfCommittedPages(), 2U);
+  for (me_size_t i = 0U; i < 0x3000U; ++i) {
+    const me_adr_t ofs = vadr + i - src_vadr;
+    const u8 expected = (ofs < src.size()) ? src[ofs] : SparsePageStore::kDefaultFillValue;
+    ASSERT_EQ(dst[i], expected);
+  }
+  ASSERT_EQ(dst[0x3000U], 0x5AU);
+  ASSERT_EQ(dst[0x3001U], 0x00U);
+
+  ASSERT_TRUE(store.AddFaultRegion(vadr + 0x800U, 0x10U));
+  ASSERT_EQ(bus.ReadBlock(cpua, vadr, dst.data(), 0x1000U).status_code,
+            StatusCode::kMemInaccesible);
+  ASSERT_TRUE(bus.ReadBlock(cpua, vadr, dst.data(), 0x800U).IsOk());
+}
+
+/// \test BusTest
+/// \test_verifies
+/// \test_item Read, Write, ReadBlock
+/// \test_scenario access RAM whose pages are flagged unfilled
+/// \test_expected_behaviour Only the touched pages are filled with the uninitialized memory
+/// pattern, the written bytes are kept
+TEST(BusTest, Access_UnfilledPages_FilledOnFirstAccess) {
+  std::array<u8, kRamSize> ram0{};
+  std::array<u8, kRamSize> ram1{};
+  std::array<PageFlagsSet, kRamSize / PageFlagTable::kPageSize + 1U> flags0{};
+  constexpr auto kUnfilledMsk = static_cast<PageFlagsSet>(PageFlags::kUnfilled);
+  for (me_size_t page = 0U; page < kRamSize / PageFlagTable::kPageSize; ++page) {
+    flags0[page] = kUnfilledMsk;
+  }
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram0(ram0.data(), ram0.size(), kRam0Vadr, flags0.data()),
+              Ram1(ram1.data(), ram1.size(), kRam1Vadr), BitBand());
+
+  ASSERT_TRUE(bus.Write<u8>(cpua, kRam0Vadr + 0x10U, 0x12U).IsOk());
+  ASSERT_EQ(bus.Read<u32>(cpua, kRam0Vadr + 0x10U).content, 0xFFFFFF12U);
+  ASSERT_EQ(ram0[0x3FFU], 0xFFU);
+  ASSERT_EQ(ram0[0x400U], 0x00U);
+
+  // Unaligned word spanning the second and third page
+  ASSERT_EQ(bus.Read<u32>(cpua, kRam0Vadr + 0x7FEU).content, 0xFFFFFFFFU);
+  ASSERT_EQ(ram0[0xBFFU], 0xFFU);
+
+  std::array<u8, 2U> dst{};
+  ASSERT_TRUE(bus.ReadBlock(cpua, kRam0Vadr + 0x1FFEU, dst.data(), dst.size()).IsOk());
+  ASSERT_EQ(dst[0U], 0xFFU);
+  ASSERT_EQ(ram0[0x1C00U], 0xFFU);
+  ASSERT_EQ(flags0[0x2U] & kUnfilledMsk, 0U);
+  ASSERT_EQ(flags0[0x3U] & kUnfilledMsk, kUnfilledMsk);
+  ASSERT_EQ(ram0[0xC00U], 0x00U);
+}
+
+/// \test BusTest
+/// \test_verifies
+/// \test_item SetStatistics
+/// \test_scenario access two RAM participants and a bit-band alias with assigned counters
+/// \test_expected_behaviour Every access is counted for its participant and width, block copies
+/// only add bytes
+TEST(BusTest, Statistics_MixedAccesses_CountedPerParticipant) {
+  std::array<u8, kRamSize> ram0{};
+  std::array<u8, kRamSize> ram1{};
+  std::array<BusRegionStatistics, 3U> stats{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram0(ram0.data(), ram0.size(), kRam0Vadr),
+              Ram1(ram1.data(), ram1.size(), kRam1Vadr), BitBand());
+  bus.SetStatistics(stats.data());
+
+  ASSERT_TRUE(bus.Write<u32>(cpua, kRam0Vadr, 0x1U).IsOk());
+  ASSERT_TRUE(bus.Read<u16>(cpua, kRam1Vadr).IsOk());
+  ASSERT_TRUE(bus.Read<u8>(cpua, 0x22000000U).IsOk());
+  std::array<u8, 0x20U> dst{};
+  ASSERT_TRUE(bus.ReadBlock(cpua, kRam1Vadr - 0x10U, dst.data(), dst.size()).IsOk());
+
+  ASSERT_EQ(stats[0U].writes.accesses[2U], 1U);
+  ASSERT_EQ(stats[0U].writes.bytes, 4U);
+  ASSERT_EQ(stats[0U].reads.accesses[2U], 1U); // backing word of the alias
+  ASSERT_EQ(stats[0U].reads.bytes, 4U + 0x10U);
+  ASSERT_EQ(stats[1U].reads.accesses[1U], 1U);
+  ASSERT_EQ(stats[1U].reads.GetAccesses(), 1U);
+  ASSERT_EQ(stats[1U].reads.bytes, 2U + 0x10U);
+  ASSERT_EQ(stats[2U].reads.accesses[0U], 1U);
+  ASSERT_EQ(stats[2U].fetches.GetAccesses(), 0U);
+}
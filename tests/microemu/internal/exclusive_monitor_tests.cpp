@@ -0,0 +1,196 @@
+#include "libmicroemu/cpu_states.h"
+#include "libmicroemu/internal/bus/bus.h"
+#include "libmicroemu/internal/bus/endianess_converters.h"
+#include "libmicroemu/internal/bus/mem/mem_rw.h"
+#include "libmicroemu/internal/bus/mem/mem_rw_optional.h"
+#include "libmicroemu/internal/executor/instr/load_store/load_mem.h"
+#include "libmicroemu/internal/executor/instr/load_store/store_mem.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+using namespace libmicroemu;
+using internal::BigToLittleEndianConverter;
+using internal::Bus;
+using internal::LittleToLittleEndianConverter;
+using internal::LoadMemExU32;
+using internal::MemRw;
+using internal::MemRwOptional;
+using internal::StoreMemExU32;
+using internal::WriteStatusCode;
+
+namespace {
+struct FakeCpuAccessor {
+  template <SpecialRegisterId SId> u32 ReadSpecialRegister() const {
+    return regs[static_cast<u32>(SId)];
+  }
+  u32 ReadSpecialRegister(SpecialRegisterId reg_id) const {
+    return regs[static_cast<u32>(reg_id)];
+  }
+  template <SpecialRegisterId SId> void WriteSpecialRegister(u32 value) {
+    regs[static_cast<u32>(SId)] = value;
+  }
+  ExclusiveMonitorStates &GetExclusiveMonitorStates() { return monitor; }
+
+  std::array<u32, CountPersistentSpecialRegisters()> regs{};
+  ExclusiveMonitorStates monitor;
+};
+
+struct FakeExceptionTrigger {
+  static void SetPending(FakeCpuAccessor &cpua, ExceptionType exception_type) {
+    static_cast<void>(cpua);
+    static_cast<void>(exception_type);
+  }
+};
+
+using Ram = MemRw<0U, FakeCpuAccessor, LittleToLittleEndianConverter>;
+using FakeBus = Bus<FakeCpuAccessor, FakeExceptionTrigger, NullLogger, Ram>;
+
+struct FakeInstrContext {
+  FakeCpuAccessor &cpua;
+  FakeBus &bus;
+};
+
+using Ldrex = LoadMemExU32<FakeInstrContext>;
+using Strex = StoreMemExU32<FakeInstrContext>;
+
+constexpr me_adr_t kRamVadr = 0x20000000U;
+} // namespace
+
+/// \test ExclusiveMonitorTest
+/// \test_verifies
+/// \test_item LoadMemExU32, StoreMemExU32
+/// \test_scenario store exclusive with and without a preceding load exclusive
+/// \test_expected_behaviour Only the store which follows a load exclusive succeeds
+TEST(ExclusiveMonitorTest, Strex_AfterLdrex_SucceedsOnce) {
+  std::array<u32, 4U> ram{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram(reinterpret_cast<u8 *>(ram.data()), sizeof(ram), kRamVadr));
+  const FakeInstrContext ictx{cpua, bus};
+
+  u32 rd{0xFFU};
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr, 0x1U, rd).IsOk());
+  ASSERT_EQ(rd, 0x1U);
+  ASSERT_EQ(ram[0U], 0x0U);
+
+  ASSERT_TRUE(Ldrex::Read(ictx, kRamVadr).IsOk());
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr + 4U, 0x2U, rd).IsOk());
+  ASSERT_EQ(rd, 0x1U);
+
+  ASSERT_TRUE(Ldrex::Read(ictx, kRamVadr).IsOk());
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr, 0x3U, rd).IsOk());
+  ASSERT_EQ(rd, 0x0U);
+  ASSERT_EQ(ram[0U], 0x3U);
+
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr, 0x4U, rd).IsOk());
+  ASSERT_EQ(rd, 0x1U);
+  ASSERT_EQ(ram[0U], 0x3U);
+}
+
+/// \test ExclusiveMonitorTest
+/// \test_verifies
+/// \test_item LoadMemExU32, StoreMemExU32
+/// \test_scenario two processors sharing the memory increment the same word in a LDREX/STREX
+/// loop from two host threads
+/// \test_expected_behaviour No increment is lost
+TEST(ExclusiveMonitorTest, Strex_SharedMemoryTwoThreads_NoLostUpdate) {
+  constexpr u32 kIncrements = 20000U;
+  alignas(4) std::array<u8, 4U> ram{};
+
+  auto increment = [&ram]() {
+    FakeCpuAccessor cpua;
+    FakeBus bus(Ram(ram.data(), ram.size(), kRamVadr));
+    const FakeInstrContext ictx{cpua, bus};
+    for (u32 i = 0U; i < kIncrements; ++i) {
+      u32 rd{1U};
+      while (rd != 0U) {
+        const auto value = Ldrex::Read(ictx, kRamVadr).content;
+        static_cast<void>(Strex::Write(ictx, kRamVadr, value + 1U, rd));
+      }
+    }
+  };
+  std::thread other(increment);
+  increment();
+  other.join();
+
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram(ram.data(), ram.size(), kRamVadr));
+  ASSERT_EQ(bus.Read<u32>(cpua, kRamVadr).content, 2U * kIncrements);
+}
+
+/// \test ExclusiveMonitorTest
+/// \test_verifies
+/// \test_item LoadMemExU32, StoreMemExU32
+/// \test_scenario a processor loads a word exclusively. Meanwhile a second processor on another
+/// host thread stores a different value to the word and then writes the old value back
+/// \test_expected_behaviour The store exclusive of the first processor fails although the word
+/// holds the loaded value again (ABA), and the retried LDREX/STREX pair succeeds
+TEST(ExclusiveMonitorTest, Strex_AbaByOtherThread_Fails) {
+  alignas(8) std::array<u8, 8U> ram{};
+
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram(ram.data(), ram.size(), kRamVadr));
+  const FakeInstrContext ictx{cpua, bus};
+  const auto loaded = Ldrex::Read(ictx, kRamVadr);
+  ASSERT_TRUE(loaded.IsOk());
+  ASSERT_EQ(loaded.content, 0x0U);
+
+  std::thread other([&ram]() {
+    FakeCpuAccessor other_cpua;
+    FakeBus other_bus(Ram(ram.data(), ram.size(), kRamVadr));
+    static_cast<void>(other_bus.Write<u32>(other_cpua, kRamVadr, 0x1U));
+    static_cast<void>(other_bus.Write<u32>(other_cpua, kRamVadr, 0x0U));
+  });
+  other.join();
+  ASSERT_EQ(bus.Read<u32>(cpua, kRamVadr).content, 0x0U);
+
+  u32 rd{0x0U};
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr, 0x2U, rd).IsOk());
+  ASSERT_EQ(rd, 0x1U);
+  ASSERT_EQ(bus.Read<u32>(cpua, kRamVadr).content, 0x0U);
+
+  ASSERT_TRUE(Ldrex::Read(ictx, kRamVadr).IsOk());
+  ASSERT_TRUE(Strex::Write(ictx, kRamVadr, 0x2U, rd).IsOk());
+  ASSERT_EQ(rd, 0x0U);
+  ASSERT_EQ(bus.Read<u32>(cpua, kRamVadr).content, 0x2U);
+}
+
+/// \test ExclusiveMonitorTest
+/// \test_verifies
+/// \test_item MemRw, MemRwOptional
+/// \test_scenario store exclusive to an aligned and an unaligned word of a memory with an
+/// endianess policy which swaps the bytes
+/// \test_expected_behaviour The value is stored in the byte order of the policy and read back
+/// unchanged. A second store exclusive with the same reservation fails
+TEST(ExclusiveMonitorTest, StoreExclusive_SwappingEndianess_StoresConvertedValue) {
+  using BigRam = MemRw<0U, FakeCpuAccessor, BigToLittleEndianConverter>;
+  using BigRamOptional = MemRwOptional<0U, FakeCpuAccessor, BigToLittleEndianConverter>;
+  std::array<u32, 4U> ram{};
+  FakeCpuAccessor cpua;
+  const BigRam mem(reinterpret_cast<u8 *>(ram.data()), sizeof(ram), kRamVadr);
+  const BigRamOptional mem_optional(reinterpret_cast<u8 *>(ram.data()), sizeof(ram), kRamVadr);
+
+  for (const me_adr_t ofs : {0x0U, 0x5U}) {
+    bool is_stored{false};
+    u32 version = mem.Reserve(kRamVadr + ofs);
+    ASSERT_EQ(mem.StoreExclusive<u32>(cpua, kRamVadr + ofs, version, 0x11223344U, is_stored)
+                  .status_code,
+              WriteStatusCode::kOk);
+    ASSERT_TRUE(is_stored);
+    ASSERT_EQ(mem.Read<u32>(cpua, kRamVadr + ofs).content, 0x11223344U);
+    ASSERT_EQ(mem.StoreExclusive<u32>(cpua, kRamVadr + ofs, version, 0x0U, is_stored).status_code,
+              WriteStatusCode::kOk);
+    ASSERT_FALSE(is_stored);
+
+    version = mem_optional.Reserve(kRamVadr + ofs);
+    ASSERT_EQ(
+        mem_optional.StoreExclusive<u32>(cpua, kRamVadr + ofs, version, 0x55667788U, is_stored)
+            .status_code,
+        WriteStatusCode::kOk);
+    ASSERT_TRUE(is_stored);
+    ASSERT_EQ(mem_optional.Read<u32>(cpua, kRamVadr + ofs).content, 0x55667788U);
+    ASSERT_EQ(reinterpret_cast<const u8 *>(ram.data())[ofs], 0x55U);
+  }
+}
@@ -0,0 +1,61 @@
+#include "libmicroemu/internal/bus/bus.h"
+#include "libmicroemu/internal/bus/endianess_converters.h"
+#include "libmicroemu/internal/bus/mem/mem_bit_band.h"
+#include "libmicroemu/internal/bus/mem/mem_rw.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace libmicroemu;
+using internal::Bus;
+using internal::LittleToLittleEndianConverter;
+using internal::MemBitBand;
+using internal::MemRw;
+
+namespace {
+struct FakeCpuAccessor {};
+
+using Ram = MemRw<0U, FakeCpuAccessor, LittleToLittleEndianConverter>;
+using BitBand = MemBitBand<1U, FakeCpuAccessor>;
+using FakeBus = Bus<FakeCpuAccessor, void, NullLogger, Ram, BitBand>;
+} // namespace
+
+/// \test MemBitBandTest
+/// \test_verifies
+/// \test_item Read, Write
+/// \test_scenario set and clear single bits of the SRAM through the alias region
+/// \test_expected_behaviour Only the addressed bit of the backing memory changes
+TEST(MemBitBandTest, Write_SramAlias_SingleBitChanged) {
+  std::array<u8, 0x100U> ram{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram(ram.data(), ram.size(), 0x20000000U), BitBand());
+
+  // byte 0x11, bit 3 -> 0x22000000 + 0x11 * 32 + 3 * 4
+  const me_adr_t alias = 0x22000000U + 0x11U * 32U + 3U * 4U;
+  ASSERT_TRUE(bus.Write<u32>(cpua, alias, 0x1U).IsOk());
+  ASSERT_EQ(ram[0x11U], 0x08U);
+  ASSERT_EQ(bus.Read<u8>(cpua, alias).content, 0x1U);
+
+  ram[0x11U] = 0xFFU;
+  ASSERT_TRUE(bus.Write<u8>(cpua, alias, 0x0U).IsOk());
+  ASSERT_EQ(ram[0x11U], 0xF7U);
+  ASSERT_EQ(ram[0x10U], 0x00U);
+  ASSERT_EQ(ram[0x12U], 0x00U);
+  ASSERT_EQ(bus.Read<u32>(cpua, alias).content, 0x0U);
+}
+
+/// \test MemBitBandTest
+/// \test_verifies
+/// \test_item Read
+/// \test_scenario access an alias word whose backing memory is not mapped
+/// \test_expected_behaviour The access fails like an access to unmapped memory
+TEST(MemBitBandTest, Read_UnmappedBacking_MemInaccesible) {
+  std::array<u8, 0x100U> ram{};
+  FakeCpuAccessor cpua;
+  FakeBus bus(Ram(ram.data(), ram.size(), 0x20000000U), BitBand());
+
+  ASSERT_EQ(bus.Read<u32>(cpua, 0x42000000U).status_code, StatusCode::kMemInaccesible);
+  ASSERT_EQ(bus.Read<u32>(cpua, 0x22000000U + 0x100U * 32U).status_code,
+            StatusCode::kMemInaccesible);
+}
@@ -0,0 +1,109 @@
+#include "libmicroemu/internal/bus/mem/mem_map_rw.h"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+using namespace libmicroemu;
+using internal::MemMapRw;
+using internal::ReadStatusCode;
+using internal::WriteStatusCode;
+
+namespace {
+
+struct FakeCpuAccessor {
+  u32 reg_a{0x0U};
+  u32 reg_b{0x0U};
+};
+
+enum class FakeAddressMap : me_adr_t { kRegA = 0x100U, kRegB = 0x10CU, kRegC = 0x200U };
+
+class FakePeripheral {
+public:
+  using MapEnum = FakeAddressMap;
+
+  static constexpr u32 GetBeginPhysicalAddress() { return 0x100U; }
+  static constexpr u32 GetEndPhysicalAddress() { return 0x1FFU; }
+
+  class RegisterAccessA {
+  public:
+    static constexpr auto kAdr = FakeAddressMap::kRegA;
+    static constexpr bool kUseReadModifyWrite = true;
+    static constexpr bool kReadOnly = false;
+
+    static u32 ReadRegister(FakeCpuAccessor &cpua) { return cpua.reg_a; }
+    static void WriteRegister(FakeCpuAccessor &cpua, u32 value) { cpua.reg_a = value; }
+  };
+
+  class RegisterAccessB {
+  public:
+    static constexpr auto kAdr = FakeAddressMap::kRegB;
+    static constexpr bool kUseReadModifyWrite = false;
+    static constexpr bool kReadOnly = true;
+
+    static u32 ReadRegister(FakeCpuAccessor &cpua) { return cpua.reg_b; }
+  };
+
+  static constexpr auto kRegisters = std::tuple<RegisterAccessA, RegisterAccessB>{};
+};
+
+class OtherFakePeripheral {
+public:
+  using MapEnum = FakeAddressMap;
+
+  static constexpr u32 GetBeginPhysicalAddress() { return 0x200U; }
+  static constexpr u32 GetEndPhysicalAddress() { return 0x20FU; }
+
+  class RegisterAccessC {
+  public:
+    static constexpr auto kAdr = FakeAddressMap::kRegC;
+    static constexpr bool kUseReadModifyWrite = false;
+    static constexpr bool kReadOnly = false;
+
+    static u32 ReadRegister(FakeCpuAccessor &cpua) { return cpua.reg_b; }
+    static void WriteRegister(FakeCpuAccessor &cpua, u32 value) { cpua.reg_b = value; }
+  };
+
+  static constexpr auto kRegisters = std::tuple<RegisterAccessC>{};
+};
+
+using FakeMemMap = MemMapRw<0U, 0xE0000000U, 0xFFFFU, FakeCpuAccessor, void, NullLogger,
+                            FakePeripheral, OtherFakePeripheral>;
+} // namespace
+
+/// \test MemMapRwTest
+/// \test_verifies
+/// \test_item Read, Write
+/// \test_scenario access registers of two peripherals through the dispatch tables
+/// \test_expected_behaviour Accesses reach the register at the given address, sub-word accesses
+/// are merged into the register value
+TEST(MemMapRwTest, ReadWrite_MappedRegisters_DispatchedToRegister) {
+  FakeCpuAccessor cpua;
+  FakeMemMap mem;
+
+  ASSERT_EQ(mem.Write<u32>(cpua, 0xE0000100U, 0x11223344U).status_code, WriteStatusCode::kOk);
+  ASSERT_EQ(mem.Write<u8>(cpua, 0xE0000102U, 0xAAU).status_code, WriteStatusCode::kOk);
+  ASSERT_EQ(cpua.reg_a, 0x11AA3344U);
+  ASSERT_EQ(mem.Read<u16>(cpua, 0xE0000102U).content, 0x11AAU);
+
+  ASSERT_EQ(mem.Write<u32>(cpua, 0xE0000200U, 0xCAFEU).status_code, WriteStatusCode::kOk);
+  ASSERT_EQ(mem.Read<u32>(cpua, 0xE000010CU).content, 0xCAFEU);
+}
+
+/// \test MemMapRwTest
+/// \test_verifies
+/// \test_item Read, Write
+/// \test_scenario access read-only registers, unused register slots and unmapped addresses
+/// \test_expected_behaviour The access is refused
+TEST(MemMapRwTest, ReadWrite_UnusedSlots_NotAllowed) {
+  FakeCpuAccessor cpua;
+  FakeMemMap mem;
+
+  ASSERT_EQ(mem.Write<u32>(cpua, 0xE000010CU, 0x1U).status_code,
+            WriteStatusCode::kWriteNotAllowed);
+  ASSERT_EQ(mem.Read<u32>(cpua, 0xE0000104U).status_code, ReadStatusCode::kReadNotAllowed);
+  ASSERT_EQ(mem.Write<u16>(cpua, 0xE0000108U, 0x1U).status_code,
+            WriteStatusCode::kWriteNotAllowed);
+  ASSERT_EQ(mem.Read<u8>(cpua, 0xE0000210U).status_code, ReadStatusCode::kReadNotAllowed);
+  ASSERT_EQ(mem.Read<u32>(cpua, 0xE000ED00U).status_code, ReadStatusCode::kReadNotAllowed);
+}
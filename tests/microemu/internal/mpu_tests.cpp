@@ -0,0 +1,91 @@
+#include "libmicroemu/internal/bus/mpu.h"
+
+#include <gtest/gtest.h>
+
+using namespace libmicroemu;
+using internal::AccessFlags;
+using internal::AccessFlagsSet;
+using internal::AccessPageTable;
+using internal::Mpu;
+
+namespace {
+struct FakeCpuAccessor {
+  template <SpecialRegisterId SId> u32 ReadSpecialRegister() const {
+    return regs[static_cast<u32>(SId)];
+  }
+  u32 ReadSpecialRegister(SpecialRegisterId reg_id) const {
+    return regs[static_cast<u32>(reg_id)];
+  }
+  void SetRegion(u32 region, u32 rbar, u32 rasr) {
+    regs[static_cast<u32>(SpecialRegisterId::kMpuRbar0) + region] = rbar;
+    regs[static_cast<u32>(SpecialRegisterId::kMpuRasr0) + region] = rasr;
+  }
+  std::array<u32, CountPersistentSpecialRegisters()> regs{};
+};
+
+constexpr u32 kRasrFullAccess = 0x3U << MpuRegister::kRasrApPos;
+constexpr u32 kRasrReadOnly = 0x6U << MpuRegister::kRasrApPos;
+
+constexpr u32 MakeRasr(u32 size_exp, u32 ap, u32 srd = 0U) {
+  return ap | (srd << MpuRegister::kRasrSrdPos) | ((size_exp - 1U) << MpuRegister::kRasrSizePos) |
+         MpuRegister::kRasrEnableMsk;
+}
+
+FakeCpuAccessor MakeCpu() {
+  FakeCpuAccessor cpua;
+  cpua.regs[static_cast<u32>(SpecialRegisterId::kMpuType)] = 8U << MpuRegister::kTypeDRegionPos;
+  cpua.regs[static_cast<u32>(SpecialRegisterId::kMpuCtrl)] = MpuRegister::kCtrlEnableMsk;
+  return cpua;
+}
+} // namespace
+
+/// \test MpuTest
+/// \test_verifies
+/// \test_item Load, Compile
+/// \test_scenario compile a full access region with a higher priority read-only region inside
+/// \test_expected_behaviour Covered pages carry the deny flags of the region with the highest
+/// number, uncovered pages deny everything
+TEST(MpuTest, Compile_OverlappingRegions_HighestRegionWins) {
+  auto cpua = MakeCpu();
+  cpua.SetRegion(0U, 0x20000000U, MakeRasr(16U, kRasrFullAccess)); // 64 KiB
+  cpua.SetRegion(1U, 0x20004000U, MakeRasr(12U, kRasrReadOnly));   // 4 KiB
+  Mpu mpu;
+  ASSERT_TRUE(mpu.Load(cpua));
+  ASSERT_FALSE(mpu.Load(cpua));
+  ASSERT_TRUE(mpu.IsEnabled());
+
+  AccessPageTable table;
+  ASSERT_TRUE(mpu.Compile(table));
+
+  const auto kReadOnlyFlags = static_cast<AccessFlagsSet>(
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoPrivWrite) |
+      static_cast<AccessFlagsSet>(AccessFlags::kMpuNoUserWrite));
+  ASSERT_EQ(table.GetFlags(0x20000000U), 0U);
+  ASSERT_EQ(table.GetFlags(0x20004400U), kReadOnlyFlags);
+  ASSERT_EQ(table.GetFlags(0x20005000U), 0U);
+  ASSERT_EQ(table.GetFlags(0x20010000U), Mpu::kDenyMsk);
+  ASSERT_EQ(table.GetFlags(0x80000000U), Mpu::kDenyMsk);
+}
+
+/// \test MpuTest
+/// \test_verifies
+/// \test_item Compile, Lookup
+/// \test_scenario compile a 256 byte region with a disabled subregion inside a single page
+/// \test_expected_behaviour The page is marked for a region walk which resolves the subregions
+TEST(MpuTest, Lookup_DisabledSubregion_FallsBackToBackground) {
+  auto cpua = MakeCpu();
+  cpua.SetRegion(0U, 0x20000100U, MakeRasr(8U, kRasrFullAccess, 0x02U)); // 256 bytes
+  Mpu mpu;
+  ASSERT_TRUE(mpu.Load(cpua));
+
+  AccessPageTable table;
+  ASSERT_TRUE(mpu.Compile(table));
+  ASSERT_NE(table.GetFlags(0x20000100U) & static_cast<AccessFlagsSet>(AccessFlags::kMpuCheck),
+            0U);
+
+  ASSERT_EQ(mpu.Lookup(0x20000100U), 0U);
+  ASSERT_EQ(mpu.Lookup(0x20000120U), Mpu::kDenyMsk); // subregion 1 is disabled
+  ASSERT_EQ(mpu.Lookup(0x20000140U), 0U);
+  ASSERT_EQ(mpu.Lookup(0x20000200U), Mpu::kDenyMsk);
+  ASSERT_EQ(mpu.Lookup(0xE000ED90U), static_cast<AccessFlagsSet>(AccessFlags::kMpuNoExec));
+}
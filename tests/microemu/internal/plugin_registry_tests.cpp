@@ -0,0 +1,101 @@
+#include "libmicroemu/internal/peripherals/plugin_registry.h"
+#include "../test_helpers.h"
+
+#include <gtest/gtest.h>
+
+using namespace libmicroemu;
+using internal::PluginRegistry;
+
+namespace {
+
+class FakePeripheral : public IPeripheral {
+public:
+  StatusCode Read(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                  u32 &value) noexcept override {
+    static_cast<void>(ctx);
+    static_cast<void>(size);
+    value = offset;
+    return StatusCode::kSuccess;
+  }
+
+  StatusCode Write(IPeripheralContext &ctx, me_offset_t offset, me_size_t size,
+                   u32 value) noexcept override {
+    static_cast<void>(offset);
+    static_cast<void>(size);
+    ctx.ScheduleWakeUp(ctx.GetTime() + value);
+    return StatusCode::kSuccess;
+  }
+
+  StatusCode Tick(IPeripheralContext &ctx) noexcept override {
+    static_cast<void>(ctx);
+    ++no_of_ticks;
+    return StatusCode::kSuccess;
+  }
+
+  u32 no_of_ticks{0U};
+};
+
+struct FakeCpuAccessor {};
+
+/// Forwards the time and the wake-ups to the registry
+class FakeContext : public test::FakePeripheralContext {
+public:
+  FakeContext(PluginRegistry &registry, FakeCpuAccessor &cpua, i32 idx) noexcept
+      : registry_(registry), idx_(idx) {
+    static_cast<void>(cpua);
+  }
+
+  u64 GetTime() const noexcept override { return registry_.GetTime(); }
+  void ScheduleWakeUp(u64 time) noexcept override { registry_.ScheduleWakeUp(idx_, time); }
+
+private:
+  PluginRegistry &registry_;
+  i32 idx_;
+};
+} // namespace
+
+/// \test PluginRegistryTest
+/// \test_verifies
+/// \test_item Add, Find
+/// \test_scenario add peripherals in unsorted order and with overlapping ranges
+/// \test_expected_behaviour Overlapping ranges are rejected, addresses are found in their range
+TEST(PluginRegistryTest, Add_OverlappingRanges_Rejected) {
+  FakePeripheral a;
+  FakePeripheral b;
+  PluginRegistry registry;
+
+  ASSERT_TRUE(registry.Add(&a, 0x50001000U, 0x100U));
+  ASSERT_TRUE(registry.Add(&b, 0x50000000U, 0x100U));
+  ASSERT_FALSE(registry.Add(&b, 0x500000FFU, 0x2U));
+  ASSERT_FALSE(registry.Add(&b, 0x50000F00U, 0x101U));
+  ASSERT_FALSE(registry.Add(&b, 0xFFFFFFF0U, 0x20U));
+
+  ASSERT_EQ(registry.GetEntry(registry.Find(0x500000FFU)).peripheral, &b);
+  ASSERT_EQ(registry.GetEntry(registry.Find(0x50001000U)).peripheral, &a);
+  ASSERT_EQ(registry.Find(0x50000100U), PluginRegistry::kNotFound);
+  ASSERT_EQ(registry.Find(0x50001100U), PluginRegistry::kNotFound);
+}
+
+/// \test PluginRegistryTest
+/// \test_verifies
+/// \test_item AdvanceTime, WakeUp
+/// \test_scenario a peripheral schedules a wake-up three instructions ahead
+/// \test_expected_behaviour The tick handler is called exactly once when the time is reached
+TEST(PluginRegistryTest, WakeUp_Scheduled_TickedOnceAtTime) {
+  FakePeripheral a;
+  FakeCpuAccessor cpua;
+  PluginRegistry registry;
+  ASSERT_TRUE(registry.Add(&a, 0x50000000U, 0x100U));
+  registry.Reset<FakeContext>(cpua);
+
+  FakeContext ctx(registry, cpua, 0);
+  ASSERT_EQ(a.Write(ctx, 0U, 4U, 3U), StatusCode::kSuccess);
+
+  ASSERT_FALSE(registry.AdvanceTime());
+  ASSERT_FALSE(registry.AdvanceTime());
+  ASSERT_TRUE(registry.AdvanceTime());
+  ASSERT_EQ(registry.WakeUp<FakeContext>(cpua), StatusCode::kSuccess);
+  ASSERT_EQ(a.no_of_ticks, 1U);
+  ASSERT_FALSE(registry.AdvanceTime());
+  ASSERT_EQ(registry.GetTime(), 4U);
+}
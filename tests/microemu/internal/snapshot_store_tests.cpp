@@ -0,0 +1,102 @@
+#include "libmicroemu/internal/snapshot/snapshot_store.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace libmicroemu;
+using internal::PageFlags;
+using internal::PageFlagTable;
+using internal::SnapshotSegment;
+using internal::SnapshotStore;
+using internal::SparsePageStore;
+
+namespace {
+constexpr me_size_t kRamSize = 4U * PageFlagTable::kPageSize;
+
+void WriteRam(std::vector<u8> &ram, PageFlagTable &flags, me_adr_t padr, u8 value) {
+  ram[padr] = value;
+  PageFlagTable::MarkDirty(flags.GetRaw(), padr, 1U);
+}
+} // namespace
+
+/// \test SnapshotStoreTest
+/// \test_verifies
+/// \test_item Take, Restore
+/// \test_scenario take a full and an incremental snapshot, modify memory and restore both
+/// \test_expected_behaviour Memory and cpu states match the state at the restored snapshot
+TEST(SnapshotStoreTest, Restore_IncrementalChain_MemoryMatchesSnapshot) {
+  std::vector<u8> ram(kRamSize, 0xFFU);
+  PageFlagTable flags;
+  ASSERT_TRUE(flags.Allocate(kRamSize));
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{
+      SnapshotSegment{ram.data(), &flags}, SnapshotSegment{}};
+  CpuStates cpu_states;
+  SnapshotStore store;
+
+  cpu_states.GetRegisters()[0] = 0x11U;
+  const auto res_first = store.Take(cpu_states, segments, nullptr);
+  ASSERT_TRUE(res_first.IsOk());
+
+  WriteRam(ram, flags, 0x10U, 0xAAU);
+  cpu_states.GetRegisters()[0] = 0x22U;
+  const auto res_second = store.Take(cpu_states, segments, nullptr);
+  ASSERT_TRUE(res_second.IsOk());
+  ASSERT_EQ(res_second.content, 1U);
+
+  WriteRam(ram, flags, 0x10U, 0xBBU);
+  WriteRam(ram, flags, 3U * PageFlagTable::kPageSize, 0xCCU);
+  cpu_states.GetRegisters()[0] = 0x33U;
+
+  ASSERT_TRUE(store.Restore(1U, cpu_states, segments, nullptr).IsOk());
+  ASSERT_EQ(ram[0x10U], 0xAAU);
+  ASSERT_EQ(ram[3U * PageFlagTable::kPageSize], 0xFFU);
+  ASSERT_EQ(cpu_states.GetRegisters()[0], 0x22U);
+
+  ASSERT_TRUE(store.Restore(0U, cpu_states, segments, nullptr).IsOk());
+  ASSERT_EQ(ram[0x10U], 0xFFU);
+  ASSERT_EQ(cpu_states.GetRegisters()[0], 0x11U);
+  ASSERT_EQ(store.GetNoOfSnapshots(), 1U);
+}
+
+/// \test SnapshotStoreTest
+/// \test_verifies
+/// \test_item Restore
+/// \test_scenario restore a snapshot after a sparse page was committed
+/// \test_expected_behaviour The page committed after the snapshot is released again
+TEST(SnapshotStoreTest, Restore_SparsePageCommittedLater_PageDecommitted) {
+  SparsePageStore sparse;
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{};
+  CpuStates cpu_states;
+  SnapshotStore store;
+
+  const u8 value = 0x5AU;
+  ASSERT_TRUE(sparse.Store(0x40000000U, &value, 1U));
+  ASSERT_TRUE(store.Take(cpu_states, segments, &sparse).IsOk());
+
+  const u8 other = 0xA5U;
+  ASSERT_TRUE(sparse.Store(0x40000000U, &other, 1U));
+  ASSERT_TRUE(sparse.Store(0x50000000U, &other, 1U));
+  ASSERT_EQ(sparse.GetNoOfCommittedPages(), 2U);
+
+  ASSERT_TRUE(store.Restore(0U, cpu_states, segments, &sparse).IsOk());
+  ASSERT_EQ(sparse.GetNoOfCommittedPages(), 1U);
+  ASSERT_EQ(sparse.GetPage(0x40000000U)[0], 0x5AU);
+  ASSERT_EQ(sparse.GetPage(0x50000000U), nullptr);
+}
+
+/// \test SnapshotStoreTest
+/// \test_verifies
+/// \test_item Restore
+/// \test_scenario restore a snapshot which does not exist
+/// \test_expected_behaviour kOutOfRange is returned
+TEST(SnapshotStoreTest, Restore_UnknownId_OutOfRange) {
+  const auto segments = std::array<SnapshotSegment, SnapshotStore::kNoOfSegments>{};
+  CpuStates cpu_states;
+  SnapshotStore store;
+
+  const auto res = store.Restore(0U, cpu_states, segments, nullptr);
+  ASSERT_EQ(res.status_code, StatusCode::kOutOfRange);
+}
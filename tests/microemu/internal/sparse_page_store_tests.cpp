@@ -0,0 +1,85 @@
+#include "libmicroemu/internal/bus/mem/sparse_page_store.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace libmicroemu;
+using internal::SparsePageStore;
+
+/// \test SparsePageStoreTest
+/// \test_verifies
+/// \test_item GetPage
+/// \test_scenario query a page of a freshly created store
+/// \test_expected_behaviour No page is committed
+TEST(SparsePageStoreTest, GetPage_Untouched_NotCommitted) {
+  SparsePageStore store;
+  ASSERT_EQ(store.GetPage(0x20000000U), nullptr);
+  ASSERT_EQ(store.GetNoOfCommittedPages(), 0U);
+  ASSERT_EQ(store.GetCommittedBytes(), 0U);
+}
+
+/// \test SparsePageStoreTest
+/// \test_verifies
+/// \test_item CommitPage
+/// \test_scenario commit a page at the upper end of the address space
+/// \test_expected_behaviour Page is initialized with the fill value and counted once
+TEST(SparsePageStoreTest, CommitPage_UpperEnd_FilledAndCounted) {
+  SparsePageStore store;
+  u8 *page = store.CommitPage(0xFFFFFFFCU);
+  ASSERT_NE(page, nullptr);
+  ASSERT_EQ(page[SparsePageStore::kPageSize - 1U], SparsePageStore::kDefaultFillValue);
+  ASSERT_EQ(store.CommitPage(0xFFFFF000U), page);
+  ASSERT_EQ(store.GetPage(0xFFFFF123U), page);
+  ASSERT_EQ(store.GetNoOfCommittedPages(), 1U);
+}
+
+/// \test SparsePageStoreTest
+/// \test_verifies
+/// \test_item Store
+/// \test_scenario store a buffer crossing a page boundary
+/// \test_expected_behaviour Both pages are committed and contain the data
+TEST(SparsePageStoreTest, Store_CrossingPageBoundary_TwoPagesCommitted) {
+  SparsePageStore store;
+  const u8 data[4] = {0x11U, 0x22U, 0x33U, 0x44U};
+  const me_adr_t vadr = 0x10000000U + SparsePageStore::kPageSize - 2U;
+
+  ASSERT_TRUE(store.Store(vadr, data, sizeof(data)));
+  ASSERT_EQ(store.GetNoOfCommittedPages(), 2U);
+
+  const u8 *first = store.GetPage(vadr);
+  const u8 *second = store.GetPage(vadr + 2U);
+  ASSERT_EQ(first[SparsePageStore::kPageSize - 2U], 0x11U);
+  ASSERT_EQ(first[SparsePageStore::kPageSize - 1U], 0x22U);
+  ASSERT_EQ(second[0U], 0x33U);
+  ASSERT_EQ(second[1U], 0x44U);
+}
+
+/// \test SparsePageStoreTest
+/// \test_verifies
+/// \test_item Release
+/// \test_scenario release a store with committed pages
+/// \test_expected_behaviour All pages are decommitted
+TEST(SparsePageStoreTest, Release_CommittedPages_FootprintZero) {
+  SparsePageStore store;
+  store.CommitPage(0x0U);
+  store.CommitPage(0x80000000U);
+  store.Release();
+  ASSERT_EQ(store.GetPage(0x0U), nullptr);
+  ASSERT_EQ(store.GetPage(0x80000000U), nullptr);
+  ASSERT_EQ(store.GetCommittedBytes(), 0U);
+}
+
+/// \test SparsePageStoreTest
+/// \test_verifies
+/// \test_item AddFaultRegion
+/// \test_scenario add a fault region ending at the top of the address space
+/// \test_expected_behaviour Only addresses within the region fault
+TEST(SparsePageStoreTest, AddFaultRegion_TopOfAddressSpace_BoundsInclusive) {
+  SparsePageStore store;
+  ASSERT_TRUE(store.AddFaultRegion(0xF0000000U, 0x10000000U));
+  ASSERT_FALSE(store.IsFaultAdr(0xEFFFFFFFU));
+  ASSERT_TRUE(store.IsFaultAdr(0xF0000000U));
+  ASSERT_TRUE(store.IsFaultAdr(0xFFFFFFFFU));
+  ASSERT_FALSE(store.AddFaultRegion(0x0U, 0x0U));
+}
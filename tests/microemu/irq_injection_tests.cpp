@@ -0,0 +1,65 @@
+#include "libmicroemu/machine.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace libmicroemu;
+using test::MakeFlashImage;
+using test::WriteCode;
+using test::WriteVector;
+
+namespace {
+u32 ReadR5(Machine &machine) {
+  u32 value{0U};
+  machine.EvaluateState([&value](IRegAccessor &reg_access, ISpecialRegAccessor &) {
+    value = reg_access.ReadRegister(RegisterId::kR5);
+  });
+  return value;
+}
+} // namespace
+
+/// \test IrqInjectionTest
+/// \test_verifies
+/// \test_item InjectIrq, InjectIrqAt
+/// \test_scenario a program spins in a loop, its handler of IRQ 0 counts in r5. Interrupts are
+/// injected with a virtual time, without a time and from another host thread
+/// \test_expected_behaviour Timed interrupts are taken at their virtual time, untimed interrupts
+/// at the next instruction and interrupts of other threads while the machine runs
+TEST(IrqInjectionTest, Exec_InjectedIrqs_HandlerCalled) {
+  auto flash = MakeFlashImage(0x20001000U, 0x80U, {0xE7FEU}); // b .
+  WriteVector(flash.data(), 0x40U, 0x90U);                    // IRQ 0
+  WriteCode(flash.data(), 0x90U, {0x3501U, 0x4770U});         // adds r5, #1; bx lr
+  std::vector<u8> ram(0x1000U);
+
+  Machine machine;
+  machine.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  machine.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  ASSERT_EQ(machine.InjectIrq(0U), StatusCode::kUnsuporrted);
+  ASSERT_EQ(machine.EnableIrqInjection(), StatusCode::kSuccess);
+  ASSERT_EQ(machine.InjectIrq(kNoOfExternalIrqs), StatusCode::kOutOfRange);
+  ASSERT_EQ(machine.Reset(), StatusCode::kSuccess);
+
+  ASSERT_EQ(machine.InjectIrqAt(0U, 10U), StatusCode::kSuccess);
+  ASSERT_EQ(machine.InjectIrqAt(0U, 30U), StatusCode::kSuccess);
+  ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadR5(machine), 0U);
+  ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadR5(machine), 1U);
+
+  ASSERT_EQ(machine.InjectIrq(0U), StatusCode::kSuccess);
+  ASSERT_TRUE(machine.Exec(5).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadR5(machine), 2U);
+  ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadR5(machine), 3U);
+
+  // The machine keeps running while the other thread injects
+  std::thread host([&machine]() { ASSERT_EQ(machine.InjectIrq(0U), StatusCode::kSuccess); });
+  for (u32 i = 0U; (i < 100000U) && (ReadR5(machine) < 4U); ++i) {
+    ASSERT_TRUE(machine.Exec(100).IsMaxInstructionsReached());
+  }
+  host.join();
+  ASSERT_EQ(ReadR5(machine), 4U);
+}
@@ -0,0 +1,54 @@
+#include "libmicroemu/logger.h"
+#include "libmicroemu/types.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+using namespace libmicroemu;
+
+namespace {
+// One callback for all sinks, the user data is the call counter of the sink
+void CountCalls(LogLevel level, void *user_data, const char *format, ...) noexcept {
+  static_cast<void>(level);
+  static_cast<void>(format);
+  ++*static_cast<u32 *>(user_data);
+}
+} // namespace
+
+/// \test StaticLoggerTest
+/// \test_verifies
+/// \test_item StaticLoggerScope
+/// \test_scenario two threads install the same callback with different user data and log
+/// concurrently, one of them nests a second scope
+/// \test_expected_behaviour Every thread only reaches its own sink, the previous callback and
+/// user data are restored when a scope ends
+TEST(StaticLoggerTest, Scope_TwoThreads_SeparateCallbacks) {
+  std::array<u32, 3U> counts{};
+  std::thread thread_a([&counts]() {
+    const StaticLoggerScope scope(&CountCalls, &counts[0U]);
+    for (u32 i = 0U; i < 1000U; ++i) {
+      StaticLogger::Info("a %u", i);
+    }
+    {
+      const StaticLoggerScope nested(&CountCalls, &counts[1U]);
+      StaticLogger::Error("nested");
+    }
+    StaticLogger::Warn("a");
+  });
+  std::thread thread_b([&counts]() {
+    const StaticLoggerScope scope(&CountCalls, &counts[2U]);
+    for (u32 i = 0U; i < 500U; ++i) {
+      StaticLogger::Debug("b %u", i);
+    }
+  });
+  thread_a.join();
+  thread_b.join();
+
+  ASSERT_EQ(counts[0U], 1001U);
+  ASSERT_EQ(counts[1U], 1U);
+  ASSERT_EQ(counts[2U], 500U);
+  ASSERT_EQ(StaticLogger::GetLoggerCallback(), nullptr);
+  ASSERT_EQ(StaticLogger::GetLoggerUserData(), nullptr);
+}
@@ -0,0 +1,184 @@
+#include "libmicroemu/machine.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace libmicroemu;
+using test::MakeFlashImage;
+
+namespace {
+constexpr me_adr_t kRamVadr = 0x20000000U;
+
+class MachineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    flash_ = MakeFlashImage(0x20001000U, 0x80U,
+                            {
+                                0x2000U, // 0x80: movs r0, #0
+                                0x3001U, // 0x82: adds r0, #1
+                                0xE7FDU, // 0x84: b 0x82
+                            });
+    machine_.SetFlashSegment(flash_.data(), flash_.size(), 0x0U);
+    machine_.SetRam1Segment(ram_.data(), ram_.size(), kRamVadr);
+    ASSERT_EQ(machine_.Reset(), StatusCode::kSuccess);
+  }
+
+  u32 ReadRegister(RegisterId reg_id) {
+    u32 value{0U};
+    machine_.EvaluateState([&value, reg_id](IRegAccessor &reg_access, ISpecialRegAccessor &) {
+      value = reg_access.ReadRegister(reg_id);
+    });
+    return value;
+  }
+
+  std::vector<u8> flash_;
+  std::vector<u8> ram_ = std::vector<u8>(0x1000U);
+  Machine machine_;
+};
+} // namespace
+
+/// \test MachineTest
+/// \test_verifies
+/// \test_item ExecUntil
+/// \test_scenario the stop address is passed with and without the thumb bit
+/// \test_expected_behaviour The execution stops before the instruction at the address. No
+/// instruction is executed if the program counter already equals the address
+TEST_F(MachineTest, ExecUntil_ThumbBitSet_StopsAtAddress) {
+  const auto first = machine_.ExecUntil(0x83U, 100);
+  ASSERT_TRUE(first.IsStopAddressReached());
+  ASSERT_EQ(first.GetNoOfInstructions(), 1U);
+
+  const auto second = machine_.ExecUntil(0x82U, 100);
+  ASSERT_TRUE(second.IsStopAddressReached());
+  ASSERT_EQ(second.GetNoOfInstructions(), 0U);
+
+  ASSERT_TRUE(machine_.Exec(1).IsMaxInstructionsReached());
+  const auto third = machine_.ExecUntil(0x83U, 100);
+  ASSERT_TRUE(third.IsStopAddressReached());
+  ASSERT_EQ(third.GetNoOfInstructions(), 1U);
+  ASSERT_EQ(ReadRegister(RegisterId::kR0), 1U);
+
+  ASSERT_TRUE(machine_.ExecUntil(0x90U, 10).IsMaxInstructionsReached());
+}
+
+/// \test MachineTest
+/// \test_verifies
+/// \test_item CaptureGoldenStateAt, ResetToGoldenState
+/// \test_scenario a golden state is captured at a function address with the thumb bit set. The
+/// program then runs on and the host changes the RAM
+/// \test_expected_behaviour ResetToGoldenState restores the registers and the RAM of the golden
+/// state, repeatedly
+TEST_F(MachineTest, ResetToGoldenState_AfterRunAndWrite_StateRestored) {
+  ASSERT_FALSE(machine_.HasGoldenState());
+  ASSERT_EQ(machine_.ResetToGoldenState(), StatusCode::kUnsuporrted);
+  ASSERT_EQ(machine_.CaptureGoldenStateAt(0x91U, 10), StatusCode::kMaxInstructionsReached);
+
+  ASSERT_EQ(machine_.Reset(), StatusCode::kSuccess);
+  ASSERT_EQ(machine_.CaptureGoldenStateAt(0x85U, 10), StatusCode::kSuccess);
+  ASSERT_TRUE(machine_.HasGoldenState());
+  ASSERT_EQ(ReadRegister(RegisterId::kR0), 1U);
+  const u8 golden_byte = ram_[0x10U];
+
+  for (u32 run = 0U; run < 2U; ++run) {
+    ASSERT_TRUE(machine_.Exec(11).IsMaxInstructionsReached());
+    const u8 value = static_cast<u8>(golden_byte ^ 0xFFU);
+    ASSERT_EQ(machine_.WriteMemory(kRamVadr + 0x10U, &value, 1U), StatusCode::kSuccess);
+    ASSERT_NE(ReadRegister(RegisterId::kR0), 1U);
+
+    ASSERT_EQ(machine_.ResetToGoldenState(), StatusCode::kSuccess);
+    ASSERT_EQ(ReadRegister(RegisterId::kR0), 1U);
+    ASSERT_EQ(ReadRegister(RegisterId::kPc), 0x84U + 4U);
+    ASSERT_EQ(ram_[0x10U], golden_byte);
+  }
+}
+
+/// \test MachineTest
+/// \test_verifies
+/// \test_item CaptureGoldenState
+/// \test_scenario the golden state is captured right after the reset
+/// \test_expected_behaviour The machine restarts from the reset state
+TEST_F(MachineTest, CaptureGoldenState_AfterReset_RestartsProgram) {
+  ASSERT_EQ(machine_.CaptureGoldenState(), StatusCode::kSuccess);
+  ASSERT_TRUE(machine_.Exec(7).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadRegister(RegisterId::kR0), 3U);
+
+  ASSERT_EQ(machine_.ResetToGoldenState(), StatusCode::kSuccess);
+  ASSERT_EQ(ReadRegister(RegisterId::kPc), 0x80U + 4U);
+  ASSERT_TRUE(machine_.Exec(3).IsMaxInstructionsReached());
+  ASSERT_EQ(ReadRegister(RegisterId::kR0), 1U);
+}
+
+/// \test MachineTest
+/// \test_verifies
+/// \test_item ReplaceNewestSnapshot
+/// \test_scenario the newest of two snapshots is replaced after the program ran on. A page is
+/// only written between the two snapshots, another one only after the replaced snapshot
+/// \test_expected_behaviour The id is kept, the replaced snapshot restores the new state and the
+/// older snapshot still restores both pages. The golden state cannot be replaced
+TEST_F(MachineTest, ReplaceNewestSnapshot_AfterRun_OlderSnapshotRestored) {
+  u32 snapshot_id{0U};
+  ASSERT_EQ(machine_.ReplaceNewestSnapshot(snapshot_id), StatusCode::kOutOfRange);
+
+  u32 first_id{0U};
+  ASSERT_EQ(machine_.TakeSnapshot(first_id), StatusCode::kSuccess);
+  u8 value = 0x11U;
+  ASSERT_EQ(machine_.WriteMemory(kRamVadr + 0x10U, &value, 1U), StatusCode::kSuccess);
+  u32 second_id{0U};
+  ASSERT_EQ(machine_.TakeSnapshot(second_id), StatusCode::kSuccess);
+
+  ASSERT_TRUE(machine_.Exec(3).IsMaxInstructionsReached());
+  value = 0x22U;
+  ASSERT_EQ(machine_.WriteMemory(kRamVadr + 0xF00U, &value, 1U), StatusCode::kSuccess);
+  ASSERT_EQ(machine_.ReplaceNewestSnapshot(snapshot_id), StatusCode::kSuccess);
+  ASSERT_EQ(snapshot_id, second_id);
+
+  ASSERT_TRUE(machine_.Exec(4).IsMaxInstructionsReached());
+  value = 0x33U;
+  ASSERT_EQ(machine_.WriteMemory(kRamVadr + 0xF00U, &value, 1U), StatusCode::kSuccess);
+  ASSERT_EQ(machine_.RestoreSnapshot(second_id), StatusCode::kSuccess);
+  ASSERT_EQ(ReadRegister(RegisterId::kR0), 1U);
+  ASSERT_EQ(ram_[0x10U], 0x11U);
+  ASSERT_EQ(ram_[0xF00U], 0x22U);
+
+  ASSERT_EQ(machine_.RestoreSnapshot(first_id), StatusCode::kSuccess);
+  ASSERT_EQ(ReadRegister(RegisterId::kPc), 0x80U + 4U);
+  ASSERT_EQ(ram_[0x10U], 0x00U);
+  ASSERT_EQ(ram_[0xF00U], 0x00U);
+
+  ASSERT_EQ(machine_.CaptureGoldenState(), StatusCode::kSuccess);
+  ASSERT_EQ(machine_.ReplaceNewestSnapshot(snapshot_id), StatusCode::kUnsuporrted);
+}
+
+namespace {
+void CountErrors(LogLevel level, void *user_data, const char *format, ...) noexcept {
+  static_cast<void>(format);
+  if (level == LogLevel::kError) {
+    ++*static_cast<u32 *>(user_data);
+  }
+}
+} // namespace
+
+/// \test MachineTest
+/// \test_verifies
+/// \test_item Exec, SetLoggerCallback
+/// \test_scenario the program contains an instruction which cannot be decoded
+/// \test_expected_behaviour The execution stops with the decoder error. The panic report and
+/// the memory dump are passed to the logger of the machine, nothing is written to stdout
+TEST_F(MachineTest, Exec_DecodeError_ReportedToLoggerOnly) {
+  test::WriteCode(flash_.data(), 0x80U, {0xDE00U}); // udf #0
+  u32 error_logs{0U};
+  machine_.SetLoggerCallback(&CountErrors, &error_logs);
+
+  testing::internal::CaptureStdout();
+  const auto res = machine_.Exec(10);
+  const std::string out = testing::internal::GetCapturedStdout();
+
+  ASSERT_EQ(res.GetStatusCode(), StatusCode::kDecoderUnknownOpCode);
+  ASSERT_TRUE(out.empty());
+  if (IS_LOGLEVEL_ERROR_ENABLED) {
+    ASSERT_GT(error_logs, 0U);
+  }
+}
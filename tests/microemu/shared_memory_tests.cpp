@@ -0,0 +1,136 @@
+#include "libmicroemu/machine.h"
+#include "libmicroemu/shared_memory.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace libmicroemu;
+using test::FakePeripheralContext;
+using test::MakeFlashImage;
+
+namespace {
+std::string MakeName() { return "/microemu_test_" + std::to_string(getpid()); }
+} // namespace
+
+/// \test SharedMemoryTest
+/// \test_verifies
+/// \test_item Create, Open
+/// \test_scenario create a shared memory object and map it a second time
+/// \test_expected_behaviour Both mappings see the same RAM bytes and doorbell channel
+TEST(SharedMemoryTest, Open_CreatedObject_SameContent) {
+  SharedMemory owner;
+  ASSERT_EQ(owner.Create(MakeName(), 0x1000U), StatusCode::kSuccess);
+  SharedMemory other;
+  ASSERT_EQ(other.Open(MakeName()), StatusCode::kSuccess);
+  ASSERT_EQ(other.GetSize(), 0x1000U);
+
+  owner.GetData()[0x123U] = 0x5AU;
+  ASSERT_EQ(other.GetData()[0x123U], 0x5AU);
+  owner.GetChannel()->RingGuest(0x4U);
+  ASSERT_EQ(other.GetChannel()->to_guest.load(), 0x4U);
+
+  owner.Close();
+  SharedMemory removed;
+  ASSERT_EQ(removed.Open(MakeName()), StatusCode::kOpenFileFailed);
+}
+
+/// \test SharedMemoryTest
+/// \test_verifies
+/// \test_item Doorbell
+/// \test_scenario the host rings the guest, the guest acknowledges and rings the host
+/// \test_expected_behaviour The interrupt is set pending at the next poll and the bits are
+/// exchanged through the channel
+TEST(SharedMemoryTest, Doorbell_RingBothDirections_BitsExchanged) {
+  DoorbellChannel channel;
+  u32 host_bits{0U};
+  Doorbell doorbell(channel, 3U, 100U, [&host_bits](u32 bits) { host_bits |= bits; });
+  FakePeripheralContext ctx;
+  doorbell.Reset(ctx);
+  ASSERT_EQ(ctx.wake_up, 100U);
+
+  ctx.time = 100U;
+  ASSERT_EQ(doorbell.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(ctx.pending_irq, -1);
+
+  channel.RingGuest(0x3U);
+  ctx.time = 200U;
+  ASSERT_EQ(doorbell.Tick(ctx), StatusCode::kSuccess);
+  ASSERT_EQ(ctx.pending_irq, 3);
+  ASSERT_EQ(ctx.wake_up, 300U);
+
+  u32 value{0U};
+  ASSERT_EQ(doorbell.Read(ctx, Doorbell::kToGuestOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, 0x3U);
+  ASSERT_EQ(doorbell.Write(ctx, Doorbell::kToGuestOffset, 4U, 0x1U), StatusCode::kSuccess);
+  ASSERT_EQ(channel.to_guest.load(), 0x2U);
+
+  ASSERT_EQ(doorbell.Write(ctx, Doorbell::kToHostOffset, 4U, 0x8U), StatusCode::kSuccess);
+  ASSERT_EQ(host_bits, 0x8U);
+  ASSERT_EQ(channel.TakeHostRings(), 0x8U);
+  ASSERT_EQ(channel.to_host.load(), 0x0U);
+
+  ASSERT_EQ(doorbell.Write(ctx, Doorbell::kToHostOffset, 1U, 0x8U), StatusCode::kMemInaccesible);
+}
+
+/// \test SharedMemoryTest
+/// \test_verifies
+/// \test_item Machine::SetRam2Segment, Doorbell
+/// \test_scenario the host writes a word to a shared memory object which is assigned to a machine
+/// as external RAM2 segment, then an ELF file is loaded with and without lazy RAM filling. The
+/// guest loads the word through the bus and writes it to the TO_HOST register of the doorbell
+/// \test_expected_behaviour The load keeps the data of the host. The doorbell passes the word to
+/// the callback and to the channel
+TEST(SharedMemoryTest, Machine_ExternalRam2_GuestReadsHostDataAndRings) {
+  constexpr me_adr_t kShmVadr = 0x60000000U;
+  constexpr me_adr_t kDoorbellVadr = 0x40000000U;
+  constexpr u32 kHostData = 0x12345678U;
+  for (const bool is_lazy : {false, true}) {
+    SharedMemory shm;
+    ASSERT_EQ(shm.Create(MakeName(), 0x1000U), StatusCode::kSuccess);
+    std::memcpy(shm.GetData() + 0x10U, &kHostData, sizeof(kHostData));
+
+    std::vector<u8> flash(0x20000U);
+    std::vector<u8> ram(0x40000U);
+    u32 host_bits{0U};
+    Doorbell doorbell(*shm.GetChannel(), 3U, 100U, [&host_bits](u32 bits) { host_bits |= bits; });
+    Machine machine;
+    machine.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+    machine.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+    machine.SetRam2Segment(shm.GetData(), shm.GetSize(), kShmVadr, true);
+    machine.SetLazyRamFill(is_lazy);
+    ASSERT_EQ(machine.AttachPeripheral(&doorbell, kDoorbellVadr, Doorbell::kSize),
+              StatusCode::kSuccess);
+    ASSERT_EQ(machine.Load(SYSTEST_INPUT_DIR "printf_rdimon/prebuilt/bin/printf_rdimon.elf", true),
+              StatusCode::kSuccess);
+
+    // Replace the program of the ELF file
+    const auto image = MakeFlashImage(0x20001000U, 0x80U,
+                                      {
+                                          0x4802U, // 0x80: ldr r0, [pc, #8]
+                                          0x6801U, // 0x82: ldr r1, [r0]
+                                          0x4A02U, // 0x84: ldr r2, [pc, #8]
+                                          0x6011U, // 0x86: str r1, [r2]
+                                          0xE7FEU, // 0x88: b 0x88
+                                          0x0000U, // 0x8A: padding
+                                          0x0010U, // 0x8C: kShmVadr + 0x10
+                                          0x6000U, //
+                                          0x0000U, // 0x90: kDoorbellVadr
+                                          0x4000U, //
+                                      });
+    std::copy(image.begin(), image.end(), flash.begin());
+    ASSERT_EQ(machine.Reset(), StatusCode::kSuccess);
+
+    ASSERT_TRUE(machine.Exec(10).IsMaxInstructionsReached());
+    u32 data{0U};
+    std::memcpy(&data, shm.GetData() + 0x10U, sizeof(data));
+    ASSERT_EQ(data, kHostData);
+    ASSERT_EQ(host_bits, kHostData);
+    ASSERT_EQ(shm.GetChannel()->TakeHostRings(), kHostData);
+  }
+}
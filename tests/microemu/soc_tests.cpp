@@ -0,0 +1,160 @@
+#include "libmicroemu/soc.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace libmicroemu;
+using test::FakePeripheralContext;
+using test::MakeFlashImage;
+using test::WriteCode;
+using test::WriteVectorTable;
+
+/// \test SocTest
+/// \test_verifies
+/// \test_item Exec
+/// \test_scenario two cores which share the flash spin in an endless loop
+/// \test_expected_behaviour Both cores run on their own thread until they reach the limit
+TEST(SocTest, Exec_TwoSpinningCores_LimitReachedOnBoth) {
+  auto flash = MakeFlashImage(0x20001000U, 0x8U, {0xE7FEU}); // b .
+  std::vector<u8> ram(0x1000U);
+
+  Soc soc(2U);
+  soc.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  soc.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  soc.SetSlice(300);
+  ASSERT_EQ(soc.Reset(), StatusCode::kSuccess);
+
+  const auto res = soc.Exec(1000);
+  ASSERT_TRUE(res.IsMaxInstructionsReached());
+  ASSERT_EQ(res.GetNoOfInstructions(), 2000U);
+}
+
+/// \test SocTest
+/// \test_verifies
+/// \test_item InterCoreMailbox
+/// \test_scenario core 0 raises a flag of core 1, core 1 polls and clears it
+/// \test_expected_behaviour The interrupt of core 1 is set pending at its next poll and the flag
+/// is cleared by writing 1
+TEST(SocTest, Mailbox_RaiseOtherCore_PendingAtPoll) {
+  InterCoreMailbox mailbox(5U, 100U);
+  FakePeripheralContext ctx0;
+  FakePeripheralContext ctx1;
+  auto &ep0 = mailbox.GetEndpoint(0U);
+  auto &ep1 = mailbox.GetEndpoint(1U);
+  ep0.Reset(ctx0);
+  ep1.Reset(ctx1);
+
+  u32 value{0U};
+  ASSERT_EQ(ep1.Read(ctx1, InterCoreMailbox::kCoreIdOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, 1U);
+
+  ASSERT_EQ(ep0.Write(ctx0, InterCoreMailbox::kRaiseOffset + 4U, 4U, 0x6U),
+            StatusCode::kSuccess);
+  ASSERT_EQ(ctx0.pending_irq, -1);
+  ASSERT_EQ(mailbox.GetFlags(1U), 0x6U);
+
+  ctx1.time = 100U;
+  ASSERT_EQ(ep1.Tick(ctx1), StatusCode::kSuccess);
+  ASSERT_EQ(ctx1.pending_irq, 5);
+  ASSERT_EQ(ctx1.wake_up, 200U);
+
+  ASSERT_EQ(ep1.Write(ctx1, InterCoreMailbox::kFlagsOffset, 4U, 0x2U), StatusCode::kSuccess);
+  ASSERT_EQ(ep1.Read(ctx1, InterCoreMailbox::kFlagsOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, 0x4U);
+  ASSERT_EQ(ep0.Read(ctx0, InterCoreMailbox::kFlagsOffset, 4U, value), StatusCode::kSuccess);
+  ASSERT_EQ(value, 0x0U);
+}
+
+/// \test SocTest
+/// \test_verifies
+/// \test_item Exec
+/// \test_scenario two cores store different values to the same RAM word in the same quantum
+/// \test_expected_behaviour The stores are merged in core order, so the value of core 1 remains.
+/// Once a core holds a golden state, a run with a quantum is rejected and the golden state is kept
+TEST(SocTest, Exec_QuantumSameWordStored_MergedInCoreOrder) {
+  // movs r1, #1; lsls r1, r1, #29; movs r0, #<core + 1>; str r0, [r1]; b .
+  auto flash = MakeFlashImage(0x20001000U, 0x08U, {0x2101U, 0x0749U, 0x2001U, 0x6008U, 0xE7FEU});
+  WriteVectorTable(&flash[0x80U], 0x20001000U, 0x88U);
+  WriteCode(flash.data(), 0x88U, {0x2101U, 0x0749U, 0x2002U, 0x6008U, 0xE7FEU});
+  std::vector<u8> ram(0x1000U);
+
+  Soc soc(2U);
+  soc.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  soc.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  ASSERT_EQ(soc.SetVectorTable(1U, 0x80U), StatusCode::kSuccess);
+  soc.SetQuantum(5);
+  ASSERT_EQ(soc.Reset(), StatusCode::kSuccess);
+
+  const auto res = soc.Exec(10);
+  ASSERT_TRUE(res.IsMaxInstructionsReached());
+  ASSERT_EQ(res.GetNoOfInstructions(), 20U);
+  ASSERT_EQ(ram[0U], 2U);
+
+  // The private RAM copies of a quantum would discard the golden state
+  ASSERT_EQ(soc.GetCore(1U)->CaptureGoldenState(), StatusCode::kSuccess);
+  ASSERT_EQ(soc.Exec(10).GetStatusCode(), StatusCode::kUnsuporrted);
+  ASSERT_TRUE(soc.GetCore(1U)->HasGoldenState());
+}
+
+/// \test SocTest
+/// \test_verifies
+/// \test_item Exec, SetQuantum
+/// \test_scenario two cores increment a RAM counter 50 times each. Every increment is a plain
+/// load and store inside a LDREX/STREX spinlock, the cores run with a quantum
+/// \test_expected_behaviour The lock is granted to one core at a time, so no increment is lost.
+/// A second run from reset produces the same result
+TEST(SocTest, Exec_QuantumSpinlock_NoIncrementLost) {
+  // r0 = lock at 0x20000000, r5 = counter at 0x20000004, r6 = iterations
+  // loop: ldrex r1, [r0]; cmp r1, #0; bne loop; strex r2, r3, [r0]; cmp r2, #0; bne loop
+  //       ldr r4, [r5]; adds r4, #1; str r4, [r5]; str r7, [r0]; subs r6, #1; bne loop; b .
+  auto flash = MakeFlashImage(
+      0x20001000U, 0x08U,
+      {0x2001U, 0x0740U, 0x1D05U, 0x2632U, 0x2301U, 0x2700U, 0xE850U, 0x1F00U, 0x2900U, 0xD1FBU,
+       0xE840U, 0x3200U, 0x2A00U, 0xD1F7U, 0x682CU, 0x3401U, 0x602CU, 0x6007U, 0x3E01U, 0xD1F1U,
+       0xE7FEU});
+  std::vector<u8> ram(0x1000U);
+
+  Soc soc(2U);
+  soc.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  soc.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  soc.SetQuantum(7);
+
+  for (u32 run = 0U; run < 2U; ++run) {
+    std::fill(ram.begin(), ram.end(), u8{0x0U});
+    ASSERT_EQ(soc.Reset(), StatusCode::kSuccess);
+    const auto res = soc.Exec(20000);
+    ASSERT_TRUE(res.IsMaxInstructionsReached());
+    ASSERT_EQ(ram[0x0U], 0U);
+    ASSERT_EQ(ram[0x4U], 100U);
+  }
+}
+
+/// \test SocTest
+/// \test_verifies
+/// \test_item Load, GetCore
+/// \test_scenario core 0 fills the shared RAM lazily and loads an ELF file, core 1 then writes a
+/// page which core 0 did not touch yet
+/// \test_expected_behaviour The RAM is filled completely by the load, so core 0 reads the value
+/// written by core 1. Cores beyond the number of cores do not exist
+TEST(SocTest, Load_LazyRamFill_SharedRamFilledAtLoad) {
+  std::vector<u8> flash(0x20000U);
+  std::vector<u8> ram(0x40000U);
+  Soc soc(2U);
+  soc.SetFlashSegment(flash.data(), flash.size(), 0x0U);
+  soc.SetRam1Segment(ram.data(), ram.size(), 0x20000000U);
+  ASSERT_EQ(soc.GetCore(2U), nullptr);
+  soc.GetCore(0U)->SetLazyRamFill(true);
+  ASSERT_EQ(soc.Load(SYSTEST_INPUT_DIR "printf_rdimon/prebuilt/bin/printf_rdimon.elf"),
+            StatusCode::kSuccess);
+  ASSERT_EQ(ram[0x30000U], 0xFFU);
+
+  const u8 value{0x5AU};
+  ASSERT_EQ(soc.GetCore(1U)->WriteMemory(0x20030010U, &value, 1U), StatusCode::kSuccess);
+  u8 read{0x0U};
+  ASSERT_EQ(soc.GetCore(0U)->ReadMemory(0x20030010U, &read, 1U), StatusCode::kSuccess);
+  ASSERT_EQ(read, value);
+  ASSERT_EQ(ram[0x30011U], 0xFFU);
+}
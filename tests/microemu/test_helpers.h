@@ -0,0 +1,78 @@
+#pragma once
+
+#include "libmicroemu/peripheral.h"
+#include "libmicroemu/types.h"
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+namespace libmicroemu::test {
+
+/**
+ * @brief Peripheral context which records the calls of a peripheral under test.
+ * The time is set by the test. Tests which need memory accesses derive from it.
+ */
+class FakePeripheralContext : public IPeripheralContext {
+public:
+  u64 GetTime() const noexcept override { return time; }
+  void ScheduleWakeUp(u64 t) noexcept override { wake_up = t; }
+  StatusCode SetIrqPending(u32 irq) noexcept override {
+    pending_irq = static_cast<i32>(irq);
+    return StatusCode::kSuccess;
+  }
+
+  u64 time{0U};
+  u64 wake_up{kNoWakeUp};
+  i32 pending_irq{-1};
+};
+
+/**
+ * @brief Writes thumb code to a flash image.
+ * @param flash the flash image
+ * @param code_adr offset of the code within the flash image
+ * @param code the halfwords of the code
+ */
+inline void WriteCode(u8 *flash, me_adr_t code_adr, std::initializer_list<u16> code) {
+  std::memcpy(&flash[code_adr], code.begin(), code.size() * sizeof(u16));
+}
+
+/**
+ * @brief Writes an exception vector which points to thumb code.
+ * @param flash the flash image
+ * @param vector_adr offset of the vector within the flash image
+ * @param code_adr address of the code, the thumb bit is added
+ */
+inline void WriteVector(u8 *flash, me_adr_t vector_adr, me_adr_t code_adr) {
+  const u32 vector = code_adr | 0x1U;
+  std::memcpy(&flash[vector_adr], &vector, sizeof(vector));
+}
+
+/**
+ * @brief Writes the stack pointer and the reset vector of a vector table.
+ * @param table the start of the vector table
+ * @param sp the initial stack pointer
+ * @param reset_adr address of the reset handler, the thumb bit is added
+ */
+inline void WriteVectorTable(u8 *table, u32 sp, me_adr_t reset_adr) {
+  std::memcpy(&table[0x0U], &sp, sizeof(sp));
+  WriteVector(table, 0x4U, reset_adr);
+}
+
+/**
+ * @brief Creates a flash image at address 0 with a vector table and the code of the reset
+ * handler.
+ * @param sp the initial stack pointer
+ * @param reset_adr address of the reset handler
+ * @param code the halfwords of the reset handler
+ * @param size size of the flash image
+ * @return the flash image
+ */
+inline std::vector<u8> MakeFlashImage(u32 sp, me_adr_t reset_adr, std::initializer_list<u16> code,
+                                      me_size_t size = 0x100U) {
+  std::vector<u8> flash(size);
+  WriteVectorTable(flash.data(), sp, reset_adr);
+  WriteCode(flash.data(), reset_adr, code);
+  return flash;
+}
+
+} // namespace libmicroemu::test
@@ -0,0 +1,279 @@
+// Runs the system tests in-process and compares their instruction traces with the reference
+// traces while they are generated.
+//
+// usage: system_test_runner <source_dir> <test_name>:<memory_config> [...]
+//
+// The ELF file of a test is <source_dir>/<test_name>/prebuilt/bin/<test_name>.elf and its
+// reference trace <source_dir>/<test_name>/<test_name>.trace. The trace is the same as printed by
+// "microemu -e -t --trace-changed-regs". All tests run in parallel, each on its own machine. A
+// test stops at the first line which differs from the reference trace.
+
+#include "libmicroemu/machine.h"
+#include "microemu/memory_layout.h"
+#include "microemu/reg_printer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Compares the lines of a trace with a reference trace file line by line
+class TraceComparator {
+public:
+  using FDivergenceCallback = std::function<void()>;
+
+  bool Open(const std::string &trace_file) {
+    reference_.open(trace_file);
+    return reference_.is_open();
+  }
+
+  // Called once when the first differing line is found
+  void SetDivergenceCallback(FDivergenceCallback cb) { cb_divergence_ = std::move(cb); }
+
+  bool IsDiverged() const noexcept { return is_diverged_; }
+  size_t GetLineNo() const noexcept { return line_no_; }
+  const std::string &GetExpectedLine() const noexcept { return expected_line_; }
+  const std::string &GetActualLine() const noexcept { return actual_line_; }
+
+  // Appends text of the trace. Complete lines are compared immediately.
+  void Write(const char *buf, size_t len) {
+    if (is_diverged_) {
+      return;
+    }
+    for (size_t i = 0U; i < len; ++i) {
+      if (buf[i] == '\n') {
+        CompareLine();
+        if (is_diverged_) {
+          return;
+        }
+      } else {
+        actual_line_ += buf[i];
+      }
+    }
+  }
+
+  void Write(const std::string &str) { Write(str.data(), str.size()); }
+
+  // Compares the last unterminated line and checks that the reference trace has no more lines
+  void Finish() {
+    if (is_diverged_) {
+      return;
+    }
+    if (!actual_line_.empty()) {
+      CompareLine();
+      if (is_diverged_) {
+        return;
+      }
+    }
+    if (std::getline(reference_, expected_line_)) {
+      ++line_no_;
+      Diverge(TrimRight(expected_line_), "<end of trace>");
+    }
+  }
+
+private:
+  static std::string TrimRight(const std::string &str) {
+    const auto last = str.find_last_not_of(" \t\r\n");
+    return (last == std::string::npos) ? std::string() : str.substr(0U, last + 1U);
+  }
+
+  void CompareLine() {
+    ++line_no_;
+    const auto actual = TrimRight(actual_line_);
+    actual_line_.clear();
+    if (!std::getline(reference_, expected_line_)) {
+      Diverge("<end of trace>", actual);
+      return;
+    }
+    const auto expected = TrimRight(expected_line_);
+    if (expected != actual) {
+      Diverge(expected, actual);
+    }
+  }
+
+  void Diverge(const std::string &expected, const std::string &actual) {
+    is_diverged_ = true;
+    expected_line_ = expected;
+    actual_line_ = actual;
+    if (cb_divergence_) {
+      cb_divergence_();
+    }
+  }
+
+  std::ifstream reference_;
+  FDivergenceCallback cb_divergence_;
+  size_t line_no_{0U};
+  std::string expected_line_;
+  std::string actual_line_;
+  bool is_diverged_{false};
+};
+
+struct SystemTest {
+  std::string name;
+  std::string memory_config;
+};
+
+struct SystemTestResult {
+  bool is_passed{false};
+  std::string message;
+  uint64_t instructions{0U};
+  double seconds{0.0};
+};
+
+SystemTestResult RunSystemTest(const std::string &source_dir, const SystemTest &test) {
+  SystemTestResult result;
+  const auto test_dir = source_dir + "/" + test.name;
+  const auto elf_file = test_dir + "/prebuilt/bin/" + test.name + ".elf";
+  const auto trace_file = test_dir + "/" + test.name + ".trace";
+
+  MemoryLayout layout;
+  if (!GetMemoryLayout(test.memory_config, layout)) {
+    result.message = "Unknown memory configuration '" + test.memory_config + "'";
+    return result;
+  }
+  TraceComparator comparator;
+  if (!comparator.Open(trace_file)) {
+    result.message = "Failed to open reference trace '" + trace_file + "'";
+    return result;
+  }
+
+  std::vector<uint8_t> flash_seg(layout.flash_size);
+  std::vector<uint8_t> ram1_seg(layout.ram1_size);
+  std::vector<uint8_t> ram2_seg(layout.ram2_size);
+  libmicroemu::Machine machine;
+  machine.SetFlashSegment(flash_seg.data(), layout.flash_size, layout.flash_vadr);
+  machine.SetRam1Segment(ram1_seg.data(), layout.ram1_size, layout.ram1_vadr);
+  machine.SetRam2Segment(ram2_seg.data(), layout.ram2_size, layout.ram2_vadr);
+  machine.SetConsoleCallback(
+      [&comparator](const char *buf, libmicroemu::me_size_t len) { comparator.Write(buf, len); });
+  comparator.SetDivergenceCallback([&machine]() { machine.RequestStop(); });
+
+  const auto sc = machine.Load(elf_file.c_str(), true);
+  if (sc != libmicroemu::StatusCode::kSuccess) {
+    result.message = "Failed to load '" + elf_file +
+                     "': " + std::string(libmicroemu::StatusCodeToString(sc));
+    return result;
+  }
+
+  // Reused by all steps to avoid an allocation per line
+  std::string line;
+  SampledRegs regs_from_last_step{};
+  machine.EvaluateState([&](libmicroemu::IRegAccessor &reg_access,
+                            libmicroemu::ISpecialRegAccessor &spec_reg_access) {
+    regs_from_last_step = RegPrinter::SampleRegs(reg_access, spec_reg_access);
+    line = "Initial register states:\n";
+    RegPrinter::FormatRegs(regs_from_last_step, line);
+    comparator.Write(line);
+  });
+
+  const auto pre_exec = [&](libmicroemu::EmuContext &ectx) {
+    if (comparator.IsDiverged()) {
+      return;
+    }
+    char buf[160];
+    const auto &raw_instr = ectx.GetOpCode();
+    const int len = raw_instr.is_32bit
+                        ? std::snprintf(buf, sizeof(buf), "%x: %04x %04x  ", ectx.GetPc(),
+                                        raw_instr.low, raw_instr.high)
+                        : std::snprintf(buf, sizeof(buf), "%x: %04x       ", ectx.GetPc(),
+                                        raw_instr.low);
+    ectx.BuildMnemonic(&buf[len], sizeof(buf) - static_cast<size_t>(len) - 1U);
+    line = buf;
+    line += '\n';
+    comparator.Write(line);
+  };
+  const auto post_exec = [&](libmicroemu::EmuContext &ectx) {
+    if (comparator.IsDiverged()) {
+      return;
+    }
+    const auto sampled_regs = RegPrinter::SampleRegs(ectx.GetRegisterAccessor(),
+                                                     ectx.GetSpecialRegisterAccessor());
+    line.clear();
+    RegPrinter::FormatRegDiffs(sampled_regs, regs_from_last_step, line);
+    regs_from_last_step = sampled_regs;
+    comparator.Write(line);
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto exec_result = machine.Exec(-1, pre_exec, post_exec);
+  const auto stop = std::chrono::steady_clock::now();
+  comparator.Finish();
+
+  result.instructions = exec_result.GetNoOfInstructions();
+  result.seconds = std::chrono::duration<double>(stop - start).count();
+  if (comparator.IsDiverged()) {
+    result.message = "Trace differs at line " + std::to_string(comparator.GetLineNo()) +
+                     "\n  expected: " + comparator.GetExpectedLine() +
+                     "\n  actual:   " + comparator.GetActualLine();
+  } else if (!exec_result.IsOk()) {
+    result.message = "Emulator returned error: " + std::string(exec_result.ToString());
+  } else if (exec_result.GetProgramExitCode() != EXIT_SUCCESS) {
+    result.message =
+        "Program exited with code " + std::to_string(exec_result.GetProgramExitCode());
+  } else {
+    result.is_passed = true;
+  }
+  return result;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: system_test_runner <source_dir> <test_name>:<memory_config> "
+                         "[<test_name>:<memory_config> ...]\n");
+    return EXIT_FAILURE;
+  }
+
+  const std::string source_dir = argv[1];
+  std::vector<SystemTest> tests;
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto sep = arg.find(':');
+    if ((sep == std::string::npos) || (sep == 0U)) {
+      std::fprintf(stderr, "Invalid test '%s'. Expected <test_name>:<memory_config>\n",
+                   arg.c_str());
+      return EXIT_FAILURE;
+    }
+    tests.push_back(SystemTest{arg.substr(0U, sep), arg.substr(sep + 1U)});
+  }
+
+  std::vector<SystemTestResult> results(tests.size());
+  std::atomic<size_t> next_test{0U};
+  auto work = [&]() {
+    for (size_t i = next_test++; i < tests.size(); i = next_test++) {
+      results[i] = RunSystemTest(source_dir, tests[i]);
+    }
+  };
+
+  const auto no_of_threads = std::min(static_cast<size_t>(std::thread::hardware_concurrency()),
+                                      tests.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1U; i < no_of_threads; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bool is_all_passed{true};
+  for (size_t i = 0U; i < tests.size(); ++i) {
+    const auto &result = results[i];
+    if (result.is_passed) {
+      std::printf("[  OK  ] %s (%llu instructions, %.3f s)\n", tests[i].name.c_str(),
+                  static_cast<unsigned long long>(result.instructions), result.seconds);
+    } else {
+      std::printf("[ FAIL ] %s: %s\n", tests[i].name.c_str(), result.message.c_str());
+      is_all_passed = false;
+    }
+  }
+  return is_all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}